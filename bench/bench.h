@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef JSON
+#define JSON
+#include "../src/json.h"
+#endif
+
+/*
+ * What the benchmarks share: the growable string they generate their input into, the clock, and the loop
+ * that measures the best throughput of a run over the input.
+ */
+
+/*
+ * A growable string used to generate the input documents.
+ */
+typedef struct Output Output;
+
+struct Output {
+    char * data;
+    size_t length;
+    size_t size;
+};
+
+/*
+ * The options a run is measured with, which each benchmark that measures runs defines.
+ */
+typedef struct BenchOptions BenchOptions;
+
+/*
+ * A run over the whole input, returning what it counted so that the benchmark can compare runs.
+ */
+typedef long (*BenchRun)(Output * input, const BenchOptions * options);
+
+static inline void output_append(Output * output, const char * text) {
+    size_t length = strlen(text);
+
+    while(output->length + length + 1 > output->size) {
+        output->size = (output->size == 0 ? 4096 : output->size * 2);
+        output->data = realloc(output->data, output->size);
+
+        if(output->data == NULL) {
+            fprintf(stderr, "Unable to allocate the input document\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    memcpy(&output->data[output->length], text, length + 1);
+    output->length += length;
+}
+
+/*
+ * Starts a new line indented for the depth, if indent is not 0.
+ */
+static inline void output_newLine(Output * output, int indent, int depth) {
+    if(indent == 0)
+        return;
+
+    output_append(output, "\n");
+
+    for(int i = 0; i < indent * depth; i++) {
+        output_append(output, " ");
+    }
+}
+
+static inline double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/*
+ * Exits when the setup of a benchmark fails.
+ */
+static inline void check(JsonError error) {
+    if(error != JSON_SUCCESS) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * Returns the best throughput in bytes per second over the repetitions of the run, after a first run that
+ * warms up the caches and branch predictors.
+ */
+static inline double bench_measure(BenchRun run, Output * input, const BenchOptions * options, int repetitions) {
+    double best = 0;
+
+    run(input, options);
+
+    for(int repetition = 0; repetition < repetitions; repetition++) {
+        double start = now();
+        run(input, options);
+        double elapsed = now() - start;
+
+        if(elapsed > 0 && input->length / elapsed > best) {
+            best = input->length / elapsed;
+        }
+    }
+
+    return best;
+}
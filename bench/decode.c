@@ -0,0 +1,291 @@
+#include "bench.h"
+#include "../src/decode.h"
+
+/*
+ * Compares filling structs from an array of orders by parsing the orders into a document and looking the
+ * fields of each up, against decoding them with a decoder defined by json_decode_define, which writes the fields
+ * straight into the struct. Reading every token without converting anything is timed too, as the floor.
+ */
+
+#define ORDERS 100000
+#define RUNS 5
+#define HISTORY 10
+
+typedef struct Customer Customer;
+typedef struct Item Item;
+typedef struct Order Order;
+
+struct Customer {
+    long int id;
+    char name[32];
+    int tier;
+};
+
+struct Item {
+    char sku[16];
+    int quantity;
+    double price;
+};
+
+struct Order {
+    long int id;
+    char status[16];
+    Customer customer;
+    Item items[8];
+    int itemCount;
+    double total;
+    bool paid;
+};
+
+#define CUSTOMER_FIELDS(FIELD) \
+    FIELD(LONG, id) \
+    FIELD(STRING, name) \
+    FIELD(INT, tier)
+
+#define ITEM_FIELDS(FIELD) \
+    FIELD(STRING, sku) \
+    FIELD(INT, quantity) \
+    FIELD(DOUBLE, price)
+
+#define ORDER_FIELDS(FIELD) \
+    FIELD(LONG, id) \
+    FIELD(STRING, status) \
+    FIELD(OBJECT, customer, json_decodeCustomer) \
+    FIELD(ARRAY, items, itemCount, json_decodeItem) \
+    FIELD(DOUBLE, total) \
+    FIELD(BOOL, paid)
+
+static json_decode_define(json_decodeCustomer, Customer, CUSTOMER_FIELDS)
+
+static json_decode_define(json_decodeItem, Item, ITEM_FIELDS)
+
+static json_decode_define(json_decodeOrder, Order, ORDER_FIELDS)
+
+/*
+ * Builds an array of orders, each with a couple of members that the structs do not have.
+ */
+static char * build_orders(size_t * size) {
+    size_t capacity = (size_t) ORDERS * 512;
+    char * orders = malloc(capacity);
+    size_t length = 0;
+
+    if(orders == NULL) {
+        fprintf(stderr, "Unable to allocate the orders\n");
+        exit(EXIT_FAILURE);
+    }
+
+    orders[length++] = '[';
+
+    for(int order = 0; order < ORDERS; order++) {
+        length += sprintf(orders + length, "%s{\"id\":%d,\"status\":\"%s\",\"customer\":{\"id\":%d,\"name\":\"Customer %d\",\"tier\":%d},"
+                                           "\"tags\":[\"web\",\"priority\"],\"items\":[",
+                          (order > 0 ? "," : ""), order, (order % 3 ? "shipped" : "pending"), order % 977, order % 977, order % 4);
+
+        for(int item = 0; item < 1 + order % 4; item++) {
+            length += sprintf(orders + length, "%s{\"sku\":\"SKU-%05d\",\"quantity\":%d,\"price\":%d.25}",
+                              (item > 0 ? "," : ""), order + item, 1 + item, 10 + item);
+        }
+
+        length += sprintf(orders + length, "],\"note\":\"leave at the door\",\"total\":%d.5,\"paid\":%s}",
+                          order % 500, (order % 2 ? "true" : "false"));
+    }
+
+    orders[length++] = ']';
+    orders[length] = '\0';
+
+    *size = length;
+
+    return orders;
+}
+
+/*
+ * Adds up the fields of an order, so that both ways of filling it can be checked against each other.
+ */
+static double order_sum(const Order * order) {
+    double sum = order->id + order->customer.id + order->customer.tier + order->total + order->paid +
+                 strlen(order->status) + strlen(order->customer.name);
+
+    for(int item = 0; item < order->itemCount; item++) {
+        sum += order->items[item].quantity * order->items[item].price + strlen(order->items[item].sku);
+    }
+
+    return sum;
+}
+
+/*
+ * Copies a string value into a char array of the struct.
+ */
+static void copy_string(JsonValue * value, char * target, size_t size) {
+    if(value != NULL) {
+        snprintf(target, size, "%s", json_value_getString(value));
+    }
+}
+
+/*
+ * Fills an order from a document, looking each field up by its key.
+ */
+static void fill_order(JsonValue * object, Order * order) {
+    JsonValue * value;
+
+    if((value = json_value_find(object, "id")) != NULL)
+        order->id = json_value_getInteger(value);
+
+    copy_string(json_value_find(object, "status"), order->status, sizeof(order->status));
+
+    JsonValue * customer = json_value_find(object, "customer");
+
+    if(customer != NULL) {
+        if((value = json_value_find(customer, "id")) != NULL)
+            order->customer.id = json_value_getInteger(value);
+
+        copy_string(json_value_find(customer, "name"), order->customer.name, sizeof(order->customer.name));
+
+        if((value = json_value_find(customer, "tier")) != NULL)
+            order->customer.tier = (int) json_value_getInteger(value);
+    }
+
+    JsonValue * items = json_value_find(object, "items");
+    order->itemCount = 0;
+
+    for(size_t index = 0; items != NULL && index < json_value_getLength(items) && index < 8; index++) {
+        JsonValue * element = json_value_getElement(items, index);
+        Item * item = &order->items[order->itemCount++];
+
+        copy_string(json_value_find(element, "sku"), item->sku, sizeof(item->sku));
+
+        if((value = json_value_find(element, "quantity")) != NULL)
+            item->quantity = (int) json_value_getInteger(value);
+
+        if((value = json_value_find(element, "price")) != NULL)
+            item->price = json_value_getDecimal(value);
+    }
+
+    if((value = json_value_find(object, "total")) != NULL)
+        order->total = json_value_getDecimal(value);
+
+    if((value = json_value_find(object, "paid")) != NULL)
+        order->paid = json_value_getBoolean(value);
+}
+
+/*
+ * Reads every token of the orders without converting any of them.
+ */
+static double read_tokens(TokenizerHandle * tokenizer) {
+    double count = 0;
+    TokenType token;
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF) {
+        if(token == JSON_TOKEN_ERROR) {
+            check(json_tokenizer_getError(tokenizer));
+        }
+
+        count++;
+    }
+
+    return count;
+}
+
+/*
+ * Parses the orders into a document and fills a struct from each of them.
+ */
+static double read_documents(TokenizerHandle * tokenizer, JsonArena * arena) {
+    double sum = 0;
+    JsonError error;
+
+    json_arena_reset(arena);
+
+    JsonDocument * document = json_document_parse(tokenizer, arena, &error);
+    check(error);
+
+    JsonValue * root = json_document_getRoot(document);
+
+    for(size_t index = 0; index < json_value_getLength(root); index++) {
+        Order order;
+        memset(&order, 0, sizeof(Order));
+
+        fill_order(json_value_getElement(root, index), &order);
+        sum += order_sum(&order);
+    }
+
+    return sum;
+}
+
+/*
+ * Decodes each order straight into the struct.
+ */
+static double read_decoded(TokenizerHandle * tokenizer) {
+    double sum = 0;
+    TokenType token;
+
+    for(size_t element = 0; ; element++) {
+        check(json_decode_nextElement(tokenizer, element, &token));
+
+        if(token == JSON_TOKEN_ARRAY_END)
+            break;
+
+        Order order;
+        memset(&order, 0, sizeof(Order));
+
+        check(json_decodeOrder(tokenizer, token, &order));
+        sum += order_sum(&order);
+    }
+
+    return sum;
+}
+
+int main(int argc, char *argv[]) {
+    size_t size;
+    char * orders = build_orders(&size);
+
+    JsonError error;
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(orders, size, HISTORY, &error), &error);
+    check(error);
+
+    JsonArena * arena = json_arena_create(0, &error);
+    check(error);
+
+    double tokens = 0;
+    double documents = 0;
+    double decoded = 0;
+
+    for(int run = 0; run < RUNS; run++) {
+        json_bufferFixed_reset(json_tokenizer_getBuffer(tokenizer), orders, size);
+        check(json_tokenizer_reset(tokenizer, NULL));
+
+        double start = now();
+        read_tokens(tokenizer);
+        tokens += now() - start;
+
+        json_bufferFixed_reset(json_tokenizer_getBuffer(tokenizer), orders, size);
+        check(json_tokenizer_reset(tokenizer, NULL));
+
+        start = now();
+        double expected = read_documents(tokenizer, arena);
+        documents += now() - start;
+
+        json_bufferFixed_reset(json_tokenizer_getBuffer(tokenizer), orders, size);
+        check(json_tokenizer_reset(tokenizer, NULL));
+
+        start = now();
+        double sum = read_decoded(tokenizer);
+        decoded += now() - start;
+
+        if(sum != expected) {
+            fprintf(stderr, "The decoder filled the orders differently\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%d orders, %.1f MB, averaged over %d runs\n", ORDERS, size / 1e6, RUNS);
+    printf("%-12s %12s %9s\n", "path", "ms", "MB/s");
+    printf("%-12s %12.2f %9.0f\n", "tokens only", tokens / RUNS * 1e3, size / 1e6 / (tokens / RUNS));
+    printf("%-12s %12.2f %9.0f\n", "document", documents / RUNS * 1e3, size / 1e6 / (documents / RUNS));
+    printf("%-12s %12.2f %9.0f %7.2fx\n", "decoder", decoded / RUNS * 1e3, size / 1e6 / (decoded / RUNS),
+           (decoded > 0 ? documents / decoded : 0));
+
+    json_arena_destroy(arena);
+    json_tokenizer_destroy(tokenizer);
+    free(orders);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+#include <unistd.h>
+
+#include "bench.h"
+
+/*
+ * Compares reading random records of a large newline delimited file by skipping every record before them from
+ * the start of the file, as without an index, against seeking straight to them with a sidecar index, along
+ * with how long building the index and opening it again take.
+ */
+
+#define RECORDS 200000
+#define LOOKUPS 200
+#define BUFFER_SIZE (64 * 1024)
+#define HISTORY 10
+
+/*
+ * Writes the records to a temporary file, returning its size.
+ */
+static long write_records(const char * path) {
+    FILE * file = fopen(path, "wb");
+
+    if(file == NULL) {
+        fprintf(stderr, "Unable to write %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    for(int record = 0; record < RECORDS; record++) {
+        fprintf(file, "{\"id\":%d,\"user\":{\"name\":\"user %d\",\"tags\":[\"a\",\"b\",\"c\"]},\"score\":%d.25,"
+                      "\"items\":[{\"sku\":\"SKU-%05d\",\"quantity\":%d},{\"sku\":\"SKU-%05d\",\"quantity\":%d}],"
+                      "\"note\":\"nothing to see in record %d\"}\n",
+                record, record % 977, record % 100, record, record % 7, record + 1, record % 5, record);
+    }
+
+    long size = ftell(file);
+    fclose(file);
+
+    return size;
+}
+
+/*
+ * Reads the id of the record that the tokenizer is at the start of.
+ */
+static long read_id(TokenizerHandle * tokenizer) {
+    TokenType token = json_tokenizer_readNextToken(tokenizer);
+    token = json_tokenizer_readNextToken(tokenizer);
+    token = json_tokenizer_readNextToken(tokenizer);
+    token = json_tokenizer_readNextToken(tokenizer);
+
+    if(token != JSON_TOKEN_NUMBER_INTEGER) {
+        fprintf(stderr, "Expected the id of a record\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return json_tokenizer_getIntegerValue(tokenizer);
+}
+
+int main(int argc, char *argv[]) {
+    char path[64];
+    char sidecar[80];
+
+    snprintf(path, sizeof(path), "/tmp/json_bench_index_%d.json", (int) getpid());
+    snprintf(sidecar, sizeof(sidecar), "%s.index", path);
+
+    long size = write_records(path);
+
+    int lookups[LOOKUPS];
+    srand(7);
+
+    for(int lookup = 0; lookup < LOOKUPS; lookup++) {
+        lookups[lookup] = rand() % RECORDS;
+    }
+
+    JsonError error;
+
+    double start = now();
+    JsonIndex * index = json_index_open(path, &error);
+    double built = now() - start;
+
+    check(error);
+    json_index_destroy(index);
+
+    start = now();
+    index = json_index_open(path, &error);
+    double opened = now() - start;
+
+    check(error);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferedFile_open(path, BUFFER_SIZE, HISTORY, &error), &error);
+    check(error);
+
+    // Without an index, every record before the one wanted has to be skipped.
+    start = now();
+
+    for(int lookup = 0; lookup < LOOKUPS; lookup++) {
+        check(json_buffer_seek(json_tokenizer_getBuffer(tokenizer), 0));
+        check(json_tokenizer_reset(tokenizer, NULL));
+
+        for(int record = 0; record < lookups[lookup]; record++) {
+            check(json_tokenizer_skipValue(tokenizer));
+        }
+
+        if(read_id(tokenizer) != lookups[lookup]) {
+            fprintf(stderr, "Skipped to the wrong record\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    double skipped = now() - start;
+
+    start = now();
+
+    for(int lookup = 0; lookup < LOOKUPS; lookup++) {
+        check(json_index_seekRecord(index, tokenizer, (size_t) lookups[lookup]));
+
+        if(read_id(tokenizer) != lookups[lookup]) {
+            fprintf(stderr, "Seeked to the wrong record\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    double seeked = now() - start;
+
+    printf("%d records, %.1f MB, %d random lookups\n", RECORDS, size / 1e6, LOOKUPS);
+    printf("%-12s %12s\n", "step", "ms");
+    printf("%-12s %12.2f\n", "build index", built * 1e3);
+    printf("%-12s %12.2f\n", "open index", opened * 1e3);
+    printf("%-12s %12.2f\n", "skip", skipped * 1e3);
+    printf("%-12s %12.2f %7.0fx\n", "seek", seeked * 1e3, (seeked > 0 ? skipped / seeked : 0));
+
+    json_tokenizer_destroy(tokenizer);
+    json_index_destroy(index);
+
+    unlink(sidecar);
+    unlink(path);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+#include "bench.h"
+
+/*
+ * Compares tokenizing throughput of the streaming and indexed engines on indented and minified input.
+ */
+
+#define RECORDS 100000
+#define REPETITIONS 7
+
+/*
+ * Generates an array of records, indenting each level by indent spaces if indent is not 0.
+ */
+static Output generate(int indent) {
+    Output output = {NULL, 0, 0};
+    char text[128];
+
+    const char * colon = (indent == 0 ? ":" : ": ");
+
+    output_append(&output, "[");
+
+    for(int record = 0; record < RECORDS; record++) {
+        if(record > 0)
+            output_append(&output, ",");
+
+        output_newLine(&output, indent, 1);
+        output_append(&output, "{");
+
+        output_newLine(&output, indent, 2);
+        snprintf(text, sizeof(text), "\"id\"%s%d,", colon, record);
+        output_append(&output, text);
+
+        output_newLine(&output, indent, 2);
+        snprintf(text, sizeof(text), "\"name\"%s\"item%d\",", colon, record);
+        output_append(&output, text);
+
+        output_newLine(&output, indent, 2);
+        snprintf(text, sizeof(text), "\"active\"%s%s,", colon, (record % 2 == 0 ? "true" : "false"));
+        output_append(&output, text);
+
+        output_newLine(&output, indent, 2);
+        snprintf(text, sizeof(text), "\"tags\"%s[", colon);
+        output_append(&output, text);
+
+        for(int tag = 0; tag < 3; tag++) {
+            output_newLine(&output, indent, 3);
+            snprintf(text, sizeof(text), "\"tag%d\"%s", tag, (tag < 2 ? "," : ""));
+            output_append(&output, text);
+        }
+
+        output_newLine(&output, indent, 2);
+        output_append(&output, "]");
+
+        output_newLine(&output, indent, 1);
+        output_append(&output, "}");
+    }
+
+    output_newLine(&output, indent, 0);
+    output_append(&output, "]");
+
+    return output;
+}
+
+/*
+ * The engine to tokenize with.
+ */
+struct BenchOptions {
+    TokenizerEngine engine;
+};
+
+/*
+ * Tokenizes the whole input with the engine, returning the number of tokens read.
+ */
+static long tokenize(Output * input, const BenchOptions * options) {
+    JsonError error;
+
+    JsonBuffer * buffer = json_bufferFixed_create(input->data, (int) input->length, 10, &error);
+    TokenizerHandle * tokenizer = (buffer == NULL ? NULL : json_tokenizer_create(buffer, &error));
+
+    if(tokenizer != NULL) {
+        // Building the index is part of the cost of the indexed engine.
+        error = json_tokenizer_setEngine(tokenizer, options->engine);
+    }
+
+    if(tokenizer == NULL || error != JSON_SUCCESS) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    long tokens = 0;
+
+    while(true) {
+        TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+        if(token == JSON_TOKEN_EOF)
+            break;
+
+        if(token == JSON_TOKEN_ERROR) {
+            json_tokenizer_logError(tokenizer);
+            exit(EXIT_FAILURE);
+        }
+
+        tokens++;
+    }
+
+    json_tokenizer_destroy(tokenizer);
+
+    return tokens;
+}
+
+int main(int argc, char *argv[]) {
+    Output inputs[2] = {generate(4), generate(0)};
+    const char * names[2] = {"indented", "minified"};
+
+    BenchOptions engines[2] = {{JSON_ENGINE_STREAMING}, {JSON_ENGINE_INDEXED}};
+
+    printf("%-10s %-10s %12s %10s %12s %8s\n", "input", "engine", "bytes", "tokens", "MB/s", "gain");
+
+    for(int input = 0; input < 2; input++) {
+        long tokens = tokenize(&inputs[input], &engines[0]);
+
+        // Both engines must read the same tokens for the comparison to mean anything.
+        if(tokenize(&inputs[input], &engines[1]) != tokens) {
+            fprintf(stderr, "The engines read a different number of tokens\n");
+            return EXIT_FAILURE;
+        }
+
+        double streaming = 0;
+
+        for(int engine = 0; engine < 2; engine++) {
+            double bytesPerSecond = bench_measure(tokenize, &inputs[input], &engines[engine], REPETITIONS);
+
+            if(engines[engine].engine == JSON_ENGINE_STREAMING) {
+                streaming = bytesPerSecond;
+            }
+
+            printf("%-10s %-10s %12zu %10ld %12.1f %7.2fx\n",
+                   names[input], json_engine_name(engines[engine].engine), inputs[input].length, tokens,
+                   bytesPerSecond / 1e6, bytesPerSecond / streaming);
+        }
+    }
+
+    free(inputs[0].data);
+    free(inputs[1].data);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+#include "bench.h"
+
+/*
+ * Compares dispatching on the keys of wide objects by copying each key and comparing it against every field
+ * the reader knows about, against looking the key up in a symbol table registered with the tokenizer.
+ */
+
+#define RECORDS 20000
+#define FIELDS 48
+#define RUNS 5
+#define HISTORY 10
+
+/*
+ * Builds records that each have every field, plus one the reader does not know about.
+ */
+static char * build_records(char ** fields, size_t * size) {
+    size_t capacity = (size_t) RECORDS * FIELDS * 48 + 1;
+    char * records = malloc(capacity);
+    size_t length = 0;
+
+    if(records == NULL) {
+        fprintf(stderr, "Unable to allocate the records\n");
+        exit(EXIT_FAILURE);
+    }
+
+    records[length++] = '[';
+
+    for(int record = 0; record < RECORDS; record++) {
+        length += sprintf(records + length, "%s{\"unknown_field\":true", record > 0 ? "," : "");
+
+        for(int field = 0; field < FIELDS; field++) {
+            length += sprintf(records + length, ",\"%s\":%d", fields[field], record + field);
+        }
+
+        records[length++] = '}';
+    }
+
+    records[length++] = ']';
+    records[length] = '\0';
+
+    *size = length;
+
+    return records;
+}
+
+/*
+ * Sums the values of the fields, finding each field by comparing the key against every known field in turn.
+ */
+static long sum_compared(TokenizerHandle * tokenizer, char ** fields) {
+    long sum = 0;
+    TokenType token;
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR) {
+        if(token != JSON_TOKEN_TEXT)
+            continue;
+
+        char * key = json_tokenizer_getStringValue(tokenizer);
+        int id = -1;
+
+        for(int field = 0; field < FIELDS; field++) {
+            if(strcmp(key, fields[field]) == 0) {
+                id = field;
+                break;
+            }
+        }
+
+        // The colon after the key, then its value.
+        json_tokenizer_readNextToken(tokenizer);
+        token = json_tokenizer_readNextToken(tokenizer);
+
+        if(id >= 0 && token == JSON_TOKEN_NUMBER_INTEGER)
+            sum += json_tokenizer_getIntegerValue(tokenizer) * (id + 1);
+    }
+
+    return sum;
+}
+
+/*
+ * Sums the values of the fields, finding each field by its id in the keys set on the tokenizer.
+ */
+static long sum_interned(TokenizerHandle * tokenizer) {
+    long sum = 0;
+    TokenType token;
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR) {
+        if(token != JSON_TOKEN_TEXT)
+            continue;
+
+        int id = json_tokenizer_getKeyId(tokenizer);
+
+        // The colon after the key, then its value.
+        json_tokenizer_readNextToken(tokenizer);
+        token = json_tokenizer_readNextToken(tokenizer);
+
+        if(id >= 0 && token == JSON_TOKEN_NUMBER_INTEGER)
+            sum += json_tokenizer_getIntegerValue(tokenizer) * (id + 1);
+    }
+
+    return sum;
+}
+
+int main(int argc, char *argv[]) {
+    char * fields[FIELDS];
+    char names[FIELDS][32];
+
+    // Real schemas often share long prefixes, which is where comparing each key costs the most.
+    for(int field = 0; field < FIELDS; field++) {
+        snprintf(names[field], sizeof(names[field]), "customer_attribute_%02d", field);
+        fields[field] = names[field];
+    }
+
+    size_t size;
+    char * records = build_records(fields, &size);
+
+    JsonError error;
+    JsonKeys * keys = json_keys_create((const char * const *) fields, FIELDS, &error);
+    check(error);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(records, size, HISTORY, &error), &error);
+    check(error);
+
+    double compared = 0;
+    double interned = 0;
+    long expected = 0;
+
+    for(int run = 0; run < RUNS; run++) {
+        json_bufferFixed_reset(json_tokenizer_getBuffer(tokenizer), records, size);
+        check(json_tokenizer_reset(tokenizer, NULL));
+
+        double start = now();
+        long sum = sum_compared(tokenizer, fields);
+        compared += now() - start;
+
+        check(json_tokenizer_getError(tokenizer));
+        expected = sum;
+
+        json_bufferFixed_reset(json_tokenizer_getBuffer(tokenizer), records, size);
+        check(json_tokenizer_reset(tokenizer, NULL));
+        json_tokenizer_setKeys(tokenizer, keys);
+
+        start = now();
+        sum = sum_interned(tokenizer);
+        interned += now() - start;
+
+        check(json_tokenizer_getError(tokenizer));
+        json_tokenizer_setKeys(tokenizer, NULL);
+
+        if(sum != expected) {
+            fprintf(stderr, "The key ids found different fields\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%d records of %d fields, %.1f MB, averaged over %d runs\n", RECORDS, FIELDS, size / 1e6, RUNS);
+    printf("%-12s %12s\n", "dispatch", "ms");
+    printf("%-12s %12.2f\n", "strcmp", compared / RUNS * 1e3);
+    printf("%-12s %12.2f %7.2fx\n", "key id", interned / RUNS * 1e3, (interned > 0 ? compared / interned : 0));
+
+    json_tokenizer_destroy(tokenizer);
+    json_keys_destroy(keys);
+    free(records);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+#include <unistd.h>
+
+#include "bench.h"
+
+/*
+ * Measures how NDJSON throughput scales with the number of worker threads, in ordered and unordered mode.
+ */
+
+#define RECORDS 500000
+#define REPETITIONS 5
+
+/*
+ * Generates one record on each line.
+ */
+static Output generate() {
+    Output output = {NULL, 0, 0};
+    char text[256];
+
+    for(int record = 0; record < RECORDS; record++) {
+        snprintf(text, sizeof(text),
+                 "{\"id\":%d,\"name\":\"item%d\",\"price\":%d.%02d,\"active\":%s,\"tags\":[\"tag0\",\"tag1\",\"tag2\"]}\n",
+                 record, record, record % 1000, record % 100, (record % 2 == 0 ? "true" : "false"));
+        output_append(&output, text);
+    }
+
+    return output;
+}
+
+/*
+ * Sums the ids of the records, so that every record is checked to have been seen.
+ */
+static JsonError sumIds(JsonValue * record, size_t offset, void * context) {
+    __atomic_fetch_add((long *) context, json_value_getInteger(json_value_find(record, "id")), __ATOMIC_RELAXED);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * The number of threads to process with, and whether the records are delivered in order.
+ */
+struct BenchOptions {
+    int threads;
+    bool ordered;
+};
+
+/*
+ * Processes the whole input, exiting if the records do not add up.
+ *
+ * Returns the sum of the ids.
+ */
+static long process(Output * input, const BenchOptions * options) {
+    JsonError error;
+
+    JsonBuffer * buffer = json_bufferFixed_create(input->data, (int) input->length, 10, &error);
+
+    if(buffer == NULL) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    long sum = 0;
+    size_t errorOffset;
+
+    error = json_ndjson_process(buffer, options->threads, options->ordered, sumIds, &sum, &errorOffset);
+
+    if(error != JSON_SUCCESS) {
+        fprintf(stderr, "Failed at offset %zu\n", errorOffset);
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    if(sum != (long) RECORDS * (RECORDS - 1) / 2) {
+        fprintf(stderr, "Not every record was processed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    json_buffer_destroy(buffer);
+
+    return sum;
+}
+
+int main(int argc, char *argv[]) {
+    Output input = generate();
+
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+    printf("%-10s %8s %12s %12s %8s\n", "mode", "threads", "bytes", "MB/s", "scaling");
+
+    for(int ordered = 0; ordered < 2; ordered++) {
+        double single = 0;
+
+        for(int threads = 1; threads <= (processors > 1 ? processors : 1); threads *= 2) {
+            BenchOptions options = {threads, ordered};
+
+            double bytesPerSecond = bench_measure(process, &input, &options, REPETITIONS);
+
+            if(threads == 1) {
+                single = bytesPerSecond;
+            }
+
+            printf("%-10s %8d %12zu %12.1f %7.2fx\n",
+                   (ordered ? "ordered" : "unordered"), threads, input.length,
+                   bytesPerSecond / 1e6, bytesPerSecond / single);
+        }
+    }
+
+    free(input.data);
+
+    return EXIT_SUCCESS;
+}
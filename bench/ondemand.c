@@ -0,0 +1,302 @@
+#include "bench.h"
+
+/*
+ * Compares pulling five fields out of a 20KB event by walking every token, by parsing it into a document,
+ * and by reading it on demand, which skips the large payload between the fields without tokenizing it.
+ */
+
+#define EVENTS 20000
+#define REPETITIONS 5
+#define COMMITS 88
+
+/*
+ * The fields pulled out of each event, checked against the values the event was built with.
+ */
+typedef struct Fields Fields;
+
+struct Fields {
+    long int id;
+    char type[32];
+    char login[32];
+    char repository[64];
+    char created[32];
+};
+
+/*
+ * Builds an event with the fields spread around a large payload of commits.
+ */
+static char * build(int * length) {
+    size_t size = 64 * 1024;
+    char * data = (char *) malloc(size);
+    int used = 0;
+
+    used += snprintf(data + used, size - used, "{\"id\":26170000123,\"type\":\"PushEvent\","
+                                               "\"actor\":{\"id\":583231,\"login\":\"octocat\",\"avatar\":\"https://avatars.example.com/u/583231\"},"
+                                               "\"payload\":{\"size\":%d,\"commits\":[", COMMITS);
+
+    for(int commit = 0; commit < COMMITS; commit++) {
+        used += snprintf(data + used, size - used, "%s{\"sha\":\"%040x\",\"author\":{\"name\":\"The Octocat\",\"email\":\"octocat@example.com\"},"
+                                                   "\"message\":\"Fix the \\\"%d\\\" case\\nwith a longer description of the change\","
+                                                   "\"distinct\":%s,\"stats\":[%d,%d,%.2f]}",
+                         (commit == 0 ? "" : ","), commit * 2654435761u, commit, (commit % 2 ? "true" : "false"),
+                         commit * 3, commit * 7, commit / 3.0);
+    }
+
+    used += snprintf(data + used, size - used, "]},\"repo\":{\"id\":1296269,\"name\":\"octocat/hello-world\"},"
+                                               "\"public\":true,\"created_at\":\"2024-01-15T10:21:34Z\"}");
+
+    *length = used;
+
+    return data;
+}
+
+/*
+ * Copies a string value into a field.
+ */
+static void copy(char * field, size_t size, const char * value, size_t length) {
+    if(length >= size) {
+        length = size - 1;
+    }
+
+    memcpy(field, value, length);
+    field[length] = '\0';
+}
+
+/*
+ * Walks every token of the event, keeping the values of the keys wanted.
+ */
+static void pull_tokens(TokenizerHandle * tokenizer, Fields * fields) {
+    int depth = 0;
+    char key[32] = "";
+    char parent[32] = "";
+    TokenType token;
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF) {
+        const char * value;
+        size_t length;
+
+        switch(token) {
+            case JSON_TOKEN_ERROR:
+                check(json_tokenizer_getError(tokenizer));
+                break;
+            case JSON_TOKEN_OBJECT_START:
+            case JSON_TOKEN_ARRAY_START:
+                if(depth == 1) {
+                    strcpy(parent, key);
+                }
+
+                depth++;
+                key[0] = '\0';
+                break;
+            case JSON_TOKEN_OBJECT_END:
+            case JSON_TOKEN_ARRAY_END:
+                depth--;
+                key[0] = '\0';
+                break;
+            case JSON_TOKEN_TEXT:
+                json_tokenizer_getStringSlice(tokenizer, &value, &length);
+
+                if(key[0] == '\0') {
+                    copy(key, sizeof(key), value, length);
+                    break;
+                }
+
+                if(depth == 1 && strcmp(key, "type") == 0) {
+                    copy(fields->type, sizeof(fields->type), value, length);
+                } else if(depth == 1 && strcmp(key, "created_at") == 0) {
+                    copy(fields->created, sizeof(fields->created), value, length);
+                } else if(depth == 2 && strcmp(parent, "actor") == 0 && strcmp(key, "login") == 0) {
+                    copy(fields->login, sizeof(fields->login), value, length);
+                } else if(depth == 2 && strcmp(parent, "repo") == 0 && strcmp(key, "name") == 0) {
+                    copy(fields->repository, sizeof(fields->repository), value, length);
+                }
+
+                key[0] = '\0';
+                break;
+            case JSON_TOKEN_NUMBER_INTEGER:
+                if(depth == 1 && strcmp(key, "id") == 0) {
+                    fields->id = json_tokenizer_getIntegerValue(tokenizer);
+                }
+
+                key[0] = '\0';
+                break;
+            case JSON_TOKEN_COMMA:
+            case JSON_TOKEN_COLON:
+                break;
+            default:
+                key[0] = '\0';
+                break;
+        }
+    }
+}
+
+/*
+ * Parses the whole event into a document and looks the fields up in it.
+ */
+static void pull_document(TokenizerHandle * tokenizer, JsonArena * arena, Fields * fields) {
+    JsonError error;
+
+    json_arena_reset(arena);
+
+    JsonDocument * document = json_document_parse(tokenizer, arena, &error);
+    check(error);
+
+    JsonValue * root = json_document_getRoot(document);
+    char * value;
+
+    fields->id = json_value_getInteger(json_value_find(root, "id"));
+
+    value = json_value_getString(json_value_find(root, "type"));
+    copy(fields->type, sizeof(fields->type), value, strlen(value));
+
+    value = json_value_getString(json_value_find(json_value_find(root, "actor"), "login"));
+    copy(fields->login, sizeof(fields->login), value, strlen(value));
+
+    value = json_value_getString(json_value_find(json_value_find(root, "repo"), "name"));
+    copy(fields->repository, sizeof(fields->repository), value, strlen(value));
+
+    value = json_value_getString(json_value_find(root, "created_at"));
+    copy(fields->created, sizeof(fields->created), value, strlen(value));
+}
+
+/*
+ * Finds the fields in order, skipping everything between them.
+ */
+static void pull_ondemand(OndemandParser * parser, Fields * fields) {
+    OndemandValue root, value, nested;
+    const char * string;
+    size_t length;
+
+    check(json_ondemand_start(parser, &root));
+
+    check(json_ondemand_find(&root, "id", &value));
+    check(json_ondemand_getInteger(&value, &fields->id));
+
+    check(json_ondemand_find(&root, "type", &value));
+    check(json_ondemand_getString(&value, &string, &length));
+    copy(fields->type, sizeof(fields->type), string, length);
+
+    check(json_ondemand_find(&root, "actor", &value));
+    check(json_ondemand_find(&value, "login", &nested));
+    check(json_ondemand_getString(&nested, &string, &length));
+    copy(fields->login, sizeof(fields->login), string, length);
+
+    check(json_ondemand_find(&root, "repo", &value));
+    check(json_ondemand_find(&value, "name", &nested));
+    check(json_ondemand_getString(&nested, &string, &length));
+    copy(fields->repository, sizeof(fields->repository), string, length);
+
+    check(json_ondemand_find(&root, "created_at", &value));
+    check(json_ondemand_getString(&value, &string, &length));
+    copy(fields->created, sizeof(fields->created), string, length);
+}
+
+/*
+ * Exits unless the fields pulled out match the event.
+ */
+static void verify(Fields * fields, const char * name) {
+    if(fields->id != 26170000123L || strcmp(fields->type, "PushEvent") != 0 || strcmp(fields->login, "octocat") != 0 ||
+       strcmp(fields->repository, "octocat/hello-world") != 0 || strcmp(fields->created, "2024-01-15T10:21:34Z") != 0) {
+        fprintf(stderr, "%s pulled the wrong fields\n", name);
+        exit(EXIT_FAILURE);
+    }
+}
+
+typedef enum Method Method;
+
+enum Method {
+    METHOD_TOKENS,
+    METHOD_DOCUMENT,
+    METHOD_ONDEMAND
+};
+
+static const char * methodNames[] = {"tokens", "document", "ondemand"};
+
+/*
+ * Pulls the fields out of the event over and over with one method, reusing the tokenizer for each event.
+ */
+static void run(Method method, char * data, int length) {
+    JsonError error;
+
+    JsonBuffer * buffer = json_bufferFixed_create(data, length, 10, &error);
+    TokenizerHandle * tokenizer = json_tokenizer_create(buffer, &error);
+    check(error);
+
+    JsonArena * arena = json_arena_create(64 * 1024, &error);
+    check(error);
+
+    OndemandParser * parser = json_ondemand_create(tokenizer, 0, &error);
+    check(error);
+
+    Fields fields;
+
+    for(int index = 0; index < EVENTS; index++) {
+        check(json_bufferFixed_reset(buffer, data, length));
+        check(json_tokenizer_reset(tokenizer, NULL));
+
+        memset(&fields, 0, sizeof(fields));
+
+        switch(method) {
+            case METHOD_TOKENS:
+                pull_tokens(tokenizer, &fields);
+                break;
+            case METHOD_DOCUMENT:
+                pull_document(tokenizer, arena, &fields);
+                break;
+            case METHOD_ONDEMAND:
+                pull_ondemand(parser, &fields);
+                break;
+        }
+
+        verify(&fields, methodNames[method]);
+    }
+
+    json_ondemand_destroy(parser);
+    json_arena_destroy(arena);
+    json_tokenizer_destroy(tokenizer);
+}
+
+/*
+ * Returns the best number of events per second over the repetitions.
+ */
+static double measure(Method method, char * data, int length) {
+    double best = 0;
+
+    // Warm up the caches, branch predictors and the allocator.
+    run(method, data, length);
+
+    for(int repetition = 0; repetition < REPETITIONS; repetition++) {
+        double start = now();
+        run(method, data, length);
+        double elapsed = now() - start;
+
+        if(elapsed > 0 && EVENTS / elapsed > best) {
+            best = EVENTS / elapsed;
+        }
+    }
+
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    int length;
+    char * data = build(&length);
+
+    double rates[3];
+
+    for(int method = METHOD_TOKENS; method <= METHOD_ONDEMAND; method++) {
+        rates[method] = measure((Method) method, data, length);
+    }
+
+    printf("event of %d bytes, 5 fields\n", length);
+    printf("%-10s %14s %10s %8s\n", "method", "events/s", "MB/s", "gain");
+
+    for(int method = METHOD_TOKENS; method <= METHOD_ONDEMAND; method++) {
+        printf("%-10s %14.0f %10.1f %7.2fx\n", methodNames[method], rates[method], rates[method] * length / 1e6,
+               rates[method] / rates[METHOD_TOKENS]);
+    }
+
+    free(data);
+
+    return EXIT_SUCCESS;
+}
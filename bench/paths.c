@@ -0,0 +1,207 @@
+#include "bench.h"
+
+/*
+ * Compares running a set of JSON Pointer extractions over a stream of events against parsing every
+ * event with the SAX parser, which is the least work any extraction that reads the whole event could do.
+ */
+
+#define EVENTS 100000
+#define REPETITIONS 5
+#define FIELDS 40
+#define ITEMS 6
+#define HEADERS 12
+#define HISTORY 10
+
+/*
+ * Builds the events, one after another, each with many fields, a nested user, a request and history
+ * that nothing extracts, and an array of items.
+ */
+static char * build(int * length) {
+    const char * body = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore "
+                        "et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+                        "aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit in voluptate velit esse.";
+
+    size_t size = (size_t) EVENTS * 4096;
+    char * data = (char *) malloc(size);
+    size_t used = 0;
+
+    for(int event = 0; event < EVENTS; event++) {
+        used += snprintf(data + used, size - used, "{\"id\":%d,\"user\":{\"id\":%d,\"name\":\"user %d\",\"tags\":[\"a\",\"b\"]},",
+                         event, event % 977, event);
+
+        for(int field = 0; field < FIELDS; field++) {
+            if(field % 3 == 0) {
+                used += snprintf(data + used, size - used, "\"field%d\":\"value %d of event %d\",", field, field, event);
+            } else {
+                used += snprintf(data + used, size - used, "\"field%d\":%d.%d,", field, field * event, field);
+            }
+        }
+
+        // Most of an event is usually context that no extraction looks into.
+        used += snprintf(data + used, size - used, "\"request\":{\"headers\":{");
+
+        for(int header = 0; header < HEADERS; header++) {
+            used += snprintf(data + used, size - used, "%s\"X-Header-%d\":\"header value %d for event %d\"",
+                             (header == 0 ? "" : ","), header, header, event);
+        }
+
+        used += snprintf(data + used, size - used, "},\"body\":\"%s\"},\"history\":[", body);
+
+        for(int entry = 0; entry < HISTORY; entry++) {
+            used += snprintf(data + used, size - used, "%s{\"at\":%d,\"state\":\"state %d\",\"by\":[%d,%d]}",
+                             (entry == 0 ? "" : ","), event * 10 + entry, entry, entry, event);
+        }
+
+        used += snprintf(data + used, size - used, "],\"items\":[");
+
+        for(int item = 0; item < ITEMS; item++) {
+            used += snprintf(data + used, size - used, "%s{\"sku\":\"SKU-%05d\",\"price\":%d.99,\"quantity\":%d,\"notes\":\"nothing \\\"here\\\"\"}",
+                             (item == 0 ? "" : ","), event + item, item + 1, item);
+        }
+
+        used += snprintf(data + used, size - used, "],\"source\":{\"ip\":\"10.0.%d.%d\",\"agent\":\"bench/1.0\"}}\n",
+                         event / 256 % 256, event % 256);
+    }
+
+    *length = (int) used;
+
+    return data;
+}
+
+/*
+ * Counts the values extracted and sums the numbers among them, so that none of the work can be left out.
+ */
+typedef struct Totals Totals;
+
+struct Totals {
+    long int values;
+    double sum;
+};
+
+static JsonError extracted(int path, TokenType token, TokenizerHandle * tokenizer, void * context) {
+    Totals * totals = (Totals *) context;
+
+    totals->values++;
+
+    if(token == JSON_TOKEN_NUMBER_INTEGER) {
+        totals->sum += (double) json_tokenizer_getIntegerValue(tokenizer);
+    } else if(token == JSON_TOKEN_NUMBER_DECIMAL) {
+        totals->sum += json_tokenizer_getDecimalValue(tokenizer);
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * The 50 extractions, only some of which match anything, as in a real set of them.
+ */
+static const char * pointers[] = {
+    "/id", "/user/id", "/user/name", "/user/tags/0", "/items/*/price", "/items/*/sku", "/items/0/quantity",
+    "/source/ip", "/field0", "/field1", "/field2", "/field3", "/field5", "/field8", "/field13", "/field21",
+    "/field34", "/field39", "/missing", "/user/missing", "/items/*/missing", "/items/9/price", "/source/missing",
+    "/a", "/b", "/c", "/d", "/e", "/f", "/g", "/h", "/i", "/j", "/k", "/l", "/m", "/n", "/o", "/p", "/q", "/r",
+    "/s", "/t", "/u", "/v", "/w", "/x", "/y", "/z", "/user/tags/1"
+};
+
+/*
+ * Extracts the paths from every event.
+ */
+static void run_paths(char * data, int length, Totals * totals) {
+    JsonError error;
+
+    JsonPaths * paths = json_paths_compile(pointers, sizeof(pointers) / sizeof(pointers[0]), &error);
+    check(error);
+
+    PathExtractor * extractor = json_pathExtractor_create(paths, extracted, totals, &error);
+    check(error);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(data, length, 10, &error), &error);
+    check(error);
+
+    while((error = json_pathExtractor_extract(extractor, tokenizer)) == JSON_SUCCESS) {
+        json_pathExtractor_reset(extractor);
+    }
+
+    if(error != JSON_ERROR_EOF) {
+        check(error);
+    }
+
+    json_tokenizer_destroy(tokenizer);
+    json_pathExtractor_destroy(extractor);
+    json_paths_destroy(paths);
+}
+
+/*
+ * Parses every event with no handlers set.
+ */
+static void run_sax(char * data, int length, Totals * totals) {
+    JsonError error;
+    JsonHandlers handlers = {0};
+
+    SaxParser * parser = json_sax_create(&handlers, NULL, 0, &error);
+    check(error);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(data, length, 10, &error), &error);
+    check(error);
+
+    while((error = json_sax_parse(parser, tokenizer)) == JSON_SUCCESS) {
+        json_sax_reset(parser);
+        totals->values++;
+    }
+
+    if(error != JSON_ERROR_EOF) {
+        check(error);
+    }
+
+    json_tokenizer_destroy(tokenizer);
+    json_sax_destroy(parser);
+}
+
+/*
+ * Returns the best number of events per second over the repetitions.
+ */
+static double measure(void (*run)(char * data, int length, Totals * totals), char * data, int length, Totals * totals) {
+    double best = 0;
+
+    // Warm up the caches, branch predictors and the allocator.
+    run(data, length, totals);
+
+    for(int repetition = 0; repetition < REPETITIONS; repetition++) {
+        memset(totals, 0, sizeof(Totals));
+
+        double start = now();
+        run(data, length, totals);
+        double elapsed = now() - start;
+
+        if(elapsed > 0 && EVENTS / elapsed > best) {
+            best = EVENTS / elapsed;
+        }
+    }
+
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    int length;
+    char * data = build(&length);
+
+    Totals parsed, extractions;
+
+    double sax = measure(run_sax, data, length, &parsed);
+    double paths = measure(run_paths, data, length, &extractions);
+
+    if(parsed.values != EVENTS) {
+        fprintf(stderr, "parsed %ld events instead of %d\n", parsed.values, EVENTS);
+        return EXIT_FAILURE;
+    }
+
+    printf("%d events of %d bytes on average, %zu paths\n", EVENTS, length / EVENTS, sizeof(pointers) / sizeof(pointers[0]));
+    printf("%-10s %14s %10s %8s\n", "method", "events/s", "MB/s", "gain");
+    printf("%-10s %14.0f %10.1f %7.2fx\n", "sax", sax, sax * length / EVENTS / 1e6, 1.0);
+    printf("%-10s %14.0f %10.1f %7.2fx\n", "paths", paths, paths * length / EVENTS / 1e6, paths / sax);
+    printf("%ld values extracted, summing to %.2f\n", extractions.values, extractions.sum);
+
+    free(data);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+#include "bench.h"
+
+/*
+ * Compares tokenizing many small bodies with a new tokenizer for each against reusing tokenizers,
+ * either reset onto each body directly or taken from the thread's pool.
+ */
+
+#define BODIES 2000000
+#define REPETITIONS 5
+
+static const char * body = "{\"method\":\"user.get\",\"id\":12345,\"params\":{\"name\":\"a somewhat longer user name "
+                           "that does not fit in the initial value buffer\",\"fields\":[\"email\",\"created\"]}}";
+
+/*
+ * Reads every token of the body, exiting if it is not read successfully.
+ */
+static void tokenize(TokenizerHandle * tokenizer) {
+    TokenType token;
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR) {
+        if(token == JSON_TOKEN_TEXT) {
+            json_tokenizer_getStringValue(tokenizer);
+        }
+    }
+
+    if(token == JSON_TOKEN_ERROR) {
+        json_error_logReason(json_tokenizer_getError(tokenizer));
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * Creates and destroys a buffer and tokenizer for each body.
+ */
+static void run_create(char * data, int length) {
+    JsonError error;
+
+    for(int index = 0; index < BODIES; index++) {
+        TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(data, length, 10, &error), &error);
+        check(error);
+
+        tokenize(tokenizer);
+
+        json_tokenizer_destroy(tokenizer);
+    }
+}
+
+/*
+ * Keeps one tokenizer, resetting its buffer and the tokenizer for each body.
+ */
+static void run_reset(char * data, int length) {
+    JsonError error;
+
+    JsonBuffer * buffer = json_bufferFixed_create(data, length, 10, &error);
+    TokenizerHandle * tokenizer = json_tokenizer_create(buffer, &error);
+    check(error);
+
+    for(int index = 0; index < BODIES; index++) {
+        check(json_bufferFixed_reset(buffer, data, length));
+        check(json_tokenizer_reset(tokenizer, NULL));
+
+        tokenize(tokenizer);
+    }
+
+    json_tokenizer_destroy(tokenizer);
+}
+
+/*
+ * Acquires a tokenizer from the pool for each body and releases it afterwards.
+ */
+static void run_pool(char * data, int length) {
+    JsonError error;
+
+    for(int index = 0; index < BODIES; index++) {
+        TokenizerHandle * tokenizer = json_tokenizerPool_acquire(data, length, 10, &error);
+        check(error);
+
+        tokenize(tokenizer);
+
+        check(json_tokenizerPool_release(tokenizer));
+    }
+
+    json_tokenizerPool_clear();
+}
+
+/*
+ * Returns the best number of bodies per second over the repetitions.
+ */
+static double measure(void (*run)(char * data, int length), char * data, int length) {
+    double best = 0;
+
+    // Warm up the caches, branch predictors and the allocator.
+    run(data, length);
+
+    for(int repetition = 0; repetition < REPETITIONS; repetition++) {
+        double start = now();
+        run(data, length);
+        double elapsed = now() - start;
+
+        if(elapsed > 0 && BODIES / elapsed > best) {
+            best = BODIES / elapsed;
+        }
+    }
+
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    char * data = strdup(body);
+    int length = (int) strlen(data);
+
+    double created = measure(run_create, data, length);
+    double reset = measure(run_reset, data, length);
+    double pooled = measure(run_pool, data, length);
+
+    printf("%-10s %14s %8s\n", "tokenizer", "bodies/s", "gain");
+    printf("%-10s %14.0f %7.2fx\n", "create", created, 1.0);
+    printf("%-10s %14.0f %7.2fx\n", "reset", reset, reset / created);
+    printf("%-10s %14.0f %7.2fx\n", "pool", pooled, pooled / created);
+
+    free(data);
+
+    return EXIT_SUCCESS;
+}
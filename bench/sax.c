@@ -0,0 +1,138 @@
+#include "bench.h"
+
+/*
+ * Measures the cost of checking the grammar in the sax parser against reading the same tokens unchecked.
+ */
+
+#define RECORDS 50000
+#define REPETITIONS 7
+
+/*
+ * Generates an array of small records mixing every type of value.
+ */
+static Output generate() {
+    Output output = {NULL, 0, 0};
+    char text[256];
+
+    output_append(&output, "[");
+
+    for(int record = 0; record < RECORDS; record++) {
+        snprintf(text, sizeof(text),
+                 "%s{\"id\":%d,\"name\":\"record %d\",\"score\":%d.25,\"tags\":[\"a\",\"b\"],\"active\":true,\"parent\":null}",
+                 (record > 0 ? "," : ""), record, record, record);
+        output_append(&output, text);
+    }
+
+    output_append(&output, "]");
+
+    return output;
+}
+
+static JsonError countEvent(void * context) {
+    (*(long *) context)++;
+    return JSON_SUCCESS;
+}
+
+static JsonError countText(const char * text, size_t length, void * context) {
+    (*(long *) context)++;
+    return JSON_SUCCESS;
+}
+
+static JsonError countInteger(long int value, void * context) {
+    (*(long *) context)++;
+    return JSON_SUCCESS;
+}
+
+static JsonError countDecimal(double value, void * context) {
+    (*(long *) context)++;
+    return JSON_SUCCESS;
+}
+
+static JsonError countBoolean(bool value, void * context) {
+    (*(long *) context)++;
+    return JSON_SUCCESS;
+}
+
+/*
+ * Whether the tokens are read through the sax parser.
+ */
+struct BenchOptions {
+    bool sax;
+};
+
+/*
+ * Counts the tokens in the input other than commas and colons, either through the sax parser or
+ * by reading them directly from the tokenizer.
+ */
+static long countTokens(Output * input, const BenchOptions * options) {
+    JsonError error;
+
+    JsonBuffer * buffer = json_bufferFixed_create(input->data, (int) input->length, 10, &error);
+    TokenizerHandle * tokenizer = (buffer == NULL ? NULL : json_tokenizer_create(buffer, &error));
+
+    if(tokenizer == NULL) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    long count = 0;
+
+    if(options->sax) {
+        JsonHandlers handlers = {
+            .onStartObject = countEvent, .onEndObject = countEvent,
+            .onStartArray = countEvent, .onEndArray = countEvent,
+            .onKey = countText, .onString = countText, .onNumber = countText,
+            .onInteger = countInteger, .onDecimal = countDecimal,
+            .onBoolean = countBoolean, .onNull = countEvent
+        };
+
+        SaxParser * parser = json_sax_create(&handlers, &count, 0, &error);
+
+        if(parser != NULL) {
+            error = json_sax_parse(parser, tokenizer);
+            json_sax_destroy(parser);
+        }
+    } else {
+        TokenType token;
+
+        while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR) {
+            if(token != JSON_TOKEN_COMMA && token != JSON_TOKEN_COLON) {
+                count++;
+            }
+        }
+
+        error = json_tokenizer_getError(tokenizer);
+    }
+
+    if(error != JSON_SUCCESS) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    json_tokenizer_destroy(tokenizer);
+
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    Output input = generate();
+
+    BenchOptions tokens = {false};
+    BenchOptions sax = {true};
+
+    if(countTokens(&input, &tokens) != countTokens(&input, &sax)) {
+        fprintf(stderr, "The sax parser reported a different number of tokens\n");
+        return EXIT_FAILURE;
+    }
+
+    double unchecked = bench_measure(countTokens, &input, &tokens, REPETITIONS);
+    double checked = bench_measure(countTokens, &input, &sax, REPETITIONS);
+
+    printf("%-10s %12s %12s %8s\n", "reader", "bytes", "MB/s", "cost");
+    printf("%-10s %12zu %12.1f %7.1f%%\n", "tokens", input.length, unchecked / 1e6, 0.0);
+    printf("%-10s %12zu %12.1f %7.1f%%\n", "sax", input.length, checked / 1e6, (unchecked / checked - 1) * 100);
+
+    free(input.data);
+
+    return EXIT_SUCCESS;
+}
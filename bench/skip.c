@@ -0,0 +1,152 @@
+#include "bench.h"
+
+/*
+ * Compares reading one field of each record when the rest of each record is tokenized or skipped.
+ */
+
+#define RECORDS 50000
+#define REPETITIONS 7
+
+/*
+ * Generates an array of records where only the id is wanted, followed by a large payload that is not.
+ */
+static Output generate() {
+    Output output = {NULL, 0, 0};
+    char text[128];
+
+    output_append(&output, "[");
+
+    for(int record = 0; record < RECORDS; record++) {
+        snprintf(text, sizeof(text), "%s{\"id\": %d, \"payload\": {", (record > 0 ? ", " : ""), record);
+        output_append(&output, text);
+
+        for(int field = 0; field < 8; field++) {
+            snprintf(text, sizeof(text), "%s\"field%d\": [%d.5, \"text \\\"%d\\\"\", true, null]",
+                     (field > 0 ? ", " : ""), field, record + field, field);
+            output_append(&output, text);
+        }
+
+        output_append(&output, "}}");
+    }
+
+    output_append(&output, "]");
+
+    return output;
+}
+
+/*
+ * The engine to read with, and whether the payloads are skipped.
+ */
+struct BenchOptions {
+    TokenizerEngine engine;
+    bool skip;
+};
+
+/*
+ * Reads the id of each record, either skipping each payload or reading every token of it.
+ *
+ * Returns the sum of the ids, which is the same either way.
+ */
+static long readIds(Output * input, const BenchOptions * options) {
+    JsonError error;
+
+    JsonBuffer * buffer = json_bufferFixed_create(input->data, (int) input->length, 10, &error);
+    TokenizerHandle * tokenizer = (buffer == NULL ? NULL : json_tokenizer_create(buffer, &error));
+
+    if(tokenizer != NULL) {
+        error = json_tokenizer_setEngine(tokenizer, options->engine);
+    }
+
+    if(tokenizer == NULL || error != JSON_SUCCESS) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    long sum = 0;
+
+    // Each record is {"id": <id>, "payload": <payload>}, so the payload follows the seventh token.
+    TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+    while(token != JSON_TOKEN_ARRAY_END && token != JSON_TOKEN_ERROR && token != JSON_TOKEN_EOF) {
+        for(int index = 0; index < 7; index++) {
+            token = json_tokenizer_readNextToken(tokenizer);
+
+            if(token == JSON_TOKEN_NUMBER_INTEGER) {
+                sum += json_tokenizer_getIntegerValue(tokenizer);
+            }
+        }
+
+        if(options->skip) {
+            error = json_tokenizer_skipValue(tokenizer);
+        } else {
+            int depth = 0;
+
+            do {
+                token = json_tokenizer_readNextToken(tokenizer);
+
+                if(token == JSON_TOKEN_OBJECT_START || token == JSON_TOKEN_ARRAY_START) {
+                    depth++;
+                } else if(token == JSON_TOKEN_OBJECT_END || token == JSON_TOKEN_ARRAY_END) {
+                    depth--;
+                }
+            } while(depth > 0 && token != JSON_TOKEN_ERROR);
+
+            error = json_tokenizer_getError(tokenizer);
+        }
+
+        if(error != JSON_SUCCESS) {
+            json_error_logReason(error);
+            exit(EXIT_FAILURE);
+        }
+
+        // The end of the record, then the comma or the end of the array.
+        json_tokenizer_readNextToken(tokenizer);
+        token = json_tokenizer_readNextToken(tokenizer);
+    }
+
+    if(token != JSON_TOKEN_ARRAY_END) {
+        json_tokenizer_logError(tokenizer);
+        exit(EXIT_FAILURE);
+    }
+
+    json_tokenizer_destroy(tokenizer);
+
+    return sum;
+}
+
+int main(int argc, char *argv[]) {
+    Output input = generate();
+
+    TokenizerEngine engines[2] = {JSON_ENGINE_STREAMING, JSON_ENGINE_INDEXED};
+
+    long expected = (long) RECORDS * (RECORDS - 1) / 2;
+
+    printf("%-10s %-10s %12s %12s %8s\n", "engine", "payload", "bytes", "MB/s", "gain");
+
+    for(int engine = 0; engine < 2; engine++) {
+        double tokenized = 0;
+
+        for(int skip = 0; skip < 2; skip++) {
+            BenchOptions options = {engines[engine], skip};
+
+            if(readIds(&input, &options) != expected) {
+                fprintf(stderr, "The ids read were wrong\n");
+                return EXIT_FAILURE;
+            }
+
+            double bytesPerSecond = bench_measure(readIds, &input, &options, REPETITIONS);
+
+            if(!skip) {
+                tokenized = bytesPerSecond;
+            }
+
+            printf("%-10s %-10s %12zu %12.1f %7.2fx\n",
+                   json_engine_name(engines[engine]), (skip ? "skipped" : "tokenized"), input.length,
+                   bytesPerSecond / 1e6, bytesPerSecond / tokenized);
+        }
+    }
+
+    free(input.data);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,363 @@
+#include <unistd.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define BENCH_HAS_CYCLES 1
+#else
+#define BENCH_HAS_CYCLES 0
+#endif
+
+#include "bench.h"
+
+/*
+ * Reads every token of a generated corpus through json_tokenizer_readNextToken, with a fixed buffer holding the
+ * whole input and with file buffers of several sizes and history lengths, read as they are filled or read ahead
+ * on a separate thread, so that changes to json_buffer_fill and the tokenizer can be compared run to run.
+ *
+ * Each run is warmed up once and then repeated, reporting the median. The results are printed as a table, and
+ * written as CSV to the file given with --csv so they can be kept to track regressions.
+ */
+
+#define CORPUS_SIZE (8 * 1024 * 1024)
+#define NDJSON_SIZE (32 * 1024 * 1024)
+#define NESTED_DEPTH 512
+#define REPETITIONS 5
+
+/*
+ * A kind of input in the corpus, generated into input and written to path for the file buffers.
+ */
+typedef struct Corpus Corpus;
+
+struct Corpus {
+    const char * name;
+    void (*generate)(Output * output, size_t size);
+    size_t size;
+    Output input;
+    char path[64];
+};
+
+/*
+ * The buffer used to read the corpus, where a bufferSize of 0 is a fixed buffer over all of the input,
+ * and a file buffer with blocks reads that many blocks ahead instead of reading when it is filled.
+ */
+typedef struct BufferSetup BufferSetup;
+
+struct BufferSetup {
+    int bufferSize;
+    int history;
+    int blocks;
+};
+
+/*
+ * The median of the repetitions of one run.
+ */
+typedef struct Result Result;
+
+struct Result {
+    size_t tokens;
+    double seconds;
+    double cycles;
+};
+
+/*
+ * An array of integers, decimals and exponents of varying lengths.
+ */
+static void generate_numbers(Output * output, size_t size) {
+    char text[128];
+
+    output_append(output, "[");
+
+    for(int index = 0; output->length < size; index++) {
+        snprintf(text, sizeof(text), "%s%d,%d.%03d,-%de-%d,%ld", (index > 0 ? "," : ""),
+                 index, index % 1000, index % 997, index % 89, index % 300, (long int) index * 2654435761L);
+        output_append(output, text);
+    }
+
+    output_append(output, "]");
+}
+
+/*
+ * An array of plain strings of varying lengths, some of them not ASCII.
+ */
+static void generate_strings(Output * output, size_t size) {
+    static const char * words[] = {"alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "gr\xc3\xbcn", "h\xc3\xb4tel"};
+
+    output_append(output, "[");
+
+    for(int index = 0; output->length < size; index++) {
+        output_append(output, (index > 0 ? ",\"" : "\""));
+
+        for(int word = 0; word <= index % 12; word++) {
+            output_append(output, words[(index + word) % 8]);
+            output_append(output, " ");
+        }
+
+        output_append(output, "\"");
+    }
+
+    output_append(output, "]");
+}
+
+/*
+ * Arrays and objects nested NESTED_DEPTH deep, repeated until the size is reached.
+ */
+static void generate_nested(Output * output, size_t size) {
+    output_append(output, "[");
+
+    for(int index = 0; output->length < size; index++) {
+        output_append(output, (index > 0 ? "," : ""));
+
+        for(int depth = 0; depth < NESTED_DEPTH; depth++) {
+            output_append(output, (depth % 2 == 0 ? "{\"a\":" : "["));
+        }
+
+        output_append(output, "1");
+
+        for(int depth = NESTED_DEPTH - 1; depth >= 0; depth--) {
+            output_append(output, (depth % 2 == 0 ? "}" : "]"));
+        }
+    }
+
+    output_append(output, "]");
+}
+
+/*
+ * Records laid out with new lines and indentation, so that much of the input is whitespace.
+ */
+static void generate_pretty(Output * output, size_t size) {
+    char text[512];
+
+    output_append(output, "[\n");
+
+    for(int index = 0; output->length < size; index++) {
+        snprintf(text, sizeof(text),
+                 "%s    {\n        \"id\": %d,\n        \"name\": \"record %d\",\n        \"tags\": [\n"
+                 "            \"a\",\n            \"b\"\n        ],\n        \"active\": %s,\n        \"parent\": null\n    }",
+                 (index > 0 ? ",\n" : ""), index, index, (index % 2 == 0 ? "true" : "false"));
+        output_append(output, text);
+    }
+
+    output_append(output, "\n]\n");
+}
+
+/*
+ * Strings full of escapes, including unicode escapes and surrogate pairs.
+ */
+static void generate_escapes(Output * output, size_t size) {
+    output_append(output, "[");
+
+    for(int index = 0; output->length < size; index++) {
+        output_append(output, (index > 0 ? "," : ""));
+        output_append(output, "\"line\\none\\ttab \\\"quoted\\\" back\\\\slash \\u00e9t\\u00e9 \\ud83d\\ude00 \\/\\b\\f\\r\"");
+    }
+
+    output_append(output, "]");
+}
+
+/*
+ * Newline delimited records, read as a stream of top level values.
+ */
+static void generate_ndjson(Output * output, size_t size) {
+    char text[256];
+
+    for(int index = 0; output->length < size; index++) {
+        snprintf(text, sizeof(text),
+                 "{\"id\":%d,\"user\":\"user%d\",\"score\":%d.5,\"tags\":[\"x\",\"y\",\"z\"],\"ok\":true,\"ref\":null}\n",
+                 index, index % 1000, index % 100);
+        output_append(output, text);
+    }
+}
+
+static double cycles() {
+#if BENCH_HAS_CYCLES
+    return (double) __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Reads every token of the corpus with the buffer setup, returning the number of tokens.
+ */
+static size_t tokenize(Corpus * corpus, BufferSetup * setup) {
+    JsonError error;
+    JsonBuffer * buffer;
+
+    if(setup->bufferSize == 0) {
+        buffer = json_bufferFixed_create(corpus->input.data, (int) corpus->input.length, setup->history, &error);
+    } else if(setup->blocks == 0) {
+        buffer = json_bufferedFile_open(corpus->path, setup->bufferSize, setup->history, &error);
+    } else {
+        buffer = json_bufferedFile_openAhead(corpus->path, setup->bufferSize, setup->history, setup->blocks, &error);
+    }
+
+    if(buffer == NULL) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(buffer, &error);
+
+    if(tokenizer == NULL) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t tokens = 0;
+    TokenType token;
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR) {
+        tokens++;
+    }
+
+    error = json_tokenizer_getError(tokenizer);
+
+    if(error != JSON_SUCCESS) {
+        fprintf(stderr, "%s: ", corpus->name);
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    json_tokenizer_destroy(tokenizer);
+
+    return tokens;
+}
+
+static int compare_doubles(const void * a, const void * b) {
+    double first = *(const double *) a;
+    double second = *(const double *) b;
+
+    return (first > second) - (first < second);
+}
+
+/*
+ * Runs the tokenizer once to warm up, then REPETITIONS times, keeping the median time and cycles.
+ */
+static Result measure(Corpus * corpus, BufferSetup * setup) {
+    double seconds[REPETITIONS];
+    double counts[REPETITIONS];
+
+    Result result = {tokenize(corpus, setup), 0, 0};
+
+    for(int repetition = 0; repetition < REPETITIONS; repetition++) {
+        double startCycles = cycles();
+        double start = now();
+
+        tokenize(corpus, setup);
+
+        seconds[repetition] = now() - start;
+        counts[repetition] = cycles() - startCycles;
+    }
+
+    qsort(seconds, REPETITIONS, sizeof(double), compare_doubles);
+    qsort(counts, REPETITIONS, sizeof(double), compare_doubles);
+
+    result.seconds = seconds[REPETITIONS / 2];
+    result.cycles = counts[REPETITIONS / 2];
+
+    return result;
+}
+
+/*
+ * Writes the corpus to a temporary file for the file buffers to read.
+ */
+static void corpus_write(Corpus * corpus) {
+    snprintf(corpus->path, sizeof(corpus->path), "/tmp/json_bench_%s_%d.json", corpus->name, (int) getpid());
+
+    FILE * file = fopen(corpus->path, "wb");
+
+    if(file == NULL || fwrite(corpus->input.data, 1, corpus->input.length, file) != corpus->input.length) {
+        fprintf(stderr, "Unable to write %s\n", corpus->path);
+        exit(EXIT_FAILURE);
+    }
+
+    fclose(file);
+}
+
+int main(int argc, char *argv[]) {
+    const char * csvPath = NULL;
+
+    for(int index = 1; index < argc; index++) {
+        if(strcmp(argv[index], "--csv") == 0 && index + 1 < argc) {
+            csvPath = argv[++index];
+        } else {
+            fprintf(stderr, "Usage: %s [--csv file]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    Corpus corpora[] = {
+        {"numbers", generate_numbers, CORPUS_SIZE},
+        {"strings", generate_strings, CORPUS_SIZE},
+        {"nested", generate_nested, CORPUS_SIZE},
+        {"pretty", generate_pretty, CORPUS_SIZE},
+        {"escapes", generate_escapes, CORPUS_SIZE},
+        {"ndjson", generate_ndjson, NDJSON_SIZE}
+    };
+
+    BufferSetup setups[] = {
+        {0, 10, 0},
+        {4 * 1024, 10, 0},
+        {64 * 1024, 10, 0},
+        {64 * 1024, 1024, 0},
+        {1024 * 1024, 10, 0},
+        {1024 * 1024, 64 * 1024, 0},
+        {64 * 1024, 10, 2},
+        {1024 * 1024, 10, 2},
+        {1024 * 1024, 10, 4}
+    };
+
+    int corpusCount = sizeof(corpora) / sizeof(Corpus);
+    int setupCount = sizeof(setups) / sizeof(BufferSetup);
+
+    FILE * csv = NULL;
+
+    if(csvPath != NULL) {
+        csv = fopen(csvPath, "w");
+
+        if(csv == NULL) {
+            fprintf(stderr, "Unable to open %s\n", csvPath);
+            return EXIT_FAILURE;
+        }
+
+        fprintf(csv, "corpus,buffer,buffer_size,history,bytes,tokens,seconds,mb_per_s,tokens_per_s,cycles_per_byte\n");
+    }
+
+    printf("%-8s %-6s %8s %8s %10s %10s %12s %8s\n", "corpus", "buffer", "size", "history", "MB", "MB/s", "Mtokens/s", "cyc/B");
+
+    for(int corpusIndex = 0; corpusIndex < corpusCount; corpusIndex++) {
+        Corpus * corpus = &corpora[corpusIndex];
+
+        corpus->generate(&corpus->input, corpus->size);
+        corpus_write(corpus);
+
+        for(int setupIndex = 0; setupIndex < setupCount; setupIndex++) {
+            BufferSetup * setup = &setups[setupIndex];
+            Result result = measure(corpus, setup);
+
+            const char * bufferName = (setup->bufferSize == 0 ? "fixed" : (setup->blocks == 0 ? "file" : "ahead"));
+            double bytes = (double) corpus->input.length;
+            double bytesPerSecond = (result.seconds > 0 ? bytes / result.seconds : 0);
+            double tokensPerSecond = (result.seconds > 0 ? result.tokens / result.seconds : 0);
+            double cyclesPerByte = result.cycles / bytes;
+
+            printf("%-8s %-6s %8d %8d %10.1f %10.1f %12.2f %8.2f\n", corpus->name, bufferName, setup->bufferSize,
+                   setup->history, bytes / 1e6, bytesPerSecond / 1e6, tokensPerSecond / 1e6, cyclesPerByte);
+
+            if(csv != NULL) {
+                fprintf(csv, "%s,%s,%d,%d,%zu,%zu,%.6f,%.2f,%.0f,%.3f\n", corpus->name, bufferName, setup->bufferSize,
+                        setup->history, corpus->input.length, result.tokens, result.seconds, bytesPerSecond / 1e6,
+                        tokensPerSecond, cyclesPerByte);
+            }
+        }
+
+        unlink(corpus->path);
+        free(corpus->input.data);
+    }
+
+    if(csv != NULL) {
+        fclose(csv);
+    }
+
+    return EXIT_SUCCESS;
+}
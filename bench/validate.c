@@ -0,0 +1,95 @@
+#include "bench.h"
+
+/*
+ * Compares checking input with json_validate against reading all of its tokens.
+ */
+
+#define RECORDS 50000
+#define REPETITIONS 7
+
+/*
+ * Generates an array of small records mixing every type of value, with some text that is not ASCII.
+ */
+static Output generate() {
+    Output output = {NULL, 0, 0};
+    char text[256];
+
+    output_append(&output, "[");
+
+    for(int record = 0; record < RECORDS; record++) {
+        snprintf(text, sizeof(text),
+                 "%s{\"id\":%d,\"name\":\"r\\u00e9cord %d \xe2\x82\xac\",\"score\":%d.25,\"tags\":[\"a\",\"b\"],\"active\":true,\"parent\":null}",
+                 (record > 0 ? "," : ""), record, record, record);
+        output_append(&output, text);
+    }
+
+    output_append(&output, "]");
+
+    return output;
+}
+
+/*
+ * Whether the input is checked with json_validate.
+ */
+struct BenchOptions {
+    bool validate;
+};
+
+/*
+ * Checks the input, either with json_validate or by reading every token through the tokenizer.
+ *
+ * Returns the number of bytes checked.
+ */
+static long checkInput(Output * input, const BenchOptions * options) {
+    JsonError error;
+
+    JsonBuffer * buffer = json_bufferFixed_create(input->data, (int) input->length, 10, &error);
+
+    if(buffer == NULL) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    if(options->validate) {
+        error = json_validate(buffer, NULL);
+
+        json_buffer_destroy(buffer);
+    } else {
+        TokenizerHandle * tokenizer = json_tokenizer_create(buffer, &error);
+
+        if(tokenizer == NULL) {
+            json_error_logReason(error);
+            exit(EXIT_FAILURE);
+        }
+
+        TokenType token;
+
+        while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR);
+
+        error = json_tokenizer_getError(tokenizer);
+
+        json_tokenizer_destroy(tokenizer);
+    }
+
+    check(error);
+
+    return (long) input->length;
+}
+
+int main(int argc, char *argv[]) {
+    Output input = generate();
+
+    BenchOptions tokenizer = {false};
+    BenchOptions validate = {true};
+
+    double tokenized = bench_measure(checkInput, &input, &tokenizer, REPETITIONS);
+    double validated = bench_measure(checkInput, &input, &validate, REPETITIONS);
+
+    printf("%-10s %12s %12s %8s\n", "reader", "bytes", "MB/s", "gain");
+    printf("%-10s %12zu %12.1f %7.2fx\n", "tokenizer", input.length, tokenized / 1e6, 1.0);
+    printf("%-10s %12zu %12.1f %7.2fx\n", "validate", input.length, validated / 1e6, validated / tokenized);
+
+    free(input.data);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+#include "bench.h"
+#include "../src/simd_internal.h"
+
+/*
+ * Compares tokenizing throughput of indented and minified input for each supported instruction set.
+ */
+
+#define RECORDS 100000
+#define REPETITIONS 7
+
+/*
+ * Generates an array of records, indenting each level by indent spaces if indent is not 0.
+ */
+static Output generate(int indent) {
+    Output output = {NULL, 0, 0};
+    char text[128];
+
+    const char * colon = (indent == 0 ? ":" : ": ");
+
+    output_append(&output, "[");
+
+    for(int record = 0; record < RECORDS; record++) {
+        if(record > 0)
+            output_append(&output, ",");
+
+        output_newLine(&output, indent, 1);
+        output_append(&output, "{");
+
+        output_newLine(&output, indent, 2);
+        snprintf(text, sizeof(text), "\"id\"%s%d,", colon, record);
+        output_append(&output, text);
+
+        output_newLine(&output, indent, 2);
+        snprintf(text, sizeof(text), "\"name\"%s\"item%d\",", colon, record);
+        output_append(&output, text);
+
+        output_newLine(&output, indent, 2);
+        snprintf(text, sizeof(text), "\"active\"%s%s,", colon, (record % 2 == 0 ? "true" : "false"));
+        output_append(&output, text);
+
+        output_newLine(&output, indent, 2);
+        snprintf(text, sizeof(text), "\"tags\"%s[", colon);
+        output_append(&output, text);
+
+        for(int tag = 0; tag < 3; tag++) {
+            output_newLine(&output, indent, 3);
+            snprintf(text, sizeof(text), "\"tag%d\"%s", tag, (tag < 2 ? "," : ""));
+            output_append(&output, text);
+        }
+
+        output_newLine(&output, indent, 2);
+        output_append(&output, "]");
+
+        output_newLine(&output, indent, 1);
+        output_append(&output, "}");
+    }
+
+    output_newLine(&output, indent, 0);
+    output_append(&output, "]");
+
+    return output;
+}
+
+/*
+ * The instruction set to tokenize with.
+ */
+struct BenchOptions {
+    SimdLevel level;
+};
+
+/*
+ * Tokenizes the whole input with the instruction set, returning the number of tokens read.
+ */
+static long tokenize(Output * input, const BenchOptions * options) {
+    JsonError error;
+
+    json_simd_setLevel(options->level);
+
+    JsonBuffer * buffer = json_bufferFixed_create(input->data, (int) input->length, 10, &error);
+    TokenizerHandle * tokenizer = (buffer == NULL ? NULL : json_tokenizer_create(buffer, &error));
+
+    if(tokenizer == NULL) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    long tokens = 0;
+
+    while(true) {
+        TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+        if(token == JSON_TOKEN_EOF)
+            break;
+
+        if(token == JSON_TOKEN_ERROR) {
+            json_tokenizer_logError(tokenizer);
+            exit(EXIT_FAILURE);
+        }
+
+        tokens++;
+    }
+
+    json_tokenizer_destroy(tokenizer);
+
+    return tokens;
+}
+
+int main(int argc, char *argv[]) {
+    Output inputs[2] = {generate(4), generate(0)};
+    const char * names[2] = {"indented", "minified"};
+
+    SimdLevel supported = json_simd_getSupportedLevel();
+
+    printf("%-10s %-8s %12s %12s %8s\n", "input", "level", "bytes", "MB/s", "gain");
+
+    for(int input = 0; input < 2; input++) {
+        double scalar = 0;
+
+        for(SimdLevel level = JSON_SIMD_SCALAR; level <= supported; level++) {
+            BenchOptions options = {level};
+
+            double bytesPerSecond = bench_measure(tokenize, &inputs[input], &options, REPETITIONS);
+
+            if(level == JSON_SIMD_SCALAR) {
+                scalar = bytesPerSecond;
+            }
+
+            printf("%-10s %-8s %12zu %12.1f %7.2fx\n",
+                   names[input], json_simd_levelName(level), inputs[input].length,
+                   bytesPerSecond / 1e6, bytesPerSecond / scalar);
+        }
+    }
+
+    free(inputs[0].data);
+    free(inputs[1].data);
+
+    return EXIT_SUCCESS;
+}
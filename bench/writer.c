@@ -0,0 +1,144 @@
+#include "bench.h"
+
+/*
+ * Measures how quickly records are written, compact and pretty, and compares writing doubles with printf.
+ */
+
+#define RECORDS 200000
+#define REPETITIONS 7
+
+/*
+ * Writes an array of records, returning the number of characters written.
+ */
+static size_t writeRecords(int options) {
+    JsonError error;
+
+    JsonWriter * writer = json_writer_create(options, &error);
+    check(error);
+
+    check(json_writer_startArray(writer));
+
+    for(int record = 0; record < RECORDS; record++) {
+        check(json_writer_startObject(writer));
+
+        check(json_writer_writeKey(writer, "id", 2));
+        check(json_writer_writeInteger(writer, record));
+
+        check(json_writer_writeKey(writer, "name", 4));
+        check(json_writer_writeString(writer, "a \"quoted\" name\n", 16));
+
+        check(json_writer_writeKey(writer, "score", 5));
+        check(json_writer_writeDecimal(writer, record / 7.0));
+
+        check(json_writer_writeKey(writer, "tags", 4));
+        check(json_writer_startArray(writer));
+        check(json_writer_writeString(writer, "first", 5));
+        check(json_writer_writeString(writer, "second", 6));
+        check(json_writer_endArray(writer));
+
+        check(json_writer_writeKey(writer, "active", 6));
+        check(json_writer_writeBoolean(writer, record % 2 == 0));
+
+        check(json_writer_endObject(writer));
+    }
+
+    check(json_writer_endArray(writer));
+
+    size_t length;
+    json_writer_getOutput(writer, &length);
+
+    check(json_writer_destroy(writer));
+
+    return length;
+}
+
+/*
+ * Writes the same doubles as the records with printf, in the 17 digits needed to be sure they read back.
+ */
+static size_t printDoubles() {
+    char formatted[32];
+    size_t length = 0;
+
+    for(int record = 0; record < RECORDS; record++) {
+        length += (size_t) snprintf(formatted, sizeof(formatted), "%.17g", record / 7.0);
+    }
+
+    return length;
+}
+
+/*
+ * Writes the doubles of the records alone.
+ */
+static size_t writeDoubles() {
+    JsonError error;
+
+    JsonWriter * writer = json_writer_create(JSON_WRITER_COMPACT, &error);
+    check(error);
+
+    check(json_writer_startArray(writer));
+
+    for(int record = 0; record < RECORDS; record++) {
+        check(json_writer_writeDecimal(writer, record / 7.0));
+    }
+
+    check(json_writer_endArray(writer));
+
+    size_t length;
+    json_writer_getOutput(writer, &length);
+
+    check(json_writer_destroy(writer));
+
+    return length;
+}
+
+/*
+ * Returns the best time in seconds over the repetitions, setting length to the characters written.
+ */
+static double measure(size_t (*run)(int), int options, size_t * length) {
+    double best = 0;
+
+    for(int repetition = 0; repetition < REPETITIONS; repetition++) {
+        double start = now();
+        *length = run(options);
+        double elapsed = now() - start;
+
+        if(repetition == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    return best;
+}
+
+static size_t runCompact(int options) {
+    return writeRecords(options);
+}
+
+static size_t runPrintf(int options) {
+    return printDoubles();
+}
+
+static size_t runDoubles(int options) {
+    return writeDoubles();
+}
+
+int main(int argc, char *argv[]) {
+    size_t length;
+    double elapsed;
+
+    printf("%-16s %12s %12s %14s\n", "output", "bytes", "MB/s", "numbers/s");
+
+    elapsed = measure(runCompact, JSON_WRITER_COMPACT, &length);
+    printf("%-16s %12zu %12.1f %14s\n", "compact", length, length / elapsed / 1e6, "-");
+
+    elapsed = measure(runCompact, JSON_WRITER_PRETTY, &length);
+    printf("%-16s %12zu %12.1f %14s\n", "pretty", length, length / elapsed / 1e6, "-");
+
+    elapsed = measure(runDoubles, 0, &length);
+    printf("%-16s %12zu %12.1f %14.0f\n", "doubles", length, length / elapsed / 1e6, RECORDS / elapsed);
+
+    elapsed = measure(runPrintf, 0, &length);
+    printf("%-16s %12zu %12.1f %14.0f\n", "doubles printf", length, length / elapsed / 1e6, RECORDS / elapsed);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef JSON
+#define JSON
+#include "../src/json.h"
+#endif
+
+/*
+ * What every check shares: a count of the failures, which main reports on, and the temporary files the checks
+ * that read files write their input to.
+ */
+
+static int failures = 0;
+
+/*
+ * Counts a failure when the condition does not hold, printing what was checked and what went wrong.
+ */
+static inline void expect(bool condition, const char * name, const char * message) {
+    if(!condition) {
+        fprintf(stderr, "FAIL %s: %s\n", name, message);
+        failures++;
+    }
+}
+
+/*
+ * Writes the input to a temporary file named after the check, returning its name, which the caller unlinks
+ * before the next file is written.
+ */
+static inline char * write_file(const char * check, const char * input, size_t size) {
+    static char file[64];
+
+    snprintf(file, sizeof(file), "/tmp/json_check_%s_XXXXXX", check);
+
+    int descriptor = mkstemp(file);
+
+    if(descriptor == -1 || write(descriptor, input, size) != (ssize_t) size || close(descriptor) == -1) {
+        fprintf(stderr, "Unable to write %s\n", file);
+        exit(EXIT_FAILURE);
+    }
+
+    return file;
+}
@@ -0,0 +1,142 @@
+#include "check.h"
+#include "../src/decode.h"
+
+/*
+ * Checks that decoders defined by json_decode_define fill the members of a struct, leave members of null or
+ * missing fields as they were, skip members with other keys, and fail on arrays past their capacity, strings
+ * too long for their member and trailing commas.
+ */
+
+#define HISTORY 4
+
+typedef struct Point Point;
+typedef struct Shape Shape;
+
+struct Point {
+    int x;
+    int y;
+};
+
+struct Shape {
+    long int id;
+    char name[8];
+    double scale;
+    bool closed;
+    Point origin;
+    int sizes[3];
+    int sizeCount;
+    Point points[2];
+    int pointCount;
+};
+
+#define POINT_FIELDS(FIELD) \
+    FIELD(INT, x) \
+    FIELD(INT, y)
+
+#define SHAPE_FIELDS(FIELD) \
+    FIELD(LONG, id) \
+    FIELD(STRING, name) \
+    FIELD(DOUBLE, scale) \
+    FIELD(BOOL, closed) \
+    FIELD(OBJECT, origin, json_decodePoint) \
+    FIELD(ARRAY, sizes, sizeCount, json_decode_int) \
+    FIELD(ARRAY, points, pointCount, json_decodePoint)
+
+static json_decode_define(json_decodePoint, Point, POINT_FIELDS)
+
+static json_decode_define(json_decodeShape, Shape, SHAPE_FIELDS)
+
+/*
+ * The shape every input is decoded into, so that members left unchanged can be told apart.
+ */
+static const Shape initial = {-1, "none", -1.0, true, {-1, -1}, {-1, -1, -1}, -1, {{-1, -1}, {-1, -1}}, -1};
+
+/*
+ * Decodes the input from a fixed buffer into a shape that starts as the initial one.
+ */
+static JsonError decode(const char * input, Shape * shape) {
+    size_t size = strlen(input);
+    JsonError error;
+
+    char * contents = malloc(size + 1);
+    memcpy(contents, input, size);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(contents, size, HISTORY, &error), &error);
+
+    *shape = initial;
+    error = json_decodeShape(tokenizer, json_tokenizer_readNextToken(tokenizer), shape);
+
+    json_tokenizer_destroy(tokenizer);
+    free(contents);
+
+    return error;
+}
+
+/*
+ * Checks that decoding the input gives the error expected.
+ */
+static void check_error(const char * name, const char * input, JsonError expected, Shape * shape) {
+    JsonError error = decode(input, shape);
+
+    if(error != expected) {
+        expect(false, name, "the input was decoded with another result");
+        fprintf(stderr, "  expected: %s\n  actual:   %s\n", json_error_name(expected), json_error_name(error));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Shape shape;
+
+    check_error("every field", "{\"id\": 7, \"name\": \"square\", \"scale\": 2.5, \"closed\": false, \"origin\": {\"x\": 1, \"y\": 2},"
+                               " \"sizes\": [3, 4], \"points\": [{\"x\": 5}, {\"y\": 6}]}", JSON_SUCCESS, &shape);
+    expect(shape.id == 7 && strcmp(shape.name, "square") == 0 && shape.scale == 2.5 && !shape.closed, "every field",
+           "a scalar member was decoded as another value");
+    expect(shape.origin.x == 1 && shape.origin.y == 2, "every field", "the object was decoded as another value");
+    expect(shape.sizeCount == 2 && shape.sizes[0] == 3 && shape.sizes[1] == 4 && shape.sizes[2] == -1, "every field",
+           "the array was decoded as another value");
+    expect(shape.pointCount == 2 && shape.points[0].x == 5 && shape.points[0].y == -1 && shape.points[1].x == -1 &&
+           shape.points[1].y == 6, "every field", "the array of objects was decoded as another value");
+
+    // Null and missing fields leave their members as they were, except arrays, which null empties.
+    check_error("null fields", "{\"id\": null, \"name\": null, \"scale\": null, \"closed\": null, \"origin\": null, \"sizes\": null}",
+                JSON_SUCCESS, &shape);
+    expect(shape.id == -1 && strcmp(shape.name, "none") == 0 && shape.scale == -1.0 && shape.closed, "null fields",
+           "a null scalar changed its member");
+    expect(shape.origin.x == -1 && shape.origin.y == -1, "null fields", "a null object changed its member");
+    expect(shape.sizeCount == 0 && shape.sizes[0] == -1, "null fields", "a null array was not taken as empty");
+    expect(shape.pointCount == -1, "null fields", "a missing array changed its member");
+
+    check_error("null object fields", "{\"origin\": {\"x\": null, \"y\": 3}, \"sizes\": [null, 8]}", JSON_SUCCESS, &shape);
+    expect(shape.origin.x == -1 && shape.origin.y == 3, "null object fields", "a null member of an object changed it");
+    expect(shape.sizeCount == 2 && shape.sizes[0] == -1 && shape.sizes[1] == 8, "null object fields", "a null element changed it");
+
+    // Members with other keys are skipped whatever they hold, including keys that start with the name of a field.
+    check_error("unknown keys", "{\"tags\": [\"a\", {\"id\": 9}], \"idx\": 9, \"nam\": \"x\", \"meta\": {\"name\": \"other\", \"x\": [[]]},"
+                                " \"id\": 4, \"extra\": null}", JSON_SUCCESS, &shape);
+    expect(shape.id == 4 && strcmp(shape.name, "none") == 0, "unknown keys", "a member with another key was decoded");
+
+    check_error("array past capacity", "{\"sizes\": [1, 2, 3, 4]}", JSON_ERROR_OUT_OF_RANGE, &shape);
+    expect(shape.sizeCount == 3 && shape.sizes[2] == 3, "array past capacity", "the elements that fit were not kept");
+
+    check_error("array of objects past capacity", "{\"points\": [{}, {}, {}]}", JSON_ERROR_OUT_OF_RANGE, &shape);
+
+    check_error("string too long", "{\"name\": \"octagons\"}", JSON_ERROR_OUT_OF_RANGE, &shape);
+    expect(strcmp(shape.name, "none") == 0, "string too long", "the member was changed");
+
+    check_error("string that fits", "{\"name\": \"octagon\"}", JSON_SUCCESS, &shape);
+    expect(strcmp(shape.name, "octagon") == 0, "string that fits", "the string was decoded as another value");
+
+    check_error("trailing comma in array", "{\"sizes\": [1,]}", JSON_ERROR_UNEXPECTED_TOKEN, &shape);
+    check_error("trailing comma in object", "{\"id\": 1,}", JSON_ERROR_UNEXPECTED_TOKEN, &shape);
+    check_error("leading comma in array", "{\"sizes\": [,1]}", JSON_ERROR_UNEXPECTED_TOKEN, &shape);
+    check_error("wrong type", "{\"closed\": 1}", JSON_ERROR_UNEXPECTED_TOKEN, &shape);
+    check_error("int out of range", "{\"sizes\": [4294967296]}", JSON_ERROR_OUT_OF_RANGE, &shape);
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("decode: all checks passed\n");
+    return EXIT_SUCCESS;
+}
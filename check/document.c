@@ -0,0 +1,192 @@
+#include "check.h"
+
+/*
+ * Checks that documents are built with the values, keys and nesting of their input, including empty and
+ * deeply nested containers that take more than one arena block, and that malformed input is rejected.
+ */
+
+#define HISTORY 10
+#define PRINTED 65536
+
+/*
+ * Prints a value compactly, with decimals printed by %g so that they read as they were written.
+ */
+static size_t print_value(JsonValue * value, char * printed, size_t length) {
+    switch(json_value_getType(value)) {
+        case JSON_VALUE_OBJECT:
+            length += snprintf(printed + length, PRINTED - length, "{");
+
+            for(size_t index = 0; index < json_value_getLength(value); index++) {
+                length += snprintf(printed + length, PRINTED - length, "%s\"%s\":", (index > 0 ? "," : ""), json_value_getKey(value, index));
+                length = print_value(json_value_getMember(value, index), printed, length);
+            }
+
+            return length + snprintf(printed + length, PRINTED - length, "}");
+        case JSON_VALUE_ARRAY:
+            length += snprintf(printed + length, PRINTED - length, "[");
+
+            for(size_t index = 0; index < json_value_getLength(value); index++) {
+                length += snprintf(printed + length, PRINTED - length, "%s", (index > 0 ? "," : ""));
+                length = print_value(json_value_getElement(value, index), printed, length);
+            }
+
+            return length + snprintf(printed + length, PRINTED - length, "]");
+        case JSON_VALUE_STRING:
+            return length + snprintf(printed + length, PRINTED - length, "\"%s\"", json_value_getString(value));
+        case JSON_VALUE_INTEGER:
+            return length + snprintf(printed + length, PRINTED - length, "%ld", json_value_getInteger(value));
+        case JSON_VALUE_DECIMAL:
+            return length + snprintf(printed + length, PRINTED - length, "%g", json_value_getDecimal(value));
+        case JSON_VALUE_BIG_NUMBER:
+            return length + snprintf(printed + length, PRINTED - length, "big:%s", json_value_getString(value));
+        case JSON_VALUE_BOOLEAN:
+            return length + snprintf(printed + length, PRINTED - length, "%s", (json_value_getBoolean(value) ? "true" : "false"));
+        default:
+            return length + snprintf(printed + length, PRINTED - length, "null");
+    }
+}
+
+/*
+ * Parses the input into the arena, which is reset rather than recreated between inputs, and returns the
+ * document, setting error if it could not be parsed.
+ */
+static JsonDocument * parse(JsonArena * arena, char * input, TokenizerHandle ** tokenizer, JsonError * error) {
+    json_arena_reset(arena);
+
+    *tokenizer = json_tokenizer_create(json_bufferFixed_create(input, strlen(input), HISTORY, error), error);
+
+    if(*tokenizer == NULL)
+        return NULL;
+
+    return json_document_parse(*tokenizer, arena, error);
+}
+
+/*
+ * Checks that the input is parsed into a document that prints as expected.
+ */
+static void check_document(JsonArena * arena, const char * name, char * input, const char * expected) {
+    static char printed[PRINTED];
+    TokenizerHandle * tokenizer;
+    JsonError error;
+
+    JsonDocument * document = parse(arena, input, &tokenizer, &error);
+
+    if(document == NULL) {
+        expect(false, name, json_error_name(error));
+    } else {
+        print_value(json_document_getRoot(document), printed, 0);
+
+        if(strcmp(printed, expected) != 0) {
+            expect(false, name, "the document differs from its input");
+            fprintf(stderr, "  expected: %s\n  actual:   %s\n", expected, printed);
+        }
+
+        expect(json_tokenizer_readNextToken(tokenizer) == JSON_TOKEN_EOF, name, "the document did not end the input");
+    }
+
+    json_tokenizer_destroy(tokenizer);
+}
+
+/*
+ * Checks that the input is rejected with the error expected.
+ */
+static void check_error(JsonArena * arena, const char * name, char * input, JsonError expected) {
+    TokenizerHandle * tokenizer;
+    JsonError error;
+
+    JsonDocument * document = parse(arena, input, &tokenizer, &error);
+
+    expect(document == NULL, name, "malformed input was parsed");
+
+    if(document == NULL && error != expected) {
+        expect(false, name, "malformed input was rejected with another error");
+        fprintf(stderr, "  expected: %s\n  actual:   %s\n", json_error_name(expected), json_error_name(error));
+    }
+
+    json_tokenizer_destroy(tokenizer);
+}
+
+int main(int argc, char *argv[]) {
+    JsonError error;
+
+    // Small blocks, so that most documents take several of them.
+    JsonArena * arena = json_arena_create(64, &error);
+
+    if(arena == NULL) {
+        json_error_logReason(error);
+        return EXIT_FAILURE;
+    }
+
+    check_document(arena, "empty object", "{}", "{}");
+    check_document(arena, "empty array", "[]", "[]");
+    check_document(arena, "scalar", "  42 ", "42");
+    check_document(arena, "empty containers", "{\"a\":{},\"b\":[],\"c\":[{},[]],\"d\":{\"e\":{}}}",
+                   "{\"a\":{},\"b\":[],\"c\":[{},[]],\"d\":{\"e\":{}}}");
+    check_document(arena, "scalars", "{\"s\":\"x\\ty\",\"i\":-7,\"d\":2.5,\"e\":-3e2,\"t\":true,\"f\":false,\"n\":null,"
+                   "\"big\":123456789012345678901234567890}",
+                   "{\"s\":\"x\ty\",\"i\":-7,\"d\":2.5,\"e\":-300,\"t\":true,\"f\":false,\"n\":null,"
+                   "\"big\":big:123456789012345678901234567890}");
+    check_document(arena, "nested", "[1,[2,[3,{\"four\":[4,{\"five\":5}]}]],6]", "[1,[2,[3,{\"four\":[4,{\"five\":5}]}]],6]");
+
+    // Wide and deep containers need more pending values than fit in one block.
+    static char input[PRINTED];
+    size_t length = 0;
+
+    length += sprintf(input + length, "[");
+
+    for(int element = 0; element < 1000; element++)
+        length += sprintf(input + length, "%s%d", (element > 0 ? "," : ""), element);
+
+    sprintf(input + length, "]");
+    check_document(arena, "wide", input, input);
+
+    length = 0;
+
+    for(int depth = 0; depth < 500; depth++)
+        length += sprintf(input + length, "{\"k\":[");
+
+    for(int depth = 0; depth < 500; depth++)
+        length += sprintf(input + length, "]}");
+
+    check_document(arena, "deep", input, input);
+
+    // Members are found by key, and the first of duplicated keys is the one found.
+    TokenizerHandle * tokenizer;
+    JsonDocument * document = parse(arena, "{\"a\":1,\"b\":{\"c\":\"d\"},\"a\":2}", &tokenizer, &error);
+
+    expect(document != NULL, "find", "the document could not be parsed");
+
+    if(document != NULL) {
+        JsonValue * root = json_document_getRoot(document);
+        JsonValue * b = json_value_find(root, "b");
+
+        expect(json_value_getLength(root) == 3, "find", "duplicated keys were not kept");
+        expect(json_value_getInteger(json_value_find(root, "a")) == 1, "find", "the first of duplicated keys was not found");
+        expect(b != NULL && strcmp(json_value_getString(json_value_find(b, "c")), "d") == 0, "find", "a nested key was not found");
+        expect(json_value_find(root, "missing") == NULL, "find", "a missing key was found");
+    }
+
+    json_tokenizer_destroy(tokenizer);
+
+    check_error(arena, "nothing", "", JSON_ERROR_EOF);
+    check_error(arena, "unclosed array", "[1,2", JSON_ERROR_EOF);
+    check_error(arena, "unclosed object", "{\"a\":1", JSON_ERROR_EOF);
+    check_error(arena, "trailing comma in array", "[1,]", JSON_ERROR_UNEXPECTED_TOKEN);
+    check_error(arena, "trailing comma in object", "{\"a\":1,}", JSON_ERROR_UNEXPECTED_TOKEN);
+    check_error(arena, "missing colon", "{\"a\" 1}", JSON_ERROR_UNEXPECTED_TOKEN);
+    check_error(arena, "number as key", "{1:2}", JSON_ERROR_UNEXPECTED_TOKEN);
+    check_error(arena, "mismatched end", "[1}", JSON_ERROR_UNEXPECTED_TOKEN);
+    check_error(arena, "mismatched empty end", "{]", JSON_ERROR_UNEXPECTED_TOKEN);
+    check_error(arena, "missing comma", "[1 2]", JSON_ERROR_UNEXPECTED_TOKEN);
+    check_error(arena, "bad literal", "[tru]", JSON_ERROR_EXPECTED_TRUE);
+
+    json_arena_destroy(arena);
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("document: all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,314 @@
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "check.h"
+
+/*
+ * Checks that an index seeks to the records and keys it was built for with each buffer type a file can be read
+ * with, in any order, and that a sidecar made for an older version of the file is rebuilt rather than used.
+ */
+
+#define HISTORY 4
+#define FILE_BUFFER 16
+#define RECORDS 200
+#define BUFFER_TYPES 4
+
+static char file[64];
+static char sidecar[80];
+
+/*
+ * Writes over the contents of the file, keeping its name so that its sidecar is found.
+ */
+static void rewrite_file(const char * contents) {
+    int descriptor = open(file, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    size_t size = strlen(contents);
+
+    if(descriptor == -1 || write(descriptor, contents, size) != (ssize_t) size || close(descriptor) == -1) {
+        fprintf(stderr, "Unable to write %s\n", file);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * Opens a tokenizer over the file with a fixed buffer, a mapped file, a buffered file or a file read ahead.
+ */
+static TokenizerHandle * open_tokenizer(int type, char ** contents) {
+    JsonError error;
+
+    *contents = NULL;
+
+    switch(type) {
+        case 0: {
+            FILE * stream = fopen(file, "rb");
+
+            fseek(stream, 0, SEEK_END);
+            long size = ftell(stream);
+            fseek(stream, 0, SEEK_SET);
+
+            *contents = malloc(size + 1);
+
+            if(fread(*contents, 1, size, stream) != (size_t) size) {
+                fprintf(stderr, "Unable to read %s\n", file);
+                exit(EXIT_FAILURE);
+            }
+
+            fclose(stream);
+
+            return json_tokenizer_create(json_bufferFixed_create(*contents, size, HISTORY, &error), &error);
+        }
+        case 1:
+            return json_tokenizer_openMappedFile(file, HISTORY, false, &error);
+        case 2:
+            return json_tokenizer_openFile(file, FILE_BUFFER, HISTORY, &error);
+        default:
+            return json_tokenizer_create(json_bufferedFile_openAhead(file, FILE_BUFFER, HISTORY, 2, &error), &error);
+    }
+}
+
+static const char * buffer_names[BUFFER_TYPES] = {"fixed", "mapped", "file", "read ahead"};
+
+/*
+ * Reads the value the tokenizer was moved to, giving the id member of an object or the value of an integer.
+ */
+static long int read_id(TokenizerHandle * tokenizer, JsonArena * arena) {
+    JsonError error;
+
+    json_arena_reset(arena);
+
+    JsonDocument * document = json_document_parse(tokenizer, arena, &error);
+
+    if(document == NULL)
+        return -1;
+
+    JsonValue * value = json_document_getRoot(document);
+
+    if(json_value_getType(value) == JSON_VALUE_OBJECT)
+        value = json_value_find(value, "id");
+
+    return (value != NULL && json_value_getType(value) == JSON_VALUE_INTEGER ? json_value_getInteger(value) : -1);
+}
+
+/*
+ * Opens the index of the file, checking that it has the number of records expected, and that seeking to
+ * each of the records given and reading it gives the ids expected with every buffer type.
+ */
+static void check_records(const char * name, const size_t * records, const long int * ids, int count, size_t expected) {
+    JsonError error;
+    JsonIndex * index = json_index_open(file, &error);
+
+    expect(index != NULL, name, "the index could not be opened");
+
+    if(index == NULL)
+        return;
+
+    expect(json_index_getRecordCount(index) == expected, name, "the index has another number of records");
+
+    JsonArena * arena = json_arena_create(0, &error);
+
+    for(int type = 0; type < BUFFER_TYPES; type++) {
+        char * contents;
+        TokenizerHandle * tokenizer = open_tokenizer(type, &contents);
+
+        for(int record = 0; record < count; record++) {
+            error = json_index_seekRecord(index, tokenizer, records[record]);
+
+            long int id = (error == JSON_SUCCESS ? read_id(tokenizer, arena) : -1);
+
+            if(id != ids[record]) {
+                expect(false, name, "seeking to a record read another value");
+                fprintf(stderr, "  %s buffer, record %zu: expected %ld, read %ld\n", buffer_names[type], records[record], ids[record], id);
+            }
+        }
+
+        expect(json_index_seekRecord(index, tokenizer, expected) == JSON_ERROR_NOT_FOUND, name, "a record past the end was found");
+
+        json_tokenizer_destroy(tokenizer);
+        free(contents);
+    }
+
+    json_arena_destroy(arena);
+    json_index_destroy(index);
+}
+
+/*
+ * Checks that seeking to each key gives the id expected with every buffer type, where an id of -1 is a key
+ * that is not in the top-level object.
+ */
+static void check_keys(const char * name, const char * const * keys, const long int * ids, int count) {
+    JsonError error;
+    JsonIndex * index = json_index_open(file, &error);
+
+    expect(index != NULL, name, "the index could not be opened");
+
+    if(index == NULL)
+        return;
+
+    JsonArena * arena = json_arena_create(0, &error);
+
+    for(int type = 0; type < BUFFER_TYPES; type++) {
+        char * contents;
+        TokenizerHandle * tokenizer = open_tokenizer(type, &contents);
+
+        for(int key = 0; key < count; key++) {
+            error = json_index_seekKey(index, tokenizer, keys[key]);
+
+            if(ids[key] < 0) {
+                expect(error == JSON_ERROR_NOT_FOUND, name, "a missing key was found");
+                continue;
+            }
+
+            long int id = (error == JSON_SUCCESS ? read_id(tokenizer, arena) : -1);
+
+            if(id != ids[key]) {
+                expect(false, name, "seeking to a key read another value");
+                fprintf(stderr, "  %s buffer, key %s: expected %ld, read %ld\n", buffer_names[type], keys[key], ids[key], id);
+            }
+        }
+
+        json_tokenizer_destroy(tokenizer);
+        free(contents);
+    }
+
+    json_arena_destroy(arena);
+    json_index_destroy(index);
+}
+
+/*
+ * Sets the modification time of the file, so that a sidecar made before can be told apart from the file
+ * even when the file was rewritten within the same tick of the clock with the same size.
+ */
+static void set_modified(time_t seconds) {
+    struct timespec times[2] = {{seconds, 0}, {seconds, 0}};
+
+    utimensat(AT_FDCWD, file, times, 0);
+}
+
+int main(int argc, char *argv[]) {
+    snprintf(file, sizeof(file), "%s", write_file("index", "", 0));
+    snprintf(sidecar, sizeof(sidecar), "%s.index", file);
+
+    // An array of records, each much larger than the buffer of the file, read back to front and in a scattered order.
+    size_t size = (size_t) RECORDS * 128;
+    char * records = malloc(size);
+    size_t length = 0;
+
+    length += sprintf(records + length, "[\n");
+
+    for(int record = 0; record < RECORDS; record++) {
+        length += sprintf(records + length, "  {\"id\": %d, \"name\": \"record %d\", \"tags\": [\"a\", \"]\"], \"nested\": {\"id\": -%d}}%s\n",
+                          record, record, record, (record < RECORDS - 1 ? "," : ""));
+    }
+
+    sprintf(records + length, "]\n");
+
+    rewrite_file(records);
+    free(records);
+    unlink(sidecar);
+
+    size_t order[RECORDS];
+    long int ids[RECORDS];
+
+    for(int record = 0; record < RECORDS; record++) {
+        order[record] = (size_t) ((record * 37) % RECORDS);
+        ids[record] = (long int) order[record];
+    }
+
+    check_records("array", order, ids, RECORDS, RECORDS);
+    expect(access(sidecar, F_OK) == 0, "array", "the sidecar was not written");
+
+    // Opened again, the sidecar is read instead of tokenizing the file.
+    for(int record = 0; record < RECORDS; record++) {
+        order[record] = (size_t) (RECORDS - 1 - record);
+        ids[record] = (long int) order[record];
+    }
+
+    check_records("sidecar", order, ids, RECORDS, RECORDS);
+
+    // Rewritten with the same size, so only the modification time tells that the sidecar is stale.
+    rewrite_file("[1, 22, 333]");
+    set_modified(1000000000);
+    unlink(sidecar);
+
+    size_t three[3] = {2, 0, 1};
+    long int before[3] = {333, 1, 22};
+    long int after[3] = {1, 333, 22};
+
+    check_records("before rewrite", three, before, 3, 3);
+
+    rewrite_file("[333, 22, 1]");
+    set_modified(1000000001);
+
+    check_records("stale sidecar", three, after, 3, 3);
+
+    // A sidecar that is not an index at all is rebuilt too.
+    int garbage = open(sidecar, O_WRONLY | O_TRUNC);
+
+    if(garbage != -1) {
+        expect(write(garbage, "JSONIDX1 but not really", 23) == 23, "garbage", "the sidecar could not be overwritten");
+        close(garbage);
+    }
+
+    check_records("garbage sidecar", three, after, 3, 3);
+
+    // Pushed input can only be seeked within what is still held, which is everything until more is pushed.
+    JsonError error;
+    JsonIndex * index = json_index_open(file, &error);
+    TokenizerHandle * tokenizer = json_tokenizer_createPush(FILE_BUFFER, HISTORY, &error);
+    json_tokenizer_feed(tokenizer, "[333, 22, 1]", 12);
+
+    expect(json_index_seekRecord(index, tokenizer, 1) == JSON_SUCCESS, "push", "a record that was pushed could not be seeked to");
+    expect(json_tokenizer_readNextToken(tokenizer) == JSON_TOKEN_NUMBER_INTEGER && json_tokenizer_getIntegerValue(tokenizer) == 22,
+           "push", "seeking to a record read another value");
+
+    json_tokenizer_feed(tokenizer, "\n", 1);
+
+    expect(json_index_seekRecord(index, tokenizer, 0) == JSON_ERROR_SEEK, "push", "input that was discarded was seeked to");
+
+    json_tokenizer_destroy(tokenizer);
+    json_index_destroy(index);
+
+    // Several top-level values, as in newline delimited JSON, are the records themselves.
+    rewrite_file("{\"id\": 10}\n{\"id\": 11, \"more\": [1, 2]}\n\n  {\"id\": 12}\n");
+    unlink(sidecar);
+
+    long int lines[3] = {12, 10, 11};
+    check_records("lines", three, lines, 3, 3);
+
+    rewrite_file("[]");
+    unlink(sidecar);
+    check_records("empty array", NULL, NULL, 0, 0);
+
+    rewrite_file("");
+    unlink(sidecar);
+    check_records("empty file", NULL, NULL, 0, 0);
+
+    // The members of a single top-level object are found by key, with the first of duplicated keys found.
+    rewrite_file("{\"first\": {\"id\": 1}, \"second\": 2, \"a\\\"b\": {\"id\": 3}, \"first\": 4, \"deep\": {\"second\": 5}}");
+    unlink(sidecar);
+
+    const char * keys[] = {"second", "a\"b", "first"};
+    long int members[] = {2, 3, 1};
+
+    check_keys("object", keys, members, 3);
+
+    const char * missing[] = {"missing", "id", "a\\\"b"};
+    long int absent[] = {-1, -1, -1};
+
+    check_keys("missing keys", missing, absent, 3);
+
+    // Keys are only found in a top-level object.
+    rewrite_file("[{\"first\": 1}]");
+    unlink(sidecar);
+    check_keys("array keys", keys, absent, 1);
+
+    unlink(sidecar);
+    unlink(file);
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("index: all checks passed\n");
+    return EXIT_SUCCESS;
+}
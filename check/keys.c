@@ -0,0 +1,139 @@
+#include "check.h"
+
+/*
+ * Checks that keys registered in a symbol table are found with their ids, that a key given twice is found with
+ * the id of its first position, that the empty key can be registered and found, and that strings shorter or
+ * longer than every key are not found without being hashed.
+ */
+
+#define HISTORY 4
+#define MANY_KEYS 300
+
+/*
+ * Checks that finding the key gives the id expected.
+ */
+static void check_find(const char * name, const JsonKeys * keys, const char * key, size_t length, int expected) {
+    int id = json_keys_find(keys, key, length);
+
+    if(id != expected) {
+        expect(false, name, "the key was found with another id");
+        fprintf(stderr, "  key: \"%.*s\"\n  expected: %d\n  actual:   %d\n", (key == NULL ? 0 : (int) length), (key == NULL ? "" : key), expected, id);
+    }
+}
+
+/*
+ * Checks the ids the tokenizer gives the keys of an object with the keys set on it.
+ */
+static void check_tokenized(const JsonKeys * keys, const char * input, const int * expected, int count) {
+    size_t size = strlen(input);
+    JsonError error;
+    int member = 0;
+
+    char * contents = malloc(size + 1);
+    memcpy(contents, input, size);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(contents, size, HISTORY, &error), &error);
+    json_tokenizer_setKeys(tokenizer, keys);
+
+    TokenType token;
+    TokenType previous = JSON_TOKEN_OBJECT_START;
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR) {
+        // Only strings straight after the start of the object or a comma are keys.
+        if(token == JSON_TOKEN_TEXT && (previous == JSON_TOKEN_OBJECT_START || previous == JSON_TOKEN_COMMA)) {
+            expect(member < count && json_tokenizer_getKeyId(tokenizer) == expected[member], "tokenized", "a key was read with another id");
+            member++;
+        }
+
+        previous = token;
+    }
+
+    expect(token == JSON_TOKEN_EOF && member == count, "tokenized", "the object was not read");
+
+    json_tokenizer_destroy(tokenizer);
+    free(contents);
+}
+
+int main(int argc, char *argv[]) {
+    const char * const names[] = {"id", "name", "", "id", "price", "name"};
+    JsonError error;
+
+    JsonKeys * keys = json_keys_create(names, 6, &error);
+
+    expect(keys != NULL && error == JSON_SUCCESS, "create", "the keys were not created");
+
+    check_find("first", keys, "id", 2, 0);
+    check_find("first", keys, "name", 4, 1);
+    check_find("first", keys, "price", 5, 4);
+
+    // A key given again is found with the id of its first position, so the later ids are never given.
+    check_find("duplicate", keys, "id", 2, 0);
+    check_find("duplicate", keys, "name", 4, 1);
+
+    check_find("empty", keys, "", 0, 2);
+    check_find("empty", keys, "name", 0, 2);
+
+    check_find("not registered", keys, "ix", 2, -1);
+    check_find("not registered", keys, "price", 4, -1);
+    check_find("not registered", keys, "named", 5, -1);
+
+    // Hashing a string longer than every key would read the characters, which are not there.
+    check_find("longer than every key", keys, NULL, 6, -1);
+    check_find("longer than every key", keys, NULL, SIZE_MAX, -1);
+
+    int expected[] = {0, 2, 1, 4, -1, 4};
+
+    check_tokenized(keys, "{\"id\": 1, \"\": [\"id\"], \"name\": {\"price\": 2}, \"other\": \"name\", \"price\": 3}", expected, 6);
+
+    json_keys_destroy(keys);
+
+    // With no empty key, the shortest key leaves out the strings shorter than it.
+    const char * const longer[] = {"alpha", "beta", "gamma"};
+
+    keys = json_keys_create(longer, 3, &error);
+
+    check_find("shorter than every key", keys, NULL, 0, -1);
+    check_find("shorter than every key", keys, NULL, 3, -1);
+    check_find("between", keys, "beta", 4, 1);
+    check_find("between", keys, "delta", 5, -1);
+
+    json_keys_destroy(keys);
+
+    // No key is found in a table without any.
+    keys = json_keys_create(NULL, 0, &error);
+
+    expect(keys != NULL && error == JSON_SUCCESS, "no keys", "the keys were not created");
+
+    check_find("no keys", keys, "", 0, -1);
+    check_find("no keys", keys, "id", 2, -1);
+
+    json_keys_destroy(keys);
+
+    // Enough keys that many share a slot and are found by probing past each other.
+    static char many[MANY_KEYS][16];
+    const char * manyNames[MANY_KEYS];
+
+    for(int id = 0; id < MANY_KEYS; id++) {
+        snprintf(many[id], sizeof(many[id]), "key%d", id);
+        manyNames[id] = many[id];
+    }
+
+    keys = json_keys_create(manyNames, MANY_KEYS, &error);
+
+    for(int id = 0; id < MANY_KEYS; id++) {
+        check_find("many", keys, many[id], strlen(many[id]), id);
+    }
+
+    check_find("many", keys, "key300", 6, -1);
+    check_find("many", keys, "kez1", 4, -1);
+
+    json_keys_destroy(keys);
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("keys: all checks passed\n");
+    return EXIT_SUCCESS;
+}
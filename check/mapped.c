@@ -0,0 +1,121 @@
+#include "check.h"
+
+/*
+ * Checks that mapped files are read the same as the same input in a fixed buffer, including empty files,
+ * files of whitespace only and files whose last value ends exactly at the end of the mapping.
+ */
+
+#define HISTORY 10
+#define DESCRIPTION 8192
+
+/*
+ * Describes every token read up to the end of the input or an error, with the value of strings and numbers.
+ */
+static void describe(TokenizerHandle * tokenizer, char * description) {
+    size_t length = 0;
+    TokenType token;
+
+    description[0] = '\0';
+
+    do {
+        token = json_tokenizer_readNextToken(tokenizer);
+
+        length += snprintf(description + length, DESCRIPTION - length, "%s", json_token_name(token));
+
+        if(token == JSON_TOKEN_TEXT)
+            length += snprintf(description + length, DESCRIPTION - length, "(%s)", json_tokenizer_getStringValue(tokenizer));
+        else if(token >= JSON_TOKEN_NUMBER_DECIMAL && token <= JSON_TOKEN_NUMBER_BIG_INTEGER)
+            length += snprintf(description + length, DESCRIPTION - length, "(%s)", json_tokenizer_getNumberValue(tokenizer));
+        else if(token == JSON_TOKEN_ERROR)
+            length += snprintf(description + length, DESCRIPTION - length, "(%s)", json_error_name(json_tokenizer_getError(tokenizer)));
+
+        length += snprintf(description + length, DESCRIPTION - length, " ");
+    } while(token != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR && length < DESCRIPTION - 1);
+}
+
+/*
+ * Reads the input from a mapped file and from a fixed buffer, and checks that both give the same tokens.
+ */
+static void check_input(const char * name, const char * input) {
+    size_t size = strlen(input);
+    char expected[DESCRIPTION];
+    char actual[DESCRIPTION];
+    JsonError error;
+
+    char * contents = malloc(size + 1);
+    memcpy(contents, input, size);
+
+    TokenizerHandle * fixed = json_tokenizer_create(json_bufferFixed_create(contents, size, HISTORY, &error), &error);
+    expect(error == JSON_SUCCESS, name, "the fixed buffer could not be created");
+
+    describe(fixed, expected);
+    json_tokenizer_destroy(fixed);
+    free(contents);
+
+    char * file = write_file("mapped", input, size);
+
+    TokenizerHandle * mapped = json_tokenizer_openMappedFile(file, HISTORY, false, &error);
+    unlink(file);
+
+    expect(error == JSON_SUCCESS, name, "the file could not be mapped");
+
+    if(mapped == NULL)
+        return;
+
+    describe(mapped, actual);
+    json_tokenizer_destroy(mapped);
+
+    if(strcmp(expected, actual) != 0) {
+        expect(false, name, "the mapped file was read differently");
+        fprintf(stderr, "  fixed:  %s\n  mapped: %s\n", expected, actual);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    check_input("empty", "");
+    check_input("whitespace", " \n\t\r ");
+    check_input("number at end", "12345");
+    check_input("literal at end", "true");
+    check_input("unterminated string", "\"abc");
+    check_input("document", "{\"a\": [1, 2.5, -3e2, \"x\\ny\", null, false], \"b\": {}}");
+
+    // A file of exactly one page, so the number at the end is right against the end of the mapping.
+    long page = sysconf(_SC_PAGESIZE);
+    char * input = malloc(page + 1);
+
+    memset(input, ' ', page);
+    input[page] = '\0';
+    input[0] = '[';
+    memcpy(input + page - 8, "1, 2, 3]", 8);
+
+    check_input("page sized", input);
+
+    memcpy(input + page - 8, "   12345", 8);
+    input[0] = ' ';
+
+    check_input("page sized number", input);
+    free(input);
+
+    // An empty file gives the end of the input straight away, and its offset stays at zero.
+    char * file = write_file("mapped", "", 0);
+    JsonError error;
+    TokenizerHandle * tokenizer = json_tokenizer_openMappedFile(file, HISTORY, true, &error);
+    unlink(file);
+
+    expect(error == JSON_SUCCESS && tokenizer != NULL, "empty", "the empty file could not be mapped with huge pages");
+
+    if(tokenizer != NULL) {
+        expect(json_tokenizer_readNextToken(tokenizer) == JSON_TOKEN_EOF, "empty", "an empty file did not end straight away");
+        expect(json_tokenizer_readNextToken(tokenizer) == JSON_TOKEN_EOF, "empty", "an empty file did not stay at its end");
+        expect(json_buffer_getOffset(json_tokenizer_getBuffer(tokenizer)) == 0, "empty", "an empty file moved its offset");
+        expect(json_tokenizer_destroy(tokenizer) == JSON_SUCCESS, "empty", "the empty file could not be unmapped");
+    }
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("mapped: all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+#include <pthread.h>
+
+#include "check.h"
+
+/*
+ * Checks that NDJSON input of more than one chunk is delivered whole, with blank lines skipped and lines
+ * ended by \r\n, and that a malformed line past the first chunk stops processing at that line, with every
+ * record before it delivered in order in ordered mode, for several numbers of threads.
+ */
+
+#define RECORDS 20000
+#define MINIMUM_SIZE (1 << 20)
+#define HISTORY 10
+
+/*
+ * The malformed line, and where processing fails on it, just past the brace that follows its last comma.
+ */
+#define BAD_LINE "{\"id\": -1, \"name\": \"bad\",}"
+#define BAD_COLUMN 26
+
+/*
+ * The generated input, with the offset of the line of each record.
+ */
+typedef struct Input Input;
+
+struct Input {
+    char * data;
+    size_t length;
+
+    size_t offsets[RECORDS];
+    int records;
+
+    // The offset of the malformed line, if there is one.
+    size_t badOffset;
+};
+
+/*
+ * The records delivered, in the order they were.
+ */
+typedef struct Delivered Delivered;
+
+struct Delivered {
+    pthread_mutex_t lock;
+
+    int ids[RECORDS];
+    size_t offsets[RECORDS];
+    int count;
+};
+
+/*
+ * Generates a record on each line, with a blank or whitespace line every so often and some lines ended by \r\n,
+ * putting the malformed line before the record given, unless it is -1.
+ */
+static void generate(Input * input, int badBefore) {
+    char line[256];
+    size_t size = (size_t) RECORDS * 128;
+
+    input->data = malloc(size);
+    input->length = 0;
+    input->records = 0;
+    input->badOffset = 0;
+
+    for(int record = 0; record < RECORDS; record++) {
+        if(record % 7 == 3) {
+            input->length += sprintf(input->data + input->length, (record % 2 ? "\n" : " \t \r\n"));
+        }
+
+        if(record == badBefore) {
+            input->badOffset = input->length;
+            input->length += sprintf(input->data + input->length, "%s\n", BAD_LINE);
+        }
+
+        snprintf(line, sizeof(line), "{\"id\": %d, \"name\": \"record %d\", \"values\": [%d.5, true, null, \"........................\"]}%s",
+                 record, record, record, (record % 5 == 0 ? "\r\n" : "\n"));
+
+        input->offsets[input->records++] = input->length;
+        input->length += sprintf(input->data + input->length, "%s", line);
+    }
+
+    // The last line is left without its new line.
+    input->length--;
+}
+
+static JsonError deliver(JsonValue * record, size_t offset, void * context) {
+    Delivered * delivered = (Delivered *) context;
+
+    pthread_mutex_lock(&delivered->lock);
+
+    if(delivered->count < RECORDS) {
+        delivered->ids[delivered->count] = (int) json_value_getInteger(json_value_find(record, "id"));
+        delivered->offsets[delivered->count] = offset;
+    }
+
+    delivered->count++;
+
+    pthread_mutex_unlock(&delivered->lock);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Processes the input, returning the error and setting where it occurred.
+ */
+static JsonError process(Input * input, int threads, bool ordered, Delivered * delivered, size_t * errorOffset) {
+    JsonError error;
+
+    delivered->count = 0;
+    *errorOffset = 0;
+
+    JsonBuffer * buffer = json_bufferFixed_create(input->data, input->length, HISTORY, &error);
+
+    error = json_ndjson_process(buffer, threads, ordered, deliver, delivered, errorOffset);
+
+    json_buffer_destroy(buffer);
+
+    return error;
+}
+
+/*
+ * Checks that the records delivered are the first count records of the input, in order.
+ */
+static bool delivered_inOrder(Input * input, Delivered * delivered, int count) {
+    if(delivered->count != count)
+        return false;
+
+    for(int record = 0; record < count; record++) {
+        if(delivered->ids[record] != record || delivered->offsets[record] != input->offsets[record])
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Checks that every record of the input was delivered exactly once, in any order.
+ */
+static bool delivered_once(Input * input, Delivered * delivered) {
+    static bool seen[RECORDS];
+
+    if(delivered->count != input->records)
+        return false;
+
+    memset(seen, 0, sizeof(seen));
+
+    for(int record = 0; record < delivered->count; record++) {
+        int id = delivered->ids[record];
+
+        if(id < 0 || id >= RECORDS || seen[id] || delivered->offsets[record] != input->offsets[id])
+            return false;
+
+        seen[id] = true;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    static Input input;
+    static Delivered delivered;
+    int threadCounts[] = {1, 2, 8};
+    char name[64];
+    size_t errorOffset;
+
+    pthread_mutex_init(&delivered.lock, NULL);
+
+    generate(&input, -1);
+
+    expect(input.length > MINIMUM_SIZE, "input", "the input does not span more than one chunk");
+
+    for(int index = 0; index < 3; index++) {
+        int threads = threadCounts[index];
+
+        snprintf(name, sizeof(name), "valid, ordered, %d threads", threads);
+        expect(process(&input, threads, true, &delivered, &errorOffset) == JSON_SUCCESS, name, "the input was not processed");
+        expect(delivered_inOrder(&input, &delivered, input.records), name, "the records were not delivered in order");
+
+        snprintf(name, sizeof(name), "valid, unordered, %d threads", threads);
+        expect(process(&input, threads, false, &delivered, &errorOffset) == JSON_SUCCESS, name, "the input was not processed");
+        expect(delivered_once(&input, &delivered), name, "not every record was delivered once");
+    }
+
+    free(input.data);
+
+    // The malformed line comes after more than a chunk of records.
+    int badBefore = RECORDS * 3 / 4;
+
+    generate(&input, badBefore);
+
+    expect(input.badOffset > MINIMUM_SIZE, "malformed", "the malformed line is in the first chunk");
+
+    for(int index = 0; index < 3; index++) {
+        int threads = threadCounts[index];
+
+        snprintf(name, sizeof(name), "malformed, ordered, %d threads", threads);
+        expect(process(&input, threads, true, &delivered, &errorOffset) == JSON_ERROR_UNEXPECTED_TOKEN, name, "the malformed line was not rejected");
+        expect(errorOffset == input.badOffset + BAD_COLUMN, name, "the error was not at the malformed line");
+        expect(delivered_inOrder(&input, &delivered, badBefore), name, "the records before the malformed line were not delivered in order");
+
+        snprintf(name, sizeof(name), "malformed, unordered, %d threads", threads);
+        expect(process(&input, threads, false, &delivered, &errorOffset) == JSON_ERROR_UNEXPECTED_TOKEN, name, "the malformed line was not rejected");
+        expect(errorOffset == input.badOffset + BAD_COLUMN, name, "the error was not at the malformed line");
+    }
+
+    free(input.data);
+    pthread_mutex_destroy(&delivered.lock);
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("ndjson: all checks passed\n");
+    return EXIT_SUCCESS;
+}
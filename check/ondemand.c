@@ -0,0 +1,227 @@
+#include "check.h"
+
+/*
+ * Checks that the on-demand parser finds members past nested objects and arrays it skips, leaves an object
+ * at its end when a key is not found, refuses to read values the cursor has moved past, and rejects trailing
+ * commas.
+ */
+
+#define HISTORY 4
+
+/*
+ * The input being read, and the tokenizer and parser reading it.
+ */
+typedef struct Reader Reader;
+
+struct Reader {
+    char * contents;
+    TokenizerHandle * tokenizer;
+    OndemandParser * parser;
+};
+
+/*
+ * Starts reading the input from a fixed buffer, setting root to its value.
+ */
+static void reader_open(Reader * reader, const char * input, OndemandValue * root) {
+    size_t size = strlen(input);
+    JsonError error;
+
+    reader->contents = malloc(size + 1);
+    memcpy(reader->contents, input, size);
+
+    reader->tokenizer = json_tokenizer_create(json_bufferFixed_create(reader->contents, size, HISTORY, &error), &error);
+    reader->parser = json_ondemand_create(reader->tokenizer, 0, &error);
+
+    json_ondemand_start(reader->parser, root);
+}
+
+static void reader_close(Reader * reader) {
+    json_ondemand_destroy(reader->parser);
+    json_tokenizer_destroy(reader->tokenizer);
+    free(reader->contents);
+}
+
+/*
+ * Checks that reading gave the error expected.
+ */
+static void expect_error(const char * name, JsonError error, JsonError expected) {
+    if(error != expected) {
+        expect(false, name, "the value was read with another result");
+        fprintf(stderr, "  expected: %s\n  actual:   %s\n", json_error_name(expected), json_error_name(error));
+    }
+}
+
+/*
+ * Checks that the value is the integer expected.
+ */
+static void expect_integer(const char * name, OndemandValue * value, long int expected) {
+    long int integer = 0;
+
+    expect_error(name, json_ondemand_getInteger(value, &integer), JSON_SUCCESS);
+    expect(integer == expected, name, "the integer was read as another value");
+}
+
+/*
+ * Finds a member past nested objects and arrays, including strings holding brackets, then the member after it.
+ */
+static void check_find(void) {
+    Reader reader;
+    OndemandValue root, value;
+    bool boolean = false;
+
+    reader_open(&reader, "{\"skip\": {\"x\": [1, {\"y\": \"}]\"}], \"z\": {}}, \"list\": [[1], [2, [3]]], \"want\": 42, \"after\": true}", &root);
+
+    expect_error("find", json_ondemand_find(&root, "want", &value), JSON_SUCCESS);
+    expect_integer("find", &value, 42);
+
+    expect_error("find next", json_ondemand_find(&root, "after", &value), JSON_SUCCESS);
+    expect_error("find next", json_ondemand_getBoolean(&value, &boolean), JSON_SUCCESS);
+    expect(boolean, "find next", "the boolean was read as another value");
+
+    reader_close(&reader);
+
+    // A member that was entered part way is skipped from where it was left.
+    reader_open(&reader, "{\"skip\": [[1, 2], {\"a\": [3]}], \"want\": 5}", &root);
+
+    OndemandValue element, inner;
+
+    expect_error("find after entering", json_ondemand_find(&root, "skip", &value), JSON_SUCCESS);
+    expect_error("find after entering", json_ondemand_nextElement(&value, &element), JSON_SUCCESS);
+    expect_error("find after entering", json_ondemand_nextElement(&element, &inner), JSON_SUCCESS);
+    expect_integer("find after entering", &inner, 1);
+
+    expect_error("find after entering", json_ondemand_find(&root, "want", &value), JSON_SUCCESS);
+    expect_integer("find after entering", &value, 5);
+
+    reader_close(&reader);
+}
+
+/*
+ * Looks for a key that is not in an object, after which the object is at its end and the array holding it
+ * carries on with its next element.
+ */
+static void check_notFound(void) {
+    Reader reader;
+    OndemandValue root, object, value, element;
+
+    reader_open(&reader, "[{\"a\": {\"b\": [1]}, \"c\": 2}, 7]", &root);
+
+    expect_error("not found", json_ondemand_nextElement(&root, &object), JSON_SUCCESS);
+    expect_error("not found", json_ondemand_find(&object, "missing", &value), JSON_ERROR_NOT_FOUND);
+    expect_error("not found again", json_ondemand_find(&object, "a", &value), JSON_ERROR_NOT_FOUND);
+
+    expect_error("not found", json_ondemand_nextElement(&root, &element), JSON_SUCCESS);
+    expect_integer("not found", &element, 7);
+    expect_error("not found", json_ondemand_nextElement(&root, &element), JSON_ERROR_EOF);
+
+    reader_close(&reader);
+}
+
+/*
+ * Reads values after the cursor has moved past them.
+ */
+static void check_outOfOrder(void) {
+    Reader reader;
+    OndemandValue root, first, second, inner;
+    long int integer;
+
+    // A scalar handed out before the one after it was found.
+    reader_open(&reader, "{\"a\": 1, \"b\": 2}", &root);
+
+    expect_error("scalar passed", json_ondemand_find(&root, "a", &first), JSON_SUCCESS);
+    expect_error("scalar passed", json_ondemand_find(&root, "b", &second), JSON_SUCCESS);
+    expect_integer("scalar passed", &second, 2);
+    expect_error("scalar passed", json_ondemand_getInteger(&first, &integer), JSON_ERROR_OUT_OF_ORDER);
+
+    reader_close(&reader);
+
+    // An object that was entered, then skipped over when its parent moved on.
+    reader_open(&reader, "{\"o\": {\"x\": 1}, \"p\": 2}", &root);
+
+    JsonValueType type;
+
+    expect_error("object passed", json_ondemand_find(&root, "o", &first), JSON_SUCCESS);
+    expect_error("object passed", json_ondemand_getType(&first, &type), JSON_SUCCESS);
+    expect_error("object passed", json_ondemand_find(&root, "p", &second), JSON_SUCCESS);
+    expect_error("object passed", json_ondemand_find(&first, "x", &inner), JSON_ERROR_OUT_OF_ORDER);
+
+    reader_close(&reader);
+
+    // An object that was never entered before the cursor moved past it.
+    reader_open(&reader, "{\"o\": {\"x\": 1}, \"p\": 2}", &root);
+
+    expect_error("object skipped", json_ondemand_find(&root, "o", &first), JSON_SUCCESS);
+    expect_error("object skipped", json_ondemand_find(&root, "p", &second), JSON_SUCCESS);
+    expect_error("object skipped", json_ondemand_find(&first, "x", &inner), JSON_ERROR_OUT_OF_ORDER);
+
+    reader_close(&reader);
+}
+
+/*
+ * Moves past the last member or element to a trailing comma.
+ */
+static void check_trailingComma(void) {
+    Reader reader;
+    OndemandValue root, value;
+
+    reader_open(&reader, "{\"a\": 1, }", &root);
+
+    expect_error("trailing comma in object", json_ondemand_find(&root, "a", &value), JSON_SUCCESS);
+    expect_error("trailing comma in object", json_ondemand_find(&root, "b", &value), JSON_ERROR_UNEXPECTED_TOKEN);
+
+    reader_close(&reader);
+
+    reader_open(&reader, "[1, ]", &root);
+
+    expect_error("trailing comma in array", json_ondemand_nextElement(&root, &value), JSON_SUCCESS);
+    expect_error("trailing comma in array", json_ondemand_nextElement(&root, &value), JSON_ERROR_UNEXPECTED_TOKEN);
+
+    reader_close(&reader);
+
+    reader_open(&reader, "[1, 2,]", &root);
+
+    expect_error("trailing comma after read", json_ondemand_nextElement(&root, &value), JSON_SUCCESS);
+    expect_integer("trailing comma after read", &value, 1);
+    expect_error("trailing comma after read", json_ondemand_nextElement(&root, &value), JSON_SUCCESS);
+    expect_integer("trailing comma after read", &value, 2);
+    expect_error("trailing comma after read", json_ondemand_nextElement(&root, &value), JSON_ERROR_UNEXPECTED_TOKEN);
+
+    reader_close(&reader);
+}
+
+/*
+ * Reads numbers too large for a long int as doubles.
+ */
+static void check_decimal(void) {
+    Reader reader;
+    OndemandValue root, value;
+    double decimal = 0;
+
+    reader_open(&reader, "[123456789012345678901234567890, 1.5e300]", &root);
+
+    expect_error("big integer", json_ondemand_nextElement(&root, &value), JSON_SUCCESS);
+    expect_error("big integer", json_ondemand_getDecimal(&value, &decimal), JSON_SUCCESS);
+    expect(decimal == 123456789012345678901234567890.0, "big integer", "the number was read as another value");
+
+    expect_error("decimal", json_ondemand_nextElement(&root, &value), JSON_SUCCESS);
+    expect_error("decimal", json_ondemand_getDecimal(&value, &decimal), JSON_SUCCESS);
+    expect(decimal == 1.5e300, "decimal", "the number was read as another value");
+
+    reader_close(&reader);
+}
+
+int main(int argc, char *argv[]) {
+    check_find();
+    check_notFound();
+    check_outOfOrder();
+    check_trailingComma();
+    check_decimal();
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("ondemand: all checks passed\n");
+    return EXIT_SUCCESS;
+}
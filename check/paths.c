@@ -0,0 +1,197 @@
+#include "check.h"
+
+/*
+ * Checks that compiled paths extract the values expected from a fixed buffer, and exactly the same values
+ * when the input is pushed split in two at every character and one character at a time, so that extraction
+ * and skipping are both cut part way through every token and carried on.
+ */
+
+#define HISTORY 4
+#define PUSH_BUFFER 2
+#define DESCRIPTION 4096
+
+/*
+ * The values extracted, each as the path that matched it and its first token.
+ */
+typedef struct Extracted Extracted;
+
+struct Extracted {
+    char description[DESCRIPTION];
+    size_t length;
+};
+
+static JsonError describe_value(int path, TokenType token, TokenizerHandle * tokenizer, void * context) {
+    Extracted * extracted = (Extracted *) context;
+    size_t remaining = DESCRIPTION - extracted->length;
+    char * end = extracted->description + extracted->length;
+
+    if(token == JSON_TOKEN_TEXT)
+        extracted->length += snprintf(end, remaining, "%d:\"%s\" ", path, json_tokenizer_getStringValue(tokenizer));
+    else if(token >= JSON_TOKEN_NUMBER_DECIMAL && token <= JSON_TOKEN_NUMBER_BIG_INTEGER)
+        extracted->length += snprintf(end, remaining, "%d:%s ", path, json_tokenizer_getNumberValue(tokenizer));
+    else
+        extracted->length += snprintf(end, remaining, "%d:%s ", path, json_token_name(token));
+
+    return (extracted->length < DESCRIPTION - 1 ? JSON_SUCCESS : JSON_ERROR_ABORTED);
+}
+
+/*
+ * Extracts the paths from the input in a fixed buffer, appending the error to what was extracted.
+ */
+static void extract_fixed(const JsonPaths * paths, const char * input, Extracted * extracted) {
+    size_t size = strlen(input);
+    JsonError error;
+
+    extracted->length = 0;
+    extracted->description[0] = '\0';
+
+    char * contents = malloc(size + 1);
+    memcpy(contents, input, size);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(contents, size, HISTORY, &error), &error);
+    PathExtractor * extractor = json_pathExtractor_create(paths, describe_value, extracted, &error);
+
+    error = json_pathExtractor_extract(extractor, tokenizer);
+
+    snprintf(extracted->description + extracted->length, DESCRIPTION - extracted->length, "%s", json_error_name(error));
+
+    json_pathExtractor_destroy(extractor);
+    json_tokenizer_destroy(tokenizer);
+    free(contents);
+}
+
+/*
+ * Extracts the paths from the input pushed in chunks of the sizes given, which add up to its length, carrying
+ * on each time more input was needed, and appending the error to what was extracted.
+ */
+static void extract_pushed(const JsonPaths * paths, const char * input, const size_t * chunks, int count, Extracted * extracted) {
+    size_t pushed = 0;
+    JsonError error;
+
+    extracted->length = 0;
+    extracted->description[0] = '\0';
+
+    TokenizerHandle * tokenizer = json_tokenizer_createPush(PUSH_BUFFER, HISTORY, &error);
+    PathExtractor * extractor = json_pathExtractor_create(paths, describe_value, extracted, &error);
+
+    error = JSON_ERROR_NEED_MORE;
+
+    for(int chunk = 0; chunk < count && error == JSON_ERROR_NEED_MORE; chunk++) {
+        json_tokenizer_feed(tokenizer, input + pushed, chunks[chunk]);
+        pushed += chunks[chunk];
+
+        error = json_pathExtractor_extract(extractor, tokenizer);
+    }
+
+    if(error == JSON_ERROR_NEED_MORE) {
+        json_tokenizer_finish(tokenizer);
+
+        error = json_pathExtractor_extract(extractor, tokenizer);
+    }
+
+    snprintf(extracted->description + extracted->length, DESCRIPTION - extracted->length, "%s", json_error_name(error));
+
+    json_pathExtractor_destroy(extractor);
+    json_tokenizer_destroy(tokenizer);
+}
+
+/*
+ * Checks that the paths extract what is expected from the input in a fixed buffer, and the same when it is pushed.
+ */
+static void check_input(const char * name, const JsonPaths * paths, const char * input, const char * expected) {
+    static Extracted fixed;
+    static Extracted pushed;
+
+    size_t size = strlen(input);
+
+    extract_fixed(paths, input, &fixed);
+
+    if(strcmp(fixed.description, expected) != 0) {
+        expect(false, name, "the fixed buffer extracted other values");
+        fprintf(stderr, "  expected: %s\n  actual:   %s\n", expected, fixed.description);
+    }
+
+    for(size_t split = 0; split <= size; split++) {
+        size_t chunks[2] = {split, size - split};
+
+        extract_pushed(paths, input, chunks, 2, &pushed);
+
+        if(strcmp(fixed.description, pushed.description) != 0) {
+            expect(false, name, "input split in two extracted other values");
+            fprintf(stderr, "  split at %zu\n  fixed: %s\n  push:  %s\n", split, fixed.description, pushed.description);
+        }
+    }
+
+    size_t * chunks = malloc((size + 1) * sizeof(size_t));
+
+    for(size_t chunk = 0; chunk < size; chunk++)
+        chunks[chunk] = 1;
+
+    extract_pushed(paths, input, chunks, (int) size, &pushed);
+    free(chunks);
+
+    if(strcmp(fixed.description, pushed.description) != 0) {
+        expect(false, name, "input pushed a character at a time extracted other values");
+        fprintf(stderr, "  fixed: %s\n  push:  %s\n", fixed.description, pushed.description);
+    }
+}
+
+/*
+ * Compiles the pointers, which are all valid.
+ */
+static JsonPaths * compile(const char * const * pointers, int count) {
+    JsonError error;
+    JsonPaths * paths = json_paths_compile(pointers, count, &error);
+
+    if(paths == NULL) {
+        json_error_logReason(error);
+        exit(EXIT_FAILURE);
+    }
+
+    return paths;
+}
+
+int main(int argc, char *argv[]) {
+    const char * pointers[] = {"/id", "/user/name", "/items/*/price", "/items/1", "/a~1b", "/m~0n", "/user/name"};
+    JsonPaths * paths = compile(pointers, 7);
+
+    check_input("paths", paths,
+                "{\"id\": 7, \"skipped\": {\"deep\": [1, \"]}\", {\"x\": \"\\\"\"}]}, \"user\": {\"name\": \"Ann\\u00e9\", \"age\": 30},"
+                " \"items\": [{\"price\": 1.5, \"sku\": \"a\"}, {\"price\": 20}, {\"sku\": \"c\"}],"
+                " \"a/b\": true, \"m~n\": null, \"tail\": [[], {}, \"x\"]}",
+                "0:7 6:\"Ann\xc3\xa9\" 1:\"Ann\xc3\xa9\" 2:1.5 3:Object start 2:20 4:True 5:Null Success");
+
+    check_input("objects for indices", paths, "{\"other\": {\"id\": 1}, \"items\": {\"1\": 5}}", "3:5 Success");
+    check_input("scalar root", paths, "  \"text\" ", "Success");
+    check_input("missing colon", paths, "{\"skipped\": [1, 2], \"id\" 3}", "Unexpected token");
+    check_input("malformed extracted value", paths, "{\"id\": tru}", json_error_name(JSON_ERROR_EXPECTED_TRUE));
+    check_input("unfinished", paths, "{\"id\": 1, \"user\": {", "0:1 End of file");
+
+    json_paths_destroy(paths);
+
+    const char * whole[] = {"", "/0/*"};
+    paths = compile(whole, 2);
+
+    check_input("whole value", paths, "[[1, \"two\"], [3]]", "0:Array start 1:1 1:\"two\" Success");
+
+    json_paths_destroy(paths);
+
+    JsonError error;
+    const char * invalid[] = {"id"};
+
+    expect(json_paths_compile(invalid, 1, &error) == NULL && error == JSON_ERROR_INVALID_POINTER, "invalid",
+           "a pointer without a leading / was compiled");
+
+    invalid[0] = "/a~2";
+
+    expect(json_paths_compile(invalid, 1, &error) == NULL && error == JSON_ERROR_INVALID_POINTER, "invalid",
+           "a pointer with a bad escape was compiled");
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("paths: all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+#include "check.h"
+#include "../src/tokenizer_internal.h"
+
+/*
+ * Checks that the tokenizer pool only keeps tokenizers it handed out that still read from a fixed buffer made
+ * with the default allocator, so that it never holds on to memory the caller frees, and that a tokenizer it
+ * keeps is handed out again with the value buffer it grew.
+ */
+
+#define HISTORY 10
+#define FIXED_MEMORY (64 * 1024)
+
+/*
+ * Reads the string that is the whole of the input, returning where its value is held.
+ */
+static const char * read_string(TokenizerHandle * tokenizer, const char * name, const char * expected) {
+    expect(json_tokenizer_readNextToken(tokenizer) == JSON_TOKEN_TEXT, name, "the string was not read");
+
+    const char * value = json_tokenizer_getStringValue(tokenizer);
+
+    expect(value != NULL && strcmp(value, expected) == 0, name, "the string was read as another value");
+
+    return value;
+}
+
+/*
+ * Gets whether the tokenizer lies in the memory of a fixed allocator.
+ */
+static bool is_within(TokenizerHandle * tokenizer, const char * memory) {
+    return (const char *) tokenizer >= memory && (const char *) tokenizer < memory + FIXED_MEMORY;
+}
+
+int main(int argc, char *argv[]) {
+    static char memory[FIXED_MEMORY];
+    char first[] = "\"a string long enough to grow the value buffer of the tokenizer \\n past its first size\"";
+    char second[] = "\"another string \\t read by the tokenizer once it was taken back\"";
+    char third[] = "\"\\u00e9\"";
+    JsonError error;
+
+    // A tokenizer handed out again keeps its value buffer.
+    TokenizerHandle * tokenizer = json_tokenizerPool_acquire(first, strlen(first), HISTORY, &error);
+
+    expect(tokenizer != NULL && error == JSON_SUCCESS, "acquire", "no tokenizer was handed out");
+    expect(json_tokenizer_isPooled(tokenizer), "acquire", "a tokenizer made by the pool is not marked as pooled");
+
+    const char * value = read_string(tokenizer, "acquire", "a string long enough to grow the value buffer of the tokenizer \n past its first size");
+
+    expect(json_tokenizerPool_release(tokenizer) == JSON_SUCCESS, "release", "the tokenizer could not be released");
+
+    TokenizerHandle * again = json_tokenizerPool_acquire(second, strlen(second), HISTORY, &error);
+
+    expect(again == tokenizer && error == JSON_SUCCESS, "reuse", "the released tokenizer was not handed out again");
+    expect(read_string(again, "reuse", "another string \t read by the tokenizer once it was taken back") == value, "reuse",
+           "the value buffer was not reused");
+
+    json_tokenizerPool_release(again);
+    json_tokenizerPool_clear();
+
+    // A tokenizer whose buffer uses memory the caller owns is destroyed, rather than kept past that memory.
+    JsonAllocator allocator = json_allocator_createFixed(memory, FIXED_MEMORY);
+    JsonBuffer * buffer = json_bufferFixed_createWith(third, strlen(third), HISTORY, &allocator, &error);
+    tokenizer = json_tokenizer_create(buffer, &error);
+
+    expect(tokenizer != NULL && is_within(tokenizer, memory), "fixed allocator", "the tokenizer was not made in the fixed memory");
+
+    read_string(tokenizer, "fixed allocator", "\xc3\xa9");
+
+    expect(json_tokenizerPool_release(tokenizer) == JSON_SUCCESS, "fixed allocator", "the tokenizer could not be destroyed");
+
+    again = json_tokenizerPool_acquire(third, strlen(third), HISTORY, &error);
+
+    expect(again != NULL && !is_within(again, memory), "fixed allocator", "a tokenizer in the fixed memory was pooled");
+
+    // The same goes for a tokenizer from the pool that was given a buffer using memory the caller owns.
+    allocator = json_allocator_createFixed(memory, FIXED_MEMORY);
+    buffer = json_bufferFixed_createWith(first, strlen(first), HISTORY, &allocator, &error);
+
+    expect(json_tokenizer_reset(again, buffer) == JSON_SUCCESS, "reset", "the tokenizer could not be given the buffer");
+    expect(json_tokenizerPool_release(again) == JSON_SUCCESS, "reset", "the tokenizer could not be destroyed");
+
+    tokenizer = json_tokenizerPool_acquire(third, strlen(third), HISTORY, &error);
+
+    expect(json_tokenizer_getBuffer(tokenizer) != buffer, "reset", "a tokenizer reading from a buffer in the fixed memory was pooled");
+
+    json_tokenizerPool_release(tokenizer);
+    json_tokenizerPool_clear();
+
+    // A tokenizer with the default allocator that the pool did not hand out is destroyed, so the next one is made by the pool.
+    buffer = json_bufferFixed_create(third, strlen(third), HISTORY, &error);
+    tokenizer = json_tokenizer_create(buffer, &error);
+
+    expect(!json_tokenizer_isPooled(tokenizer), "not acquired", "a tokenizer the pool did not make is marked as pooled");
+    expect(json_tokenizerPool_release(tokenizer) == JSON_SUCCESS, "not acquired", "the tokenizer could not be destroyed");
+
+    tokenizer = json_tokenizerPool_acquire(second, strlen(second), HISTORY, &error);
+
+    expect(json_tokenizer_isPooled(tokenizer), "not acquired", "a tokenizer the pool did not make was pooled");
+
+    json_tokenizerPool_release(tokenizer);
+    json_tokenizerPool_clear();
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("pool: all checks passed\n");
+    return EXIT_SUCCESS;
+}
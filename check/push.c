@@ -0,0 +1,143 @@
+#include "check.h"
+
+/*
+ * Checks that input pushed in chunks is read the same as the whole input in a fixed buffer, wherever the
+ * input is split, so that every token is cut at every one of its characters, and when it is pushed one
+ * character at a time into a buffer that has to grow.
+ */
+
+#define HISTORY 4
+#define PUSH_BUFFER 2
+#define DESCRIPTION 4096
+
+/*
+ * Describes the tokens read until more input is needed, the input ends or there is an error, with the value
+ * of strings and numbers, returning the last token read.
+ */
+static TokenType describe(TokenizerHandle * tokenizer, char * description, size_t * length) {
+    TokenType token;
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_NEED_MORE) {
+        *length += snprintf(description + *length, DESCRIPTION - *length, "%s", json_token_name(token));
+
+        if(token == JSON_TOKEN_TEXT)
+            *length += snprintf(description + *length, DESCRIPTION - *length, "(%s)", json_tokenizer_getStringValue(tokenizer));
+        else if(token >= JSON_TOKEN_NUMBER_DECIMAL && token <= JSON_TOKEN_NUMBER_BIG_INTEGER)
+            *length += snprintf(description + *length, DESCRIPTION - *length, "(%s)", json_tokenizer_getNumberValue(tokenizer));
+        else if(token == JSON_TOKEN_ERROR)
+            *length += snprintf(description + *length, DESCRIPTION - *length, "(%s)", json_error_name(json_tokenizer_getError(tokenizer)));
+
+        *length += snprintf(description + *length, DESCRIPTION - *length, " ");
+
+        if(token == JSON_TOKEN_EOF || token == JSON_TOKEN_ERROR || *length >= DESCRIPTION - 1)
+            break;
+    }
+
+    return token;
+}
+
+/*
+ * Pushes the input in chunks of the sizes given, which add up to its length, describing every token read.
+ */
+static void push_chunks(const char * name, const char * input, const size_t * chunks, int count, char * description) {
+    size_t length = 0;
+    size_t pushed = 0;
+    JsonError error;
+
+    description[0] = '\0';
+
+    TokenizerHandle * tokenizer = json_tokenizer_createPush(PUSH_BUFFER, HISTORY, &error);
+    expect(error == JSON_SUCCESS, name, "the push tokenizer could not be created");
+
+    if(tokenizer == NULL)
+        return;
+
+    TokenType token = JSON_TOKEN_NEED_MORE;
+
+    for(int chunk = 0; chunk < count && token == JSON_TOKEN_NEED_MORE; chunk++) {
+        expect(json_tokenizer_feed(tokenizer, input + pushed, chunks[chunk]) == JSON_SUCCESS, name, "a chunk could not be pushed");
+        pushed += chunks[chunk];
+
+        token = describe(tokenizer, description, &length);
+    }
+
+    if(token == JSON_TOKEN_NEED_MORE) {
+        expect(json_tokenizer_finish(tokenizer) == JSON_SUCCESS, name, "the input could not be finished");
+
+        token = describe(tokenizer, description, &length);
+        expect(token != JSON_TOKEN_NEED_MORE, name, "more input was needed after the input was finished");
+    }
+
+    json_tokenizer_destroy(tokenizer);
+}
+
+/*
+ * Reads the input from a fixed buffer, then pushes it split in two at each of its characters, and one
+ * character at a time, checking that the tokens are the same each time.
+ */
+static void check_input(const char * name, const char * input) {
+    size_t size = strlen(input);
+    char expected[DESCRIPTION];
+    char actual[DESCRIPTION];
+    size_t length = 0;
+    JsonError error;
+
+    expected[0] = '\0';
+
+    char * contents = malloc(size + 1);
+    memcpy(contents, input, size);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(contents, size, HISTORY, &error), &error);
+    expect(error == JSON_SUCCESS, name, "the fixed buffer could not be created");
+
+    describe(tokenizer, expected, &length);
+    json_tokenizer_destroy(tokenizer);
+    free(contents);
+
+    for(size_t split = 0; split <= size; split++) {
+        size_t chunks[2] = {split, size - split};
+
+        push_chunks(name, input, chunks, 2, actual);
+
+        if(strcmp(expected, actual) != 0) {
+            expect(false, name, "input split in two was read differently");
+            fprintf(stderr, "  split at %zu\n  fixed: %s\n  push:  %s\n", split, expected, actual);
+        }
+    }
+
+    size_t * chunks = malloc((size + 1) * sizeof(size_t));
+
+    for(size_t chunk = 0; chunk < size; chunk++)
+        chunks[chunk] = 1;
+
+    push_chunks(name, input, chunks, (int) size, actual);
+    free(chunks);
+
+    if(strcmp(expected, actual) != 0) {
+        expect(false, name, "input pushed a character at a time was read differently");
+        fprintf(stderr, "  fixed: %s\n  push:  %s\n", expected, actual);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    check_input("empty", "");
+    check_input("literals", "[true, false, null]");
+    check_input("numbers", "[0, -12, 3.25, -0.5e-3, 6E+2, 123456789012345678901234567890, 1.5e999]");
+    check_input("strings", "{\"plain\": \"abc\", \"escaped\": \"a\\\"b\\\\c\\n\", \"unicode\": \"\\u00e9\\ud83d\\ude00\"}");
+    check_input("long string", "\"a string that is longer than the history and the starting size of the buffer\"");
+    check_input("number at end", "  -1234.5e6");
+    check_input("nested", "{\"a\":[{\"b\":[]},{}],\"c\":{\"d\":[1,[2,[3]]]}}\n");
+
+    check_input("bad literal", "[true, fals]");
+    check_input("bad number", "[1.]");
+    check_input("bad escape", "\"a\\qb\"");
+    check_input("unterminated string", "[\"abc");
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("push: all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,194 @@
+#include <stdarg.h>
+
+#include "check.h"
+
+/*
+ * Checks that the sax parser calls the handlers with the events of a value in order, rejects tokens out of
+ * place and containers nested past the depth limit, and gives the same events and errors when the input is
+ * pushed to it a character at a time.
+ */
+
+#define HISTORY 4
+#define PUSH_BUFFER 2
+#define DESCRIPTION 1024
+
+/*
+ * The events written so far.
+ */
+typedef struct Events Events;
+
+struct Events {
+    char text[DESCRIPTION];
+    size_t length;
+};
+
+/*
+ * Appends an event, separated from the one before it by a space.
+ */
+static JsonError append_event(Events * events, const char * format, ...) {
+    va_list arguments;
+
+    if(events->length > 0)
+        events->length += snprintf(events->text + events->length, DESCRIPTION - events->length, " ");
+
+    va_start(arguments, format);
+    events->length += vsnprintf(events->text + events->length, DESCRIPTION - events->length, format, arguments);
+    va_end(arguments);
+
+    return JSON_SUCCESS;
+}
+
+static JsonError on_startObject(void * context) {
+    return append_event(context, "{");
+}
+
+static JsonError on_endObject(void * context) {
+    return append_event(context, "}");
+}
+
+static JsonError on_startArray(void * context) {
+    return append_event(context, "[");
+}
+
+static JsonError on_endArray(void * context) {
+    return append_event(context, "]");
+}
+
+static JsonError on_key(const char * key, size_t length, void * context) {
+    return append_event(context, "key:%.*s", (int) length, key);
+}
+
+static JsonError on_string(const char * value, size_t length, void * context) {
+    return append_event(context, "string:%.*s", (int) length, value);
+}
+
+static JsonError on_integer(long int value, void * context) {
+    return append_event(context, "integer:%ld", value);
+}
+
+static JsonError on_decimal(double value, void * context) {
+    return append_event(context, "decimal:%g", value);
+}
+
+static JsonError on_number(const char * number, size_t length, void * context) {
+    return append_event(context, "number:%.*s", (int) length, number);
+}
+
+static JsonError on_boolean(bool value, void * context) {
+    return append_event(context, (value ? "true" : "false"));
+}
+
+static JsonError on_null(void * context) {
+    return append_event(context, "null");
+}
+
+static const JsonHandlers handlers = {
+    .onStartObject = on_startObject, .onEndObject = on_endObject,
+    .onStartArray = on_startArray, .onEndArray = on_endArray,
+    .onKey = on_key, .onString = on_string, .onNumber = on_number,
+    .onInteger = on_integer, .onDecimal = on_decimal,
+    .onBoolean = on_boolean, .onNull = on_null
+};
+
+/*
+ * Parses the input from a fixed buffer, writing the events and then the error parsing ended with.
+ */
+static void parse_fixed(const char * input, int maxDepth, Events * events) {
+    size_t size = strlen(input);
+    JsonError error;
+
+    events->length = 0;
+    events->text[0] = '\0';
+
+    char * contents = malloc(size + 1);
+    memcpy(contents, input, size);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(contents, size, HISTORY, &error), &error);
+    SaxParser * parser = json_sax_create(&handlers, events, maxDepth, &error);
+
+    append_event(events, "%s", json_error_name(json_sax_parse(parser, tokenizer)));
+
+    json_sax_destroy(parser);
+    json_tokenizer_destroy(tokenizer);
+    free(contents);
+}
+
+/*
+ * Parses the input pushed a character at a time, pushing the next character each time the parser needs more
+ * and finishing the input once all of it was pushed.
+ */
+static void parse_pushed(const char * input, int maxDepth, Events * events) {
+    size_t size = strlen(input);
+    size_t pushed = 0;
+    JsonError error;
+
+    events->length = 0;
+    events->text[0] = '\0';
+
+    TokenizerHandle * tokenizer = json_tokenizer_createPush(PUSH_BUFFER, HISTORY, &error);
+    SaxParser * parser = json_sax_create(&handlers, events, maxDepth, &error);
+
+    while((error = json_sax_parse(parser, tokenizer)) == JSON_ERROR_NEED_MORE) {
+        if(pushed < size)
+            json_tokenizer_feed(tokenizer, &input[pushed++], 1);
+        else
+            json_tokenizer_finish(tokenizer);
+    }
+
+    append_event(events, "%s", json_error_name(error));
+
+    json_sax_destroy(parser);
+    json_tokenizer_destroy(tokenizer);
+}
+
+/*
+ * Checks that parsing the input gives the events expected followed by the error expected, whether the input is
+ * in a fixed buffer or pushed.
+ */
+static void check_input(const char * name, const char * input, int maxDepth, const char * expected) {
+    Events events;
+
+    parse_fixed(input, maxDepth, &events);
+
+    if(strcmp(events.text, expected) != 0) {
+        expect(false, name, "parsing from a fixed buffer gave other events");
+        fprintf(stderr, "  expected: %s\n  actual:   %s\n", expected, events.text);
+    }
+
+    parse_pushed(input, maxDepth, &events);
+
+    if(strcmp(events.text, expected) != 0) {
+        expect(false, name, "parsing input pushed a character at a time gave other events");
+        fprintf(stderr, "  expected: %s\n  actual:   %s\n", expected, events.text);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    check_input("every value", " {\"a\": [1, -2.5, \"x\\ny\", true, false, null, {}], \"big\": 123456789012345678901234567890} ", 0,
+                "{ key:a [ integer:1 decimal:-2.5 string:x\ny true false null { } ] key:big number:123456789012345678901234567890 } Success");
+    check_input("scalar", "-12", 0, "integer:-12 Success");
+    check_input("rest left unread", "[] [", 0, "[ ] Success");
+
+    check_input("tokens out of place", "}:,[", 0, "Unexpected token");
+    check_input("trailing comma in array", "[1,]", 0, "[ integer:1 Unexpected token");
+    check_input("key without value", "{\"a\"}", 0, "{ key:a Unexpected token");
+    check_input("trailing comma in object", "{\"a\":1,}", 0, "{ key:a integer:1 Unexpected token");
+    check_input("value as key", "{1:2}", 0, "{ Unexpected token");
+    check_input("missing comma", "[1 2]", 0, "[ integer:1 Unexpected token");
+    check_input("unfinished", "[1,", 0, "[ integer:1 End of file");
+    check_input("tokenizer error", "[tru]", 0, "[ Expected true");
+
+    // Containers may be nested exactly maxDepth deep, and the one that would nest them deeper is not started.
+    check_input("at max depth", "[{\"a\":[]}]", 3, "[ { key:a [ ] } ] Success");
+    check_input("past max depth", "[{\"a\":[[]]}]", 3, "[ { key:a [ Nested too deeply");
+    check_input("at max depth of 1", "[]", 1, "[ ] Success");
+    check_input("past max depth of 1", "[{}]", 1, "[ Nested too deeply");
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("sax: all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,190 @@
+#include "check.h"
+
+/*
+ * Checks that json_tokenizer_skipValue ends a value where reading it with json_tokenizer_readNextToken does, and
+ * fails on the same malformed scalars with the same errors, from a fixed buffer with both engines and from input
+ * pushed split in two at every character, so that numbers and literals are cut part way through.
+ */
+
+#define HISTORY 4
+#define PUSH_BUFFER 2
+#define DESCRIPTION 1024
+
+/*
+ * How far a value has been read, kept while pushed input runs out part way through it.
+ */
+typedef struct Reading Reading;
+
+struct Reading {
+    bool skip;
+    int depth;
+};
+
+/*
+ * Reads the next value, either by skipping it or by reading its tokens until it is closed, returning
+ * JSON_ERROR_NEED_MORE when the pushed input runs out part way through it.
+ */
+static JsonError read_value(TokenizerHandle * tokenizer, Reading * reading) {
+    if(reading->skip)
+        return json_tokenizer_skipValue(tokenizer);
+
+    do {
+        TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+        switch(token) {
+            case JSON_TOKEN_NEED_MORE:
+                return JSON_ERROR_NEED_MORE;
+            case JSON_TOKEN_EOF:
+                return JSON_ERROR_EOF;
+            case JSON_TOKEN_ERROR:
+                return json_tokenizer_getError(tokenizer);
+            case JSON_TOKEN_OBJECT_START:
+            case JSON_TOKEN_ARRAY_START:
+                reading->depth++;
+                break;
+            case JSON_TOKEN_OBJECT_END:
+            case JSON_TOKEN_ARRAY_END:
+                reading->depth--;
+                break;
+            default:
+                break;
+        }
+    } while(reading->depth > 0);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Appends the error the value was read with, and when it was read, the names of the tokens after it, finishing
+ * pushed input once all of it was read.
+ */
+static void describe_rest(TokenizerHandle * tokenizer, JsonError error, char * description) {
+    size_t length = strlen(description);
+
+    length += snprintf(description + length, DESCRIPTION - length, "%s", json_error_name(error));
+
+    if(error != JSON_SUCCESS)
+        return;
+
+    TokenType token;
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR) {
+        if(token == JSON_TOKEN_NEED_MORE)
+            json_tokenizer_finish(tokenizer);
+        else
+            length += snprintf(description + length, DESCRIPTION - length, " %s", json_token_name(token));
+    }
+
+    if(token == JSON_TOKEN_ERROR)
+        snprintf(description + length, DESCRIPTION - length, " %s", json_error_name(json_tokenizer_getError(tokenizer)));
+    else
+        snprintf(description + length, DESCRIPTION - length, " %s", json_token_name(token));
+}
+
+/*
+ * Reads the first value of the input from a fixed buffer, with the engine given.
+ */
+static void read_fixed(const char * input, bool skip, TokenizerEngine engine, char * description) {
+    size_t size = strlen(input);
+    Reading reading = {skip, 0};
+    JsonError error;
+
+    description[0] = '\0';
+
+    char * contents = malloc(size + 1);
+    memcpy(contents, input, size);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(contents, size, HISTORY, &error), &error);
+    json_tokenizer_setEngine(tokenizer, engine);
+
+    describe_rest(tokenizer, read_value(tokenizer, &reading), description);
+
+    json_tokenizer_destroy(tokenizer);
+    free(contents);
+}
+
+/*
+ * Reads the first value of the input pushed in two chunks, the first of split characters, carrying on each time
+ * more input was needed.
+ */
+static void read_pushed(const char * input, size_t split, bool skip, char * description) {
+    size_t size = strlen(input);
+    Reading reading = {skip, 0};
+    JsonError error;
+
+    description[0] = '\0';
+
+    TokenizerHandle * tokenizer = json_tokenizer_createPush(PUSH_BUFFER, HISTORY, &error);
+    json_tokenizer_feed(tokenizer, input, split);
+
+    bool fed = false;
+
+    while((error = read_value(tokenizer, &reading)) == JSON_ERROR_NEED_MORE) {
+        if(!fed) {
+            json_tokenizer_feed(tokenizer, input + split, size - split);
+            fed = true;
+        } else {
+            json_tokenizer_finish(tokenizer);
+        }
+    }
+
+    // The value may end in the first chunk, leaving the tokens after it in the second.
+    if(!fed)
+        json_tokenizer_feed(tokenizer, input + split, size - split);
+
+    describe_rest(tokenizer, error, description);
+
+    json_tokenizer_destroy(tokenizer);
+}
+
+/*
+ * Checks that reading the first value and skipping it give what is expected, in every way the input can be given.
+ */
+static void check_input(const char * name, const char * input, const char * expected) {
+    char actual[DESCRIPTION];
+    size_t size = strlen(input);
+
+    for(int skip = 0; skip < 2; skip++) {
+        for(int engine = 0; engine < 2; engine++) {
+            read_fixed(input, skip, (engine == 0 ? JSON_ENGINE_STREAMING : JSON_ENGINE_INDEXED), actual);
+
+            if(strcmp(actual, expected) != 0) {
+                expect(false, name, (skip ? "skipping from a fixed buffer gave another result" : "reading from a fixed buffer gave another result"));
+                fprintf(stderr, "  %s engine\n  expected: %s\n  actual:   %s\n", (engine == 0 ? "streaming" : "indexed"), expected, actual);
+            }
+        }
+
+        for(size_t split = 0; split <= size; split++) {
+            read_pushed(input, split, skip, actual);
+
+            if(strcmp(actual, expected) != 0) {
+                expect(false, name, (skip ? "skipping pushed input gave another result" : "reading pushed input gave another result"));
+                fprintf(stderr, "  split at %zu\n  expected: %s\n  actual:   %s\n", split, expected, actual);
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    check_input("literal", "true ]", "Success Array end End of file");
+    check_input("number", "-12.5e3,1", "Success Comma Integer number End of file");
+    check_input("string", "\"a\\\"b\" 1", "Success Integer number End of file");
+    check_input("array", "[1, [\"]\"], {}] null", "Success Null End of file");
+
+    // A literal or number is ended by any character that cannot carry it on, which is then read as the next token.
+    check_input("literal run on", "truex", "Success Unexpected character");
+    check_input("number run on", "-12x3", "Success Unexpected character");
+    check_input("leading zero", "01", json_error_name(JSON_ERROR_UNNECESSARY_ZERO));
+    check_input("fraction at end", "1.", json_error_name(JSON_ERROR_EOF));
+    check_input("fraction", "1.]", json_error_name(JSON_ERROR_EXPECTED_DIGIT));
+    check_input("unterminated string", "\"abc", json_error_name(JSON_ERROR_EOF));
+    check_input("unterminated array", "[1,2", json_error_name(JSON_ERROR_EOF));
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("skip: all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+#include "check.h"
+
+/*
+ * Checks that the slices of strings and numbers hold the same characters as their null terminated values,
+ * for fixed and mapped buffers, which slice the input, and for files read a few characters at a time,
+ * which copy into the value buffer. Slices of the input have to stay valid after later tokens are read.
+ */
+
+#define HISTORY 1
+#define FILE_BUFFER 4
+#define VALUES 4096
+
+/*
+ * Reads every token, joining the strings and numbers with | from their slices, and checking each slice
+ * against the null terminated value.
+ *
+ * When the input is given, slices that point into it are kept and checked again once all tokens are read.
+ */
+static void read_values(TokenizerHandle * tokenizer, const char * name, const char * input, size_t size, char * values) {
+    const char * kept[64];
+    size_t keptLength[64];
+    char keptCopy[64][64];
+    int keptCount = 0;
+    int sliced = 0;
+
+    size_t length = 0;
+    TokenType token;
+
+    values[0] = '\0';
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF) {
+        if(token == JSON_TOKEN_ERROR) {
+            expect(false, name, json_error_name(json_tokenizer_getError(tokenizer)));
+            return;
+        }
+
+        const char * slice;
+        size_t sliceLength;
+
+        if(token == JSON_TOKEN_TEXT)
+            json_tokenizer_getStringSlice(tokenizer, &slice, &sliceLength);
+        else if(token >= JSON_TOKEN_NUMBER_DECIMAL && token <= JSON_TOKEN_NUMBER_BIG_INTEGER)
+            json_tokenizer_getNumberSlice(tokenizer, &slice, &sliceLength);
+        else
+            continue;
+
+        if(input != NULL && slice >= input && slice + sliceLength <= input + size) {
+            sliced++;
+
+            if(keptCount < 64 && sliceLength < 64) {
+                kept[keptCount] = slice;
+                keptLength[keptCount] = sliceLength;
+                memcpy(keptCopy[keptCount], slice, sliceLength);
+                keptCount++;
+            }
+        }
+
+        length += snprintf(values + length, VALUES - length, "%s%.*s", (length > 0 ? "|" : ""), (int) sliceLength, slice);
+
+        char * value = (token == JSON_TOKEN_TEXT ? json_tokenizer_getStringValue(tokenizer) : json_tokenizer_getNumberValue(tokenizer));
+
+        expect(value != NULL && strlen(value) == sliceLength && memcmp(value, slice, sliceLength) == 0, name,
+               "a slice differs from its value");
+    }
+
+    expect(input == NULL || sliced > 0, name, "no value was sliced from the input");
+
+    for(int index = 0; index < keptCount; index++) {
+        expect(memcmp(kept[index], keptCopy[index], keptLength[index]) == 0, name, "a slice of the input changed");
+    }
+}
+
+/*
+ * Reads the input from each buffer type and checks that the values are the ones expected.
+ */
+static void check_input(const char * name, const char * input, const char * expected) {
+    size_t size = strlen(input);
+    char values[VALUES];
+    JsonError error;
+
+    // Copied without the null terminator, so nothing relies on it.
+    char * contents = malloc(size + 1);
+    memcpy(contents, input, size);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(contents, size, HISTORY, &error), &error);
+    expect(error == JSON_SUCCESS, name, "the fixed buffer could not be created");
+
+    read_values(tokenizer, name, contents, size, values);
+    json_tokenizer_destroy(tokenizer);
+    free(contents);
+
+    if(strcmp(values, expected) != 0) {
+        expect(false, name, "the fixed buffer gave other values");
+        fprintf(stderr, "  expected: %s\n  actual:   %s\n", expected, values);
+    }
+
+    char * file = write_file("slices", input, size);
+
+    tokenizer = json_tokenizer_openMappedFile(file, HISTORY, false, &error);
+    expect(error == JSON_SUCCESS, name, "the file could not be mapped");
+
+    read_values(tokenizer, name, NULL, 0, values);
+    json_tokenizer_destroy(tokenizer);
+
+    if(strcmp(values, expected) != 0) {
+        expect(false, name, "the mapped file gave other values");
+        fprintf(stderr, "  expected: %s\n  actual:   %s\n", expected, values);
+    }
+
+    tokenizer = json_tokenizer_openFile(file, FILE_BUFFER, HISTORY, &error);
+    unlink(file);
+
+    expect(error == JSON_SUCCESS, name, "the file could not be opened");
+
+    read_values(tokenizer, name, NULL, 0, values);
+    json_tokenizer_destroy(tokenizer);
+
+    if(strcmp(values, expected) != 0) {
+        expect(false, name, "the buffered file gave other values");
+        fprintf(stderr, "  expected: %s\n  actual:   %s\n", expected, values);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    check_input("strings", "[\"abc\", \"\", \"a\\\"b\", \"tab\\there\", \"\\u00e9t\\u00e9\", \"\\ud83d\\ude00\"]",
+                "abc||a\"b|tab\there|\xc3\xa9t\xc3\xa9|\xf0\x9f\x98\x80");
+
+    check_input("numbers", "[0, -0, 7, -12, 0.5, -3.25, 1e5, 1E5, 2e-3, 12.5E+2, 123456789012345678901234567890]",
+                "0|-0|7|-12|0.5|-3.25|1e5|1E5|2e-3|12.5E+2|123456789012345678901234567890");
+
+    check_input("keys", "{\"first\":1,\"second\":{\"third\":\"x\"},\"fourth\":[2.5]}",
+                "first|1|second|third|x|fourth|2.5");
+
+    check_input("long string", "\"a string that is much longer than the buffer of the file, so it is read in many parts\"",
+                "a string that is much longer than the buffer of the file, so it is read in many parts");
+
+    check_input("value at end", "123", "123");
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("slices: all checks passed\n");
+    return EXIT_SUCCESS;
+}
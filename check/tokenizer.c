@@ -0,0 +1,341 @@
+#include "check.h"
+
+/*
+ * Checks that the corpora of the tokenizer benchmarks are read as the same tokens with the same values by every
+ * buffer setup the benchmarks time, by mapped files and pushed input, and by both engines, so that a faster
+ * run in the benchmarks is never one that read something else.
+ */
+
+#define CORPUS_SIZE (64 * 1024)
+#define NESTED_DEPTH 64
+#define PUSH_CHUNK 1000
+
+/*
+ * A growable string, used for the corpora and for the tokens read from them.
+ */
+typedef struct Output Output;
+
+struct Output {
+    char * data;
+    size_t length;
+    size_t size;
+};
+
+/*
+ * A kind of input in the corpus, generated into input and written to path for the file buffers.
+ */
+typedef struct Corpus Corpus;
+
+struct Corpus {
+    const char * name;
+    void (*generate)(Output * output, size_t size);
+    Output input;
+    char path[64];
+};
+
+/*
+ * How the corpus is read, where a bufferSize of 0 is a fixed buffer over all of the input, and a file buffer
+ * with blocks reads that many blocks ahead instead of reading when it is filled.
+ */
+typedef struct Setup Setup;
+
+struct Setup {
+    const char * name;
+    int bufferSize;
+    int history;
+    int blocks;
+    bool mapped;
+    bool pushed;
+    TokenizerEngine engine;
+};
+
+static void output_appendLength(Output * output, const char * text, size_t length) {
+    while(output->length + length + 1 > output->size) {
+        output->size = (output->size > 0 ? output->size * 2 : 4096);
+        output->data = realloc(output->data, output->size);
+
+        if(output->data == NULL) {
+            fprintf(stderr, "Unable to allocate the output\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    memcpy(&output->data[output->length], text, length);
+    output->length += length;
+    output->data[output->length] = '\0';
+}
+
+static void output_append(Output * output, const char * text) {
+    output_appendLength(output, text, strlen(text));
+}
+
+/*
+ * An array of integers, decimals and exponents of varying lengths.
+ */
+static void generate_numbers(Output * output, size_t size) {
+    char text[128];
+
+    output_append(output, "[");
+
+    for(int index = 0; output->length < size; index++) {
+        snprintf(text, sizeof(text), "%s%d,%d.%03d,-%de-%d,%ld", (index > 0 ? "," : ""),
+                 index, index % 1000, index % 997, index % 89, index % 300, (long int) index * 2654435761L);
+        output_append(output, text);
+    }
+
+    output_append(output, "]");
+}
+
+/*
+ * An array of plain strings of varying lengths, some of them not ASCII.
+ */
+static void generate_strings(Output * output, size_t size) {
+    static const char * words[] = {"alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "gr\xc3\xbcn", "h\xc3\xb4tel"};
+
+    output_append(output, "[");
+
+    for(int index = 0; output->length < size; index++) {
+        output_append(output, (index > 0 ? ",\"" : "\""));
+
+        for(int word = 0; word <= index % 12; word++) {
+            output_append(output, words[(index + word) % 8]);
+            output_append(output, " ");
+        }
+
+        output_append(output, "\"");
+    }
+
+    output_append(output, "]");
+}
+
+/*
+ * Arrays and objects nested NESTED_DEPTH deep, repeated until the size is reached.
+ */
+static void generate_nested(Output * output, size_t size) {
+    output_append(output, "[");
+
+    for(int index = 0; output->length < size; index++) {
+        output_append(output, (index > 0 ? "," : ""));
+
+        for(int depth = 0; depth < NESTED_DEPTH; depth++) {
+            output_append(output, (depth % 2 == 0 ? "{\"a\":" : "["));
+        }
+
+        output_append(output, "1");
+
+        for(int depth = NESTED_DEPTH - 1; depth >= 0; depth--) {
+            output_append(output, (depth % 2 == 0 ? "}" : "]"));
+        }
+    }
+
+    output_append(output, "]");
+}
+
+/*
+ * Records laid out with new lines and indentation, so that much of the input is whitespace.
+ */
+static void generate_pretty(Output * output, size_t size) {
+    char text[512];
+
+    output_append(output, "[\n");
+
+    for(int index = 0; output->length < size; index++) {
+        snprintf(text, sizeof(text),
+                 "%s    {\n        \"id\": %d,\n        \"name\": \"record %d\",\n        \"tags\": [\n"
+                 "            \"a\",\n            \"b\"\n        ],\n        \"active\": %s,\n        \"parent\": null\n    }",
+                 (index > 0 ? ",\n" : ""), index, index, (index % 2 == 0 ? "true" : "false"));
+        output_append(output, text);
+    }
+
+    output_append(output, "\n]\n");
+}
+
+/*
+ * Strings full of escapes, including unicode escapes and surrogate pairs.
+ */
+static void generate_escapes(Output * output, size_t size) {
+    output_append(output, "[");
+
+    for(int index = 0; output->length < size; index++) {
+        output_append(output, (index > 0 ? "," : ""));
+        output_append(output, "\"line\\none\\ttab \\\"quoted\\\" back\\\\slash \\u00e9t\\u00e9 \\ud83d\\ude00 \\/\\b\\f\\r\"");
+    }
+
+    output_append(output, "]");
+}
+
+/*
+ * Newline delimited records, read as a stream of top level values.
+ */
+static void generate_ndjson(Output * output, size_t size) {
+    char text[256];
+
+    for(int index = 0; output->length < size; index++) {
+        snprintf(text, sizeof(text),
+                 "{\"id\":%d,\"user\":\"user%d\",\"score\":%d.5,\"tags\":[\"x\",\"y\",\"z\"],\"ok\":true,\"ref\":null}\n",
+                 index, index % 1000, index % 100);
+        output_append(output, text);
+    }
+}
+
+/*
+ * Appends the token to the tokens read, with the value of strings and numbers.
+ */
+static void describe(TokenizerHandle * tokenizer, TokenType token, Output * tokens) {
+    char text[32];
+    const char * value;
+    size_t length;
+
+    snprintf(text, sizeof(text), "%d", (int) token);
+    output_append(tokens, text);
+
+    if(token == JSON_TOKEN_TEXT) {
+        json_tokenizer_getStringSlice(tokenizer, &value, &length);
+    } else if(token >= JSON_TOKEN_NUMBER_DECIMAL && token <= JSON_TOKEN_NUMBER_BIG_INTEGER) {
+        json_tokenizer_getNumberSlice(tokenizer, &value, &length);
+    } else if(token == JSON_TOKEN_ERROR) {
+        value = json_error_name(json_tokenizer_getError(tokenizer));
+        length = strlen(value);
+    } else {
+        length = 0;
+    }
+
+    if(length > 0) {
+        output_append(tokens, ":");
+        output_appendLength(tokens, value, length);
+    }
+
+    output_append(tokens, "\n");
+}
+
+/*
+ * Reads every token of the corpus with the setup, describing each of them, and returns the last token read.
+ */
+static TokenType tokenize(Corpus * corpus, Setup * setup, Output * tokens) {
+    JsonError error;
+    TokenizerHandle * tokenizer;
+
+    tokens->length = 0;
+
+    if(setup->pushed) {
+        tokenizer = json_tokenizer_createPush(setup->bufferSize, setup->history, &error);
+    } else if(setup->mapped) {
+        tokenizer = json_tokenizer_openMappedFile(corpus->path, setup->history, false, &error);
+    } else if(setup->bufferSize == 0) {
+        tokenizer = json_tokenizer_create(json_bufferFixed_create(corpus->input.data, corpus->input.length, setup->history, &error), &error);
+    } else if(setup->blocks == 0) {
+        tokenizer = json_tokenizer_openFile(corpus->path, setup->bufferSize, setup->history, &error);
+    } else {
+        tokenizer = json_tokenizer_create(json_bufferedFile_openAhead(corpus->path, setup->bufferSize, setup->history, setup->blocks, &error), &error);
+    }
+
+    if(tokenizer == NULL) {
+        expect(false, setup->name, json_error_name(error));
+        return JSON_TOKEN_ERROR;
+    }
+
+    expect(json_tokenizer_setEngine(tokenizer, setup->engine) == JSON_SUCCESS, setup->name, "the engine could not be set");
+
+    size_t pushed = 0;
+    TokenType token;
+
+    do {
+        token = json_tokenizer_readNextToken(tokenizer);
+
+        if(token == JSON_TOKEN_NEED_MORE) {
+            size_t chunk = (corpus->input.length - pushed < PUSH_CHUNK ? corpus->input.length - pushed : PUSH_CHUNK);
+
+            if(chunk > 0) {
+                json_tokenizer_feed(tokenizer, corpus->input.data + pushed, chunk);
+                pushed += chunk;
+            } else {
+                json_tokenizer_finish(tokenizer);
+            }
+
+            continue;
+        }
+
+        describe(tokenizer, token, tokens);
+    } while(token != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR);
+
+    json_tokenizer_destroy(tokenizer);
+
+    return token;
+}
+
+/*
+ * Finds the line of the first token that differs, for the failure message.
+ */
+static size_t first_difference(Output * expected, Output * actual) {
+    size_t line = 1;
+
+    for(size_t index = 0; index < expected->length && index < actual->length && expected->data[index] == actual->data[index]; index++) {
+        line += (expected->data[index] == '\n');
+    }
+
+    return line;
+}
+
+int main(int argc, char *argv[]) {
+    Corpus corpora[] = {
+        {"numbers", generate_numbers},
+        {"strings", generate_strings},
+        {"nested", generate_nested},
+        {"pretty", generate_pretty},
+        {"escapes", generate_escapes},
+        {"ndjson", generate_ndjson}
+    };
+
+    // The setups of the benchmarks with smaller buffers, so that the corpora take many fills, and buffers smaller than a token.
+    Setup setups[] = {
+        {"fixed", 0, 10, 0, false, false, JSON_ENGINE_STREAMING},
+        {"fixed indexed", 0, 10, 0, false, false, JSON_ENGINE_INDEXED},
+        {"mapped", 0, 10, 0, true, false, JSON_ENGINE_STREAMING},
+        {"mapped indexed", 0, 10, 0, true, false, JSON_ENGINE_INDEXED},
+        {"file 16", 16, 1, 0, false, false, JSON_ENGINE_STREAMING},
+        {"file 4096", 4096, 10, 0, false, false, JSON_ENGINE_STREAMING},
+        {"file 4096 history 1024", 4096, 1024, 0, false, false, JSON_ENGINE_STREAMING},
+        {"read ahead 2 blocks", 4096, 10, 2, false, false, JSON_ENGINE_STREAMING},
+        {"read ahead 4 blocks", 1024, 10, 4, false, false, JSON_ENGINE_STREAMING},
+        {"pushed", 64, 10, 0, false, true, JSON_ENGINE_STREAMING}
+    };
+
+    int corpusCount = sizeof(corpora) / sizeof(Corpus);
+    int setupCount = sizeof(setups) / sizeof(Setup);
+
+    Output expected = {0};
+    Output actual = {0};
+
+    for(int corpusIndex = 0; corpusIndex < corpusCount; corpusIndex++) {
+        Corpus * corpus = &corpora[corpusIndex];
+
+        corpus->generate(&corpus->input, CORPUS_SIZE);
+
+        snprintf(corpus->path, sizeof(corpus->path), "%s", write_file("tokenizer", corpus->input.data, corpus->input.length));
+
+        expect(tokenize(corpus, &setups[0], &expected) == JSON_TOKEN_EOF, corpus->name, "the corpus could not be read");
+
+        for(int setupIndex = 1; setupIndex < setupCount; setupIndex++) {
+            tokenize(corpus, &setups[setupIndex], &actual);
+
+            if(actual.length != expected.length || memcmp(actual.data, expected.data, expected.length) != 0) {
+                expect(false, corpus->name, "a setup read other tokens than the fixed buffer");
+                fprintf(stderr, "  %s, from token %zu\n", setups[setupIndex].name, first_difference(&expected, &actual));
+            }
+        }
+
+        unlink(corpus->path);
+        free(corpus->input.data);
+    }
+
+    free(expected.data);
+    free(actual.data);
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("tokenizer: all checks passed\n");
+    return EXIT_SUCCESS;
+}
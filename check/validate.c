@@ -0,0 +1,168 @@
+#include "check.h"
+
+/*
+ * Checks that json_validate gives the error expected at the offset expected, for escapes, UTF-8 and tokens
+ * out of place, with the input in a fixed buffer, in a file read a few characters at a time and pushed in two
+ * chunks split at every character, and with multibyte sequences at every position across the blocks the
+ * SIMD search looks at.
+ */
+
+#define HISTORY 4
+#define FILE_BUFFER 8
+#define PUSH_BUFFER 2
+#define LONGEST_PADDING 140
+
+/*
+ * Validates the input in a fixed buffer, setting the offset of the error.
+ */
+static JsonError validate_fixed(const char * input, size_t size, size_t * offset) {
+    JsonError error;
+
+    char * contents = malloc(size + 1);
+    memcpy(contents, input, size);
+
+    JsonBuffer * buffer = json_bufferFixed_create(contents, size, HISTORY, &error);
+
+    error = json_validate(buffer, offset);
+
+    json_buffer_destroy(buffer);
+    free(contents);
+
+    return error;
+}
+
+/*
+ * Validates the input read from a file through a buffer of a few characters, larger than the history as it must be.
+ */
+static JsonError validate_file(const char * input, size_t size, size_t * offset) {
+    JsonError error;
+
+    char * file = write_file("validate", input, size);
+    JsonBuffer * buffer = json_bufferedFile_open(file, FILE_BUFFER, HISTORY, &error);
+
+    error = json_validate(buffer, offset);
+
+    json_buffer_destroy(buffer);
+    unlink(file);
+
+    return error;
+}
+
+/*
+ * Validates the input pushed in two chunks, the first of split characters.
+ */
+static JsonError validate_pushed(const char * input, size_t size, size_t split, size_t * offset) {
+    JsonError error;
+
+    JsonBuffer * buffer = json_bufferPush_create(PUSH_BUFFER, HISTORY, &error);
+
+    json_bufferPush_append(buffer, input, split);
+    json_bufferPush_append(buffer, input + split, size - split);
+    json_bufferPush_finish(buffer);
+
+    error = json_validate(buffer, offset);
+
+    json_buffer_destroy(buffer);
+
+    return error;
+}
+
+/*
+ * Checks that the error and, for invalid input, its offset are the ones expected.
+ */
+static void check_result(const char * name, const char * mode, JsonError error, size_t offset, JsonError expected, size_t expectedOffset) {
+    if(error != expected || (expected != JSON_SUCCESS && offset != expectedOffset)) {
+        expect(false, name, "the input was validated with another result");
+        fprintf(stderr, "  %s\n  expected: %s at %zu\n  actual:   %s at %zu\n", mode, json_error_name(expected), expectedOffset,
+                json_error_name(error), offset);
+    }
+}
+
+/*
+ * Checks that the input of the size given is validated with the error expected at the offset expected, in every
+ * buffer it can be read from.
+ */
+static void check_sized(const char * name, const char * input, size_t size, JsonError expected, size_t expectedOffset) {
+    size_t offset = 0;
+    char mode[32];
+
+    JsonError error = validate_fixed(input, size, &offset);
+    check_result(name, "fixed", error, offset, expected, expectedOffset);
+
+    error = validate_file(input, size, &offset);
+    check_result(name, "file", error, offset, expected, expectedOffset);
+
+    for(size_t split = 0; split <= size; split++) {
+        error = validate_pushed(input, size, split, &offset);
+
+        snprintf(mode, sizeof(mode), "pushed, split at %zu", split);
+        check_result(name, mode, error, offset, expected, expectedOffset);
+    }
+}
+
+static void check_input(const char * name, const char * input, JsonError expected, size_t expectedOffset) {
+    check_sized(name, input, strlen(input), expected, expectedOffset);
+}
+
+/*
+ * Checks a string holding the sequence after every number of plain characters up to LONGEST_PADDING, so that
+ * the sequence starts at every position within the blocks of the SIMD search and straddles each boundary.
+ */
+static void check_padded(const char * name, const char * sequence, JsonError expected) {
+    char input[LONGEST_PADDING + 16];
+
+    for(int padding = 0; padding <= LONGEST_PADDING; padding++) {
+        int length = snprintf(input, sizeof(input), "\"%.*s%sz\"", padding,
+                              "................................................................................................"
+                              "................................................................................................",
+                              sequence);
+
+        check_sized(name, input, (size_t) length, expected, (size_t) padding + 1);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    check_input("valid", " {\"a\": [1, -2.5e3, true, false, null, \"\\u00e9\\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\"], \"b\": {}} ", JSON_SUCCESS, 0);
+
+    check_input("bad escape", "[\"ab\\qc\"]", JSON_ERROR_INVALID_ESCAPE, 5);
+    check_input("bad unicode escape", "\"\\u12g4\"", JSON_ERROR_INVALID_UNICODE_ESCAPED_CHAR, 5);
+    check_input("short unicode escape", "\"\\u12\"", JSON_ERROR_INVALID_UNICODE_ESCAPED_CHAR, 5);
+    check_input("control character", "\"a\tb\"", JSON_ERROR_ILLEGAL_TEXT_CHAR, 2);
+
+    // Escaped surrogates that are not part of a pair are accepted, as the tokenizer keeps them as they are.
+    check_input("surrogate pair", "\"\\ud83d\\ude00\"", JSON_SUCCESS, 0);
+    check_input("lone high surrogate", "\"\\ud83d\"", JSON_SUCCESS, 0);
+    check_input("lone low surrogate", "\"\\ude00x\"", JSON_SUCCESS, 0);
+    check_input("misordered surrogates", "\"\\ude00\\ud83d\"", JSON_SUCCESS, 0);
+
+    check_input("overlong 2 bytes", "\"\xc0\xaf\"", JSON_ERROR_INVALID_UTF8, 1);
+    check_input("overlong 3 bytes", "[\"ab\xe0\x80\xaf\"]", JSON_ERROR_INVALID_UTF8, 4);
+    check_input("overlong 4 bytes", "\"\xf0\x80\x80\xaf\"", JSON_ERROR_INVALID_UTF8, 1);
+    check_input("encoded surrogate", "\"x\xed\xa0\x80\"", JSON_ERROR_INVALID_UTF8, 2);
+    check_input("above U+10FFFF", "\"\xf4\x90\x80\x80\"", JSON_ERROR_INVALID_UTF8, 1);
+    check_input("lead above U+10FFFF", "\"\xf5\x80\x80\x80\"", JSON_ERROR_INVALID_UTF8, 1);
+    check_input("continuation without lead", "\"\x80\"", JSON_ERROR_INVALID_UTF8, 1);
+    check_input("truncated", "\"\xe2\x82\"", JSON_ERROR_INVALID_UTF8, 1);
+    check_input("truncated at end", "\"\xe2\x82", JSON_ERROR_EOF, 3);
+
+    check_padded("straddling 4 bytes", "\xf0\x9f\x98\x80", JSON_SUCCESS);
+    check_padded("straddling 3 bytes", "\xe2\x82\xac", JSON_SUCCESS);
+    check_padded("straddling bad continuation", "\xf0\x9f\x98(", JSON_ERROR_INVALID_UTF8);
+    check_padded("straddling encoded surrogate", "\xed\xbf\xbf", JSON_ERROR_INVALID_UTF8);
+
+    check_input("trailing comma in array", "[1,]", JSON_ERROR_UNEXPECTED_TOKEN, 3);
+    check_input("trailing comma in object", "{\"a\": 1, }", JSON_ERROR_UNEXPECTED_TOKEN, 9);
+    check_input("trailing value", "{} 2", JSON_ERROR_UNEXPECTED_TOKEN, 3);
+    check_input("trailing bracket", "[[]]]", JSON_ERROR_UNEXPECTED_TOKEN, 4);
+    check_input("trailing character", "1 x", JSON_ERROR_UNEXPECTED_CHAR, 2);
+    check_input("unfinished", "[1, ", JSON_ERROR_EOF, 4);
+    check_input("empty", "  ", JSON_ERROR_EOF, 2);
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("validate: all checks passed\n");
+    return EXIT_SUCCESS;
+}
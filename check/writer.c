@@ -0,0 +1,281 @@
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+
+#include "check.h"
+
+/*
+ * Checks that the writer writes doubles as the shortest digits that read back as the same double, both
+ * with strtod and with the tokenizer, and writes integers, structure and escapes as expected.
+ *
+ * Grisu2 gives up the shortest digits when they fall within the error of its 64 bit arithmetic from the edge
+ * of the rounding interval, which happens for about one double in a thousand, so for random doubles only
+ * the digits reading back is required, and the shortest digits are required for all but a few of them.
+ */
+
+#define HISTORY 10
+#define RANDOM_DOUBLES 20000
+#define MAX_LONGER 100
+
+/*
+ * A xorshift generator with a fixed seed, so that the same doubles are checked on every run.
+ */
+static uint64_t random_next(void) {
+    static uint64_t state = 0x9E3779B97F4A7C15u;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return state;
+}
+
+/*
+ * Writes one double on its own, copying the output into written.
+ */
+static JsonError write_decimal(double value, char * written, size_t size) {
+    JsonError error;
+    JsonWriter * writer = json_writer_create(JSON_WRITER_COMPACT, &error);
+
+    if(writer == NULL)
+        return error;
+
+    error = json_writer_writeDecimal(writer, value);
+
+    size_t length;
+    const char * output = json_writer_getOutput(writer, &length);
+
+    snprintf(written, size, "%.*s", (int) length, output);
+    json_writer_destroy(writer);
+
+    return error;
+}
+
+/*
+ * Counts the significant digits of a number, leaving out leading zeroes and trailing zeroes.
+ */
+static int count_digits(const char * number) {
+    int first = -1;
+    int last = -1;
+    int count = 0;
+
+    for(; *number != '\0' && *number != 'e' && *number != 'E'; number++) {
+        if(*number < '0' || *number > '9')
+            continue;
+
+        if(*number != '0') {
+            if(first < 0)
+                first = count;
+
+            last = count;
+        }
+
+        count++;
+    }
+
+    return (first < 0 ? 1 : last - first + 1);
+}
+
+/*
+ * Finds the fewest significant digits that read back as the double.
+ */
+static int shortest_digits(double value) {
+    char number[32];
+
+    for(int digits = 1; digits < 17; digits++) {
+        snprintf(number, sizeof(number), "%.*e", digits - 1, value);
+
+        if(strtod(number, NULL) == value)
+            return digits;
+    }
+
+    return 17;
+}
+
+/*
+ * Checks that the double is written as expected, and reads back as the same double.
+ */
+static void check_decimal(double value, const char * expected) {
+    char written[64];
+
+    expect(write_decimal(value, written, sizeof(written)) == JSON_SUCCESS, expected, "the double could not be written");
+
+    if(strcmp(written, expected) != 0) {
+        expect(false, expected, "the double was written differently");
+        fprintf(stderr, "  written: %s\n", written);
+    }
+
+    double read = strtod(written, NULL);
+
+    expect(memcmp(&read, &value, sizeof(double)) == 0, expected, "the double did not read back as itself");
+}
+
+/*
+ * Writes random doubles into an array, checking that each reads back with strtod, and then that the
+ * tokenizer reads the array back as the same doubles.
+ */
+static void check_random(void) {
+    double * values = malloc(RANDOM_DOUBLES * sizeof(double));
+    int count = 0;
+    int longer = 0;
+    JsonError error;
+
+    JsonWriter * writer = json_writer_create(JSON_WRITER_COMPACT, &error);
+    json_writer_startArray(writer);
+
+    while(count < RANDOM_DOUBLES) {
+        uint64_t bits = random_next();
+        double value;
+
+        memcpy(&value, &bits, sizeof(double));
+
+        if(!isfinite(value))
+            continue;
+
+        char written[64];
+        write_decimal(value, written, sizeof(written));
+
+        double read = strtod(written, NULL);
+
+        if(memcmp(&read, &value, sizeof(double)) != 0) {
+            expect(false, written, "a random double did not read back as itself");
+            fprintf(stderr, "  double: %.17g\n", value);
+        }
+
+        int digits = count_digits(written);
+        int shortest = shortest_digits(value);
+
+        expect(digits <= 17, written, "a random double was written with more than 17 digits");
+
+        if(digits > shortest)
+            longer++;
+
+        values[count++] = value;
+        json_writer_writeDecimal(writer, value);
+    }
+
+    json_writer_endArray(writer);
+
+    if(longer > MAX_LONGER) {
+        expect(false, "random", "too many random doubles were not written with the shortest digits");
+        fprintf(stderr, "  %d of %d\n", longer, RANDOM_DOUBLES);
+    }
+
+    size_t length;
+    const char * output = json_writer_getOutput(writer, &length);
+
+    char * contents = malloc(length);
+    memcpy(contents, output, length);
+    json_writer_destroy(writer);
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(json_bufferFixed_create(contents, length, HISTORY, &error), &error);
+    TokenType token;
+    int index = 0;
+
+    while((token = json_tokenizer_readNextToken(tokenizer)) != JSON_TOKEN_EOF && token != JSON_TOKEN_ERROR) {
+        if(token != JSON_TOKEN_NUMBER_DECIMAL && token != JSON_TOKEN_NUMBER_BIG_DECIMAL)
+            continue;
+
+        double read = (token == JSON_TOKEN_NUMBER_DECIMAL ? json_tokenizer_getDecimalValue(tokenizer) :
+                       strtod(json_tokenizer_getNumberValue(tokenizer), NULL));
+
+        if(index < count && memcmp(&read, &values[index], sizeof(double)) != 0) {
+            expect(false, json_tokenizer_getNumberValue(tokenizer), "the tokenizer read a written double back differently");
+            fprintf(stderr, "  double: %.17g\n", values[index]);
+        }
+
+        index++;
+    }
+
+    expect(token == JSON_TOKEN_EOF, "random", "the written doubles could not be read back");
+    expect(index == count, "random", "the tokenizer read back another number of doubles");
+
+    json_tokenizer_destroy(tokenizer);
+    free(contents);
+    free(values);
+}
+
+/*
+ * Writes a small document and checks the whole of the output.
+ */
+static void check_output(const char * name, int options, const char * expected) {
+    JsonError error;
+    JsonWriter * writer = json_writer_create(options, &error);
+
+    json_writer_startObject(writer);
+    json_writer_writeKey(writer, "text", 4);
+    json_writer_writeString(writer, "a\"b\\c\n\x01\xc3\xa9", 9);
+    json_writer_writeKey(writer, "list", 4);
+    json_writer_startArray(writer);
+    json_writer_writeInteger(writer, LONG_MIN);
+    json_writer_writeInteger(writer, LONG_MAX);
+    json_writer_writeInteger(writer, 0);
+    json_writer_writeDecimal(writer, -2.5);
+    json_writer_writeNumber(writer, "1e400", 5);
+    json_writer_writeBoolean(writer, true);
+    json_writer_writeNull(writer);
+    json_writer_startObject(writer);
+    json_writer_endObject(writer);
+    json_writer_endArray(writer);
+    json_writer_endObject(writer);
+
+    expect(json_writer_isComplete(writer), name, "the document was not complete");
+
+    size_t length;
+    const char * output = json_writer_getOutput(writer, &length);
+
+    if(length != strlen(expected) || memcmp(output, expected, length) != 0) {
+        expect(false, name, "the document was written differently");
+        fprintf(stderr, "  expected: %s\n  written:  %.*s\n", expected, (int) length, output);
+    }
+
+    json_writer_destroy(writer);
+}
+
+int main(int argc, char *argv[]) {
+    check_decimal(0.0, "0.0");
+    check_decimal(-0.0, "-0.0");
+    check_decimal(1.0, "1.0");
+    check_decimal(-1.5, "-1.5");
+    check_decimal(0.1, "0.1");
+    check_decimal(0.1 + 0.2, "0.30000000000000004");
+    check_decimal(1.0 / 3.0, "0.3333333333333333");
+    check_decimal(123456.789, "123456.789");
+    check_decimal(9007199254740993.0, "9007199254740992.0");
+    check_decimal(1e20, "100000000000000000000.0");
+    check_decimal(1e21, "1e21");
+    check_decimal(1.5e300, "1.5e300");
+    check_decimal(0.000001, "0.000001");
+    check_decimal(0.0000012, "0.0000012");
+    check_decimal(1e-7, "1e-7");
+    check_decimal(-2.5e-100, "-2.5e-100");
+    check_decimal(DBL_MAX, "1.7976931348623157e308");
+    check_decimal(DBL_MIN, "2.2250738585072014e-308");
+    check_decimal(4.9406564584124654e-324, "5e-324");
+
+    // Infinities and NaN have no JSON form, so nothing is written for them.
+    JsonError error;
+    JsonWriter * writer = json_writer_create(JSON_WRITER_COMPACT, &error);
+
+    expect(json_writer_writeDecimal(writer, INFINITY) == JSON_ERROR_NON_FINITE_NUMBER, "infinity", "infinity was written");
+    expect(json_writer_writeDecimal(writer, -INFINITY) == JSON_ERROR_NON_FINITE_NUMBER, "infinity", "minus infinity was written");
+    expect(json_writer_writeDecimal(writer, NAN) == JSON_ERROR_NON_FINITE_NUMBER, "nan", "NaN was written");
+    expect(json_writer_getLength(writer) == 0, "non-finite", "something was written for a non-finite double");
+
+    json_writer_destroy(writer);
+
+    check_random();
+
+    check_output("compact", JSON_WRITER_COMPACT,
+                 "{\"text\":\"a\\\"b\\\\c\\n\\u0001\xc3\xa9\",\"list\":[-9223372036854775808,9223372036854775807,0,-2.5,1e400,true,null,{}]}");
+    check_output("ascii", JSON_WRITER_ASCII,
+                 "{\"text\":\"a\\\"b\\\\c\\n\\u0001\\u00e9\",\"list\":[-9223372036854775808,9223372036854775807,0,-2.5,1e400,true,null,{}]}");
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("writer: all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocator_internal.h"
+
+/*
+ * Allocates with malloc for the default allocator.
+ */
+static void * json_allocator_defaultAlloc(size_t size, void * context) {
+    (void) context;
+
+    return malloc(size);
+}
+
+/*
+ * Resizes with realloc for the default allocator.
+ */
+static void * json_allocator_defaultRealloc(void * pointer, size_t size, void * context) {
+    (void) context;
+
+    return realloc(pointer, size);
+}
+
+/*
+ * Frees with free for the default allocator.
+ */
+static void json_allocator_defaultFree(void * pointer, void * context) {
+    (void) context;
+
+    free(pointer);
+}
+
+static const JsonAllocator json_allocator_default = {
+    json_allocator_defaultAlloc,
+    json_allocator_defaultRealloc,
+    json_allocator_defaultFree,
+    NULL
+};
+
+/*
+ * Gets the allocator that uses malloc, realloc and free, which is used when no allocator is given.
+ */
+const JsonAllocator * json_allocator_getDefault(void) {
+    return &json_allocator_default;
+}
+
+/*
+ * Gets the allocator passed, or the default allocator if it is NULL.
+ */
+const JsonAllocator * json_allocator_getOrDefault(const JsonAllocator * allocator) {
+    return (allocator != NULL ? allocator : &json_allocator_default);
+}
+
+/*
+ * Gets whether the allocator is a copy of the default allocator, so that what it allocated outlives any caller.
+ */
+bool json_allocator_isDefault(const JsonAllocator * allocator) {
+    return allocator->alloc == json_allocator_default.alloc && allocator->realloc == json_allocator_default.realloc &&
+           allocator->free == json_allocator_default.free && allocator->context == json_allocator_default.context;
+}
+
+/*
+ * Bumps an allocation of size bytes out of the memory of a fixed allocator.
+ */
+static void * json_allocator_fixedAlloc(size_t size, void * context) {
+    FixedAllocator * fixed = (FixedAllocator *) context;
+
+    size_t needed = JSON_ALLOCATOR_ALIGNMENT + json_allocator_alignUp(size);
+
+    if(size > fixed->size || needed > fixed->size - fixed->used) {
+        return NULL;
+    }
+
+    char * start = &fixed->memory[fixed->used];
+
+    *(size_t *) start = size;
+
+    fixed->last = fixed->used;
+    fixed->used += needed;
+
+    return start + JSON_ALLOCATOR_ALIGNMENT;
+}
+
+/*
+ * Resizes an allocation of a fixed allocator, in place if it is the most recent one and otherwise by copying it.
+ */
+static void * json_allocator_fixedRealloc(void * pointer, size_t size, void * context) {
+    FixedAllocator * fixed = (FixedAllocator *) context;
+
+    if(pointer == NULL) {
+        return json_allocator_fixedAlloc(size, context);
+    }
+
+    char * start = (char *) pointer - JSON_ALLOCATOR_ALIGNMENT;
+
+    if(start == &fixed->memory[fixed->last]) {
+        size_t needed = JSON_ALLOCATOR_ALIGNMENT + json_allocator_alignUp(size);
+
+        if(size > fixed->size || needed > fixed->size - fixed->last) {
+            return NULL;
+        }
+
+        *(size_t *) start = size;
+        fixed->used = fixed->last + needed;
+
+        return pointer;
+    }
+
+    size_t oldSize = *(size_t *) start;
+
+    void * resized = json_allocator_fixedAlloc(size, context);
+
+    if(resized != NULL) {
+        memcpy(resized, pointer, (oldSize < size ? oldSize : size));
+    }
+
+    return resized;
+}
+
+/*
+ * Gives back the memory of the most recent allocation of a fixed allocator, as the memory of any other
+ * allocation can only be reused once the whole allocator is.
+ */
+static void json_allocator_fixedFree(void * pointer, void * context) {
+    FixedAllocator * fixed = (FixedAllocator *) context;
+
+    if(pointer != NULL && (char *) pointer - JSON_ALLOCATOR_ALIGNMENT == &fixed->memory[fixed->last]) {
+        fixed->used = fixed->last;
+        fixed->last = fixed->size;
+    }
+}
+
+/*
+ * Creates an allocator that never calls malloc, allocating from the size bytes of memory passed instead.
+ *
+ * Allocations fail once the memory is used up, which is reported as JSON_ERROR_MALLOC or JSON_ERROR_REALLOC
+ * by whatever was allocating. The memory is owned by the caller, and has to outlive everything allocated from it.
+ * Passing the allocator to a buffer keeps both the buffer and its tokenizer within the memory, including the value
+ * buffer, which is resized in place while it is the most recent allocation.
+ */
+JsonAllocator json_allocator_createFixed(void * memory, size_t size) {
+    JsonAllocator allocator = {json_allocator_fixedAlloc, json_allocator_fixedRealloc, json_allocator_fixedFree, NULL};
+
+    // The state is kept at the start of the memory, aligned so that every allocation after it is too.
+    char * start = (char *) json_allocator_alignUp((uintptr_t) memory);
+    size_t skipped = (size_t) (start - (char *) memory);
+    size_t header = json_allocator_alignUp(sizeof(FixedAllocator));
+
+    if(memory == NULL || size < skipped + header) {
+        // Without room for the state, every allocation fails.
+        static FixedAllocator empty = {NULL, 0, 0, 0};
+
+        allocator.context = &empty;
+
+        return allocator;
+    }
+
+    FixedAllocator * fixed = (FixedAllocator *) start;
+
+    fixed->memory = start + header;
+    fixed->size = (size - skipped - header) & ~((size_t) JSON_ALLOCATOR_ALIGNMENT - 1);
+    fixed->used = 0;
+    fixed->last = fixed->size;
+
+    allocator.context = fixed;
+
+    return allocator;
+}
@@ -0,0 +1,50 @@
+#ifndef JSON
+#define JSON
+#include "json.h"
+#endif
+
+/*
+ * The alignment of every allocation made from a fixed allocator.
+ */
+#define JSON_ALLOCATOR_ALIGNMENT 16
+
+/*
+ * Rounds size up to a multiple of JSON_ALLOCATOR_ALIGNMENT.
+ */
+#define json_allocator_alignUp(size) (((size) + JSON_ALLOCATOR_ALIGNMENT - 1) & ~((size_t) JSON_ALLOCATOR_ALIGNMENT - 1))
+
+/*
+ * Allocates size bytes with the allocator, resolving to NULL if it fails.
+ */
+#define json_allocator_alloc(allocator, size) ((allocator)->alloc((size), (allocator)->context))
+
+/*
+ * Resizes an allocation made with the allocator, resolving to NULL if it fails and leaving the allocation as it was.
+ */
+#define json_allocator_realloc(allocator, pointer, size) ((allocator)->realloc((pointer), (size), (allocator)->context))
+
+/*
+ * Frees an allocation made with the allocator.
+ */
+#define json_allocator_free(allocator, pointer) ((allocator)->free((pointer), (allocator)->context))
+
+typedef struct FixedAllocator FixedAllocator;
+
+/*
+ * The state of a fixed allocator, kept at the start of the memory it allocates from.
+ *
+ * Each allocation is preceded by its size so that it can be copied when resized. The most recent
+ * allocation is resized in place and its memory is given back when it is freed.
+ */
+struct FixedAllocator {
+    char * memory;
+    size_t size;
+    size_t used;
+
+    // The offset of the most recent allocation's size, or size if nothing has been allocated.
+    size_t last;
+};
+
+const JsonAllocator * json_allocator_getOrDefault(const JsonAllocator * allocator);
+
+bool json_allocator_isDefault(const JsonAllocator * allocator);
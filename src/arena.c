@@ -0,0 +1,156 @@
+#include <stdlib.h>
+
+#include "arena_internal.h"
+
+/*
+ * Allocates a new arena block with room for at least size bytes.
+ */
+ArenaBlock * json_arena_createBlock(size_t size) {
+    ArenaBlock * block = (ArenaBlock *) malloc(json_arena_alignUp(sizeof(ArenaBlock)) + size);
+
+    if(block == NULL) {
+        return NULL;
+    }
+
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+
+    return block;
+}
+
+/*
+ * Create an arena that allocates memory in blocks of blockSize bytes.
+ *
+ * Everything allocated from the arena is freed at once when the arena is reset or destroyed.
+ */
+JsonArena * json_arena_create(size_t blockSize, JsonError * error) {
+    JsonArena * arena = (JsonArena *) malloc(sizeof(JsonArena));
+
+    if(arena == NULL) {
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    blockSize = json_arena_alignUp(blockSize < JSON_ARENA_ALIGNMENT ? JSON_ARENA_ALIGNMENT : blockSize);
+
+    arena->first = json_arena_createBlock(blockSize);
+
+    if(arena->first == NULL) {
+        free(arena);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    arena->current = arena->first;
+    arena->blockSize = blockSize;
+
+    arena->scratch = NULL;
+    arena->scratchSize = 0;
+
+    *error = JSON_SUCCESS;
+
+    return arena;
+}
+
+/*
+ * Frees the arena and everything allocated from it.
+ */
+void json_arena_destroy(JsonArena * arena) {
+    ArenaBlock * block = arena->first;
+
+    while(block != NULL) {
+        ArenaBlock * next = block->next;
+
+        free(block);
+
+        block = next;
+    }
+
+    free(arena->scratch);
+    free(arena);
+}
+
+/*
+ * Frees everything allocated from the arena at once.
+ *
+ * The blocks of the arena are kept, so an arena that has grown large enough for
+ * its documents can be reused without allocating any more memory.
+ */
+void json_arena_reset(JsonArena * arena) {
+    for(ArenaBlock * block = arena->first; block != NULL; block = block->next) {
+        block->used = 0;
+    }
+
+    arena->current = arena->first;
+}
+
+/*
+ * Allocates size bytes from the arena.
+ *
+ * Moves on to the next block once the current block is full, reusing blocks
+ * kept from before the arena was reset before allocating new ones.
+ */
+void * json_arena_alloc(JsonArena * arena, size_t size, JsonError * error) {
+    size = json_arena_alignUp(size);
+
+    ArenaBlock * block = arena->current;
+
+    while(block->size - block->used < size) {
+        ArenaBlock * next = block->next;
+
+        if(next == NULL || next->size < size) {
+            next = json_arena_createBlock(size > arena->blockSize ? size : arena->blockSize);
+
+            if(next == NULL) {
+                *error = JSON_ERROR_MALLOC;
+                return NULL;
+            }
+
+            // Keep any reusable blocks after the new block.
+            next->next = block->next;
+            block->next = next;
+        }
+
+        block = next;
+    }
+
+    arena->current = block;
+
+    void * memory = json_arenaBlock_data(block) + block->used;
+    block->used += size;
+
+    *error = JSON_SUCCESS;
+
+    return memory;
+}
+
+/*
+ * Gets the scratch space of the arena, growing it to at least size bytes.
+ *
+ * The scratch space is not part of the blocks of the arena. Its contents may move when it grows.
+ */
+void * json_arena_reserveScratch(JsonArena * arena, size_t size, JsonError * error) {
+    if(size > arena->scratchSize) {
+        size_t newSize = (arena->scratchSize == 0 ? 1024 : arena->scratchSize);
+
+        while(newSize < size) {
+            newSize *= 2;
+        }
+
+        char * scratch = realloc(arena->scratch, newSize);
+
+        if(scratch == NULL) {
+            *error = JSON_ERROR_REALLOC;
+            return NULL;
+        }
+
+        arena->scratch = scratch;
+        arena->scratchSize = newSize;
+    }
+
+    *error = JSON_SUCCESS;
+
+    return arena->scratch;
+}
@@ -0,0 +1,51 @@
+#ifndef JSON
+#define JSON
+#include "json.h"
+#endif
+
+/*
+ * The alignment of every allocation made from an arena.
+ */
+#define JSON_ARENA_ALIGNMENT 16
+
+typedef struct ArenaBlock ArenaBlock;
+
+/*
+ * A block of memory that allocations are bumped out of.
+ */
+struct ArenaBlock {
+    ArenaBlock * next;
+
+    size_t size;
+    size_t used;
+};
+
+/*
+ * An arena of blocks that are all freed at once.
+ *
+ * Blocks are kept when the arena is reset so that they can be reused without allocating.
+ */
+struct JsonArena {
+    ArenaBlock * first;
+    ArenaBlock * current;
+
+    size_t blockSize;
+
+    // Temporary space for building values, also kept when the arena is reset.
+    char * scratch;
+    size_t scratchSize;
+};
+
+/*
+ * Get the memory of an arena block, which follows the block header.
+ */
+#define json_arenaBlock_data(block) ((char *) (block) + json_arena_alignUp(sizeof(ArenaBlock)))
+
+/*
+ * Rounds size up to a multiple of the arena alignment.
+ */
+#define json_arena_alignUp(size) (((size) + (JSON_ARENA_ALIGNMENT - 1)) & ~((size_t) JSON_ARENA_ALIGNMENT - 1))
+
+ArenaBlock * json_arena_createBlock(size_t size);
+
+void * json_arena_reserveScratch(JsonArena * arena, size_t size, JsonError * error);
@@ -2,16 +2,48 @@
 #include <unistd.h>
 #include <memory.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "buffer_internal.h"
+#include "allocator_internal.h"
+
+/*
+ * The size of a page, which the blocks of buffers that read ahead are aligned to.
+ */
+#define JSON_READ_AHEAD_PAGE 4096
+
+/*
+ * Starts counting the statistics of a new buffer, where the characters it starts with count as read.
+ */
+static void json_buffer_startStats(JsonBuffer * buffer) {
+#ifdef JSON_STATS
+    buffer->fills = 0;
+    buffer->bytesRead = buffer->read;
+    buffer->historyMoved = 0;
+#else
+    (void) buffer;
+#endif
+}
 
 /*
  * Create a fixed buffer with the contents in buffer.
  *
  * Reads history characters left and right of the buffer index for error messages.
  */
-JsonBuffer * json_bufferFixed_create(char * buffer, int bufferSize, int history, JsonError * error) {
-    JsonBuffer * fixedBuffer = (JsonBuffer *) malloc(sizeof(JsonBuffer));
+JsonBuffer * json_bufferFixed_create(char * buffer, size_t bufferSize, size_t history, JsonError * error) {
+    return json_bufferFixed_createWith(buffer, bufferSize, history, NULL, error);
+}
+
+/*
+ * Creates the same buffer as json_bufferFixed_create, with its memory allocated by the allocator passed,
+ * or by malloc if it is NULL.
+ */
+JsonBuffer * json_bufferFixed_createWith(char * buffer, size_t bufferSize, size_t history, const JsonAllocator * allocator, JsonError * error) {
+    allocator = json_allocator_getOrDefault(allocator);
+
+    JsonBuffer * fixedBuffer = (JsonBuffer *) json_allocator_alloc(allocator, sizeof(JsonBuffer));
 
     if(fixedBuffer == NULL) {
         *error = JSON_ERROR_MALLOC;
@@ -25,9 +57,14 @@ JsonBuffer * json_bufferFixed_create(char * buffer, int bufferSize, int history,
 
     fixedBuffer->index = 0;
     fixedBuffer->read = bufferSize;
+    fixedBuffer->offset = 0;
 
     fixedBuffer->history = history;
 
+    fixedBuffer->allocator = *allocator;
+
+    json_buffer_startStats(fixedBuffer);
+
     *error = JSON_SUCCESS;
 
     return fixedBuffer;
@@ -40,8 +77,18 @@ JsonBuffer * json_bufferFixed_create(char * buffer, int bufferSize, int history,
  *
  * The history must be at least 1, otherwise memory errors can occur.
  */
-JsonBuffer * json_bufferedFile_open(char * file, int bufferSize, int history, JsonError * error) {
-    BufferedFile * buffer = (BufferedFile *) malloc(sizeof(BufferedFile) + bufferSize);
+JsonBuffer * json_bufferedFile_open(char * file, size_t bufferSize, size_t history, JsonError * error) {
+    return json_bufferedFile_openWith(file, bufferSize, history, NULL, error);
+}
+
+/*
+ * Creates the same buffer as json_bufferedFile_open, with its memory allocated by the allocator passed,
+ * or by malloc if it is NULL.
+ */
+JsonBuffer * json_bufferedFile_openWith(char * file, size_t bufferSize, size_t history, const JsonAllocator * allocator, JsonError * error) {
+    allocator = json_allocator_getOrDefault(allocator);
+
+    BufferedFile * buffer = (BufferedFile *) json_allocator_alloc(allocator, sizeof(BufferedFile) + bufferSize);
 
     if(buffer == NULL) {
         *error = JSON_ERROR_MALLOC;
@@ -55,13 +102,20 @@ JsonBuffer * json_bufferedFile_open(char * file, int bufferSize, int history, Js
 
     buffer->buffer.index = 0;
     buffer->buffer.read = 0;
+    buffer->buffer.offset = 0;
 
     buffer->buffer.history = history;
 
+    buffer->buffer.allocator = *allocator;
+
+    json_buffer_startStats(&buffer->buffer);
+
+    buffer->ahead = NULL;
+
     buffer->file = open(file, O_RDONLY);
 
     if(buffer->file == -1) {
-        free(buffer);
+        json_allocator_free(allocator, buffer);
 
         *error = JSON_ERROR_OPEN_FILE;
         return NULL;
@@ -72,6 +126,554 @@ JsonBuffer * json_bufferedFile_open(char * file, int bufferSize, int history, Js
     return (JsonBuffer *) buffer;
 }
 
+/*
+ * Gets the start of a block read ahead into, after the room left for history in front of it.
+ */
+#define json_readAhead_getBlock(ahead, block) (&(ahead)->blocks[(size_t) (block) * (ahead)->stride + (ahead)->room])
+
+/*
+ * Rounds a size up to a whole number of pages, so that each block starts on a page.
+ */
+#define json_readAhead_align(size) (((size) + JSON_READ_AHEAD_PAGE - 1) / JSON_READ_AHEAD_PAGE * JSON_READ_AHEAD_PAGE)
+
+/*
+ * Reads the file into each block in turn once the buffer has moved past it, until the end of the file,
+ * a failure, or the buffer asks it to stop.
+ */
+static void * json_readAhead_work(void * argument) {
+    BufferedFile * stream = (BufferedFile *) argument;
+    ReadAhead * ahead = stream->ahead;
+
+    pthread_mutex_lock(&ahead->lock);
+
+    while(true) {
+        // The block being read from cannot be read into, so at most all of the others are ready.
+        while(!ahead->stopping && ahead->ready == ahead->count - 1) {
+            pthread_cond_wait(&ahead->changed, &ahead->lock);
+        }
+
+        if(ahead->stopping) {
+            break;
+        }
+
+        int block = (ahead->current + ahead->ready + 1) % ahead->count;
+
+        pthread_mutex_unlock(&ahead->lock);
+
+        ssize_t length = read(stream->file, json_readAhead_getBlock(ahead, block), stream->buffer.bufferSize);
+
+        pthread_mutex_lock(&ahead->lock);
+
+        ahead->lengths[block] = length;
+        ahead->ready++;
+
+        pthread_cond_broadcast(&ahead->changed);
+
+        if(length <= 0) {
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&ahead->lock);
+
+    return NULL;
+}
+
+/*
+ * Points the buffer at the first block, with nothing read into it, and starts reading ahead from the file.
+ */
+static JsonError json_readAhead_start(BufferedFile * stream) {
+    ReadAhead * ahead = stream->ahead;
+
+    ahead->stopping = false;
+    ahead->current = 0;
+    ahead->ready = 0;
+
+    stream->buffer.buffer = json_readAhead_getBlock(ahead, 0);
+
+    ahead->running = (pthread_create(&ahead->thread, NULL, json_readAhead_work, stream) == 0);
+
+    return (ahead->running ? JSON_SUCCESS : JSON_ERROR_CREATE_THREAD);
+}
+
+/*
+ * Stops reading ahead, waiting for a read in progress to finish.
+ */
+static void json_readAhead_stop(ReadAhead * ahead) {
+    if(!ahead->running) {
+        return;
+    }
+
+    pthread_mutex_lock(&ahead->lock);
+
+    ahead->stopping = true;
+
+    pthread_cond_broadcast(&ahead->changed);
+    pthread_mutex_unlock(&ahead->lock);
+
+    pthread_join(ahead->thread, NULL);
+
+    ahead->running = false;
+}
+
+/*
+ * Moves the buffer on to the next block once the thread has read into it, copying the history in front of it.
+ */
+static JsonError json_readAhead_fill(BufferedFile * stream) {
+    JsonBuffer * buffer = &stream->buffer;
+    ReadAhead * ahead = stream->ahead;
+
+    // A buffer that was reset without a file has nothing reading into it.
+    if(!ahead->running) {
+        return JSON_ERROR_READ_FILE;
+    }
+
+    pthread_mutex_lock(&ahead->lock);
+
+    while(ahead->ready == 0) {
+        pthread_cond_wait(&ahead->changed, &ahead->lock);
+    }
+
+    int next = (ahead->current + 1) % ahead->count;
+    ssize_t length = ahead->lengths[next];
+
+    pthread_mutex_unlock(&ahead->lock);
+
+    // The block that marks the end of the file or a failure is left ready, so that every later fill fails the same way.
+    if(length == 0) {
+        return JSON_ERROR_EOF;
+    } else if(length == -1) {
+        return JSON_ERROR_READ_FILE;
+    }
+
+    // The thread only reads into the block being left once it is handed back below.
+    size_t readFrom = (buffer->read > buffer->history ? buffer->history : buffer->read);
+    char * start = json_readAhead_getBlock(ahead, next) - readFrom;
+
+    memcpy(start, &buffer->buffer[buffer->read - readFrom], readFrom);
+
+    json_stats_add(buffer->historyMoved, readFrom);
+    json_stats_add(buffer->bytesRead, length);
+
+    buffer->buffer = start;
+
+    buffer->index -= buffer->read - readFrom;
+    buffer->offset += (int64_t) (buffer->read - readFrom);
+    buffer->read = readFrom + (size_t) length;
+
+    pthread_mutex_lock(&ahead->lock);
+
+    ahead->current = next;
+    ahead->ready--;
+
+    pthread_cond_broadcast(&ahead->changed);
+    pthread_mutex_unlock(&ahead->lock);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Allocates a buffer that reads the file passed ahead of the tokenizer on a separate thread, so that reading
+ * the file and tokenizing it overlap.
+ *
+ * The file is read into the given number of blocks of bufferSize characters in turn, at least two, while
+ * the tokenizer reads from the block before them. Filling the buffer only waits when the next block has not
+ * been read into yet, and keeps history characters behind the buffer index for error messages as when the
+ * file is read as the buffer is filled.
+ *
+ * The history must be at least 1, otherwise memory errors can occur.
+ */
+JsonBuffer * json_bufferedFile_openAhead(char * file, size_t bufferSize, size_t history, int blocks, JsonError * error) {
+    return json_bufferedFile_openAheadWith(file, bufferSize, history, blocks, NULL, error);
+}
+
+/*
+ * Creates the same buffer as json_bufferedFile_openAhead, with its memory allocated by the allocator passed,
+ * or by malloc if it is NULL.
+ */
+JsonBuffer * json_bufferedFile_openAheadWith(char * file, size_t bufferSize, size_t history, int blocks, const JsonAllocator * allocator, JsonError * error) {
+    BufferedFile * stream = (BufferedFile *) json_bufferedFile_openWith(file, 0, history, allocator, error);
+
+    if(stream == NULL) {
+        return NULL;
+    }
+
+    if(blocks < 2) {
+        blocks = 2;
+    }
+
+    allocator = &stream->buffer.allocator;
+
+    ReadAhead * ahead = (ReadAhead *) json_allocator_alloc(allocator, sizeof(ReadAhead) + (size_t) blocks * sizeof(ssize_t));
+
+    if(ahead == NULL) {
+        json_buffer_destroy(&stream->buffer);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    ahead->running = false;
+
+    ahead->room = json_readAhead_align(history);
+    ahead->stride = ahead->room + json_readAhead_align(bufferSize);
+    ahead->count = blocks;
+
+    ahead->lengths = (ssize_t *) &ahead[1];
+
+    // A page more is allocated so that the blocks can start on one.
+    ahead->memory = (char *) json_allocator_alloc(allocator, (size_t) blocks * ahead->stride + JSON_READ_AHEAD_PAGE);
+
+    if(ahead->memory == NULL) {
+        json_allocator_free(allocator, ahead);
+        json_buffer_destroy(&stream->buffer);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    ahead->blocks = (char *) json_readAhead_align((uintptr_t) ahead->memory);
+
+    pthread_mutex_init(&ahead->lock, NULL);
+    pthread_cond_init(&ahead->changed, NULL);
+
+    stream->ahead = ahead;
+    stream->buffer.bufferSize = bufferSize;
+
+    *error = json_readAhead_start(stream);
+
+    if(*error != JSON_SUCCESS) {
+        json_buffer_destroy(&stream->buffer);
+        return NULL;
+    }
+
+    return &stream->buffer;
+}
+
+/*
+ * Used as the contents of mapped buffers for empty files, as empty files cannot be mapped.
+ */
+static char json_bufferMapped_empty[1] = "";
+
+/*
+ * Maps the whole of the file passed into memory as a single read-only buffer.
+ *
+ * As all of the file is available at once the buffer never has to be filled,
+ * and history characters either side of the buffer index are always available.
+ *
+ * If hugePages is true the kernel is asked to back the mapping with huge pages where it can.
+ */
+JsonBuffer * json_bufferMapped_open(char * file, size_t history, bool hugePages, JsonError * error) {
+    return json_bufferMapped_openWith(file, history, hugePages, NULL, error);
+}
+
+/*
+ * Creates the same buffer as json_bufferMapped_open, with its memory allocated by the allocator passed,
+ * or by malloc if it is NULL.
+ */
+JsonBuffer * json_bufferMapped_openWith(char * file, size_t history, bool hugePages, const JsonAllocator * allocator, JsonError * error) {
+    allocator = json_allocator_getOrDefault(allocator);
+
+    MappedFile * buffer = (MappedFile *) json_allocator_alloc(allocator, sizeof(MappedFile));
+
+    if(buffer == NULL) {
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    int fileDescriptor = open(file, O_RDONLY);
+
+    if(fileDescriptor == -1) {
+        json_allocator_free(allocator, buffer);
+
+        *error = JSON_ERROR_OPEN_FILE;
+        return NULL;
+    }
+
+    struct stat fileStat;
+
+    if(fstat(fileDescriptor, &fileStat) == -1) {
+        close(fileDescriptor);
+        json_allocator_free(allocator, buffer);
+
+        *error = JSON_ERROR_READ_FILE;
+        return NULL;
+    }
+
+    // The whole file has to fit in the address space to be mapped at once.
+    if((uint64_t) fileStat.st_size > SIZE_MAX) {
+        close(fileDescriptor);
+        json_allocator_free(allocator, buffer);
+
+        *error = JSON_ERROR_FILE_TOO_LARGE;
+        return NULL;
+    }
+
+    size_t size = (size_t) fileStat.st_size;
+    char * contents = json_bufferMapped_empty;
+
+    if(size > 0) {
+        contents = (char *) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+        if(contents == MAP_FAILED) {
+            close(fileDescriptor);
+            json_allocator_free(allocator, buffer);
+
+            *error = JSON_ERROR_MAP_FILE;
+            return NULL;
+        }
+
+        // The advice is only a hint, so failures are ignored.
+#ifdef MADV_SEQUENTIAL
+        madvise(contents, size, MADV_SEQUENTIAL);
+#endif
+
+#ifdef MADV_HUGEPAGE
+        if(hugePages) {
+            madvise(contents, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    // The mapping remains valid after the file is closed.
+    if(close(fileDescriptor) == -1) {
+        if(size > 0) {
+            munmap(contents, size);
+        }
+
+        json_allocator_free(allocator, buffer);
+
+        *error = JSON_ERROR_CLOSE_FILE;
+        return NULL;
+    }
+
+    buffer->buffer.bufferType = JSON_BUFFER_MMAP;
+
+    buffer->buffer.buffer = contents;
+    buffer->buffer.bufferSize = size;
+
+    buffer->buffer.index = 0;
+    buffer->buffer.read = size;
+    buffer->buffer.offset = 0;
+
+    buffer->buffer.history = history;
+
+    buffer->buffer.allocator = *allocator;
+
+    json_buffer_startStats(&buffer->buffer);
+
+    buffer->mappedSize = size;
+
+    *error = JSON_SUCCESS;
+
+    return (JsonBuffer *) buffer;
+}
+
+/*
+ * Allocates a buffer that input is appended to in chunks, starting with room for bufferSize characters.
+ *
+ * Only the characters from the start of the token being read and history characters before it are kept
+ * when more input is appended, so the buffer only grows to fit the largest token and chunk.
+ */
+JsonBuffer * json_bufferPush_create(size_t bufferSize, size_t history, JsonError * error) {
+    return json_bufferPush_createWith(bufferSize, history, NULL, error);
+}
+
+/*
+ * Creates the same buffer as json_bufferPush_create, with its memory allocated by the allocator passed,
+ * or by malloc if it is NULL.
+ */
+JsonBuffer * json_bufferPush_createWith(size_t bufferSize, size_t history, const JsonAllocator * allocator, JsonError * error) {
+    allocator = json_allocator_getOrDefault(allocator);
+
+    PushBuffer * buffer = (PushBuffer *) json_allocator_alloc(allocator, sizeof(PushBuffer));
+
+    if(buffer == NULL) {
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    buffer->buffer.bufferType = JSON_BUFFER_PUSH;
+
+    buffer->buffer.buffer = (char *) json_allocator_alloc(allocator, bufferSize);
+    buffer->buffer.bufferSize = bufferSize;
+
+    if(buffer->buffer.buffer == NULL) {
+        json_allocator_free(allocator, buffer);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    buffer->buffer.index = 0;
+    buffer->buffer.read = 0;
+    buffer->buffer.offset = 0;
+
+    buffer->buffer.history = history;
+
+    buffer->buffer.allocator = *allocator;
+
+    json_buffer_startStats(&buffer->buffer);
+
+    buffer->finished = false;
+
+    *error = JSON_SUCCESS;
+
+    return (JsonBuffer *) buffer;
+}
+
+/*
+ * Appends a chunk of input to a push buffer, discarding the characters that have already been read.
+ */
+JsonError json_bufferPush_append(JsonBuffer * buffer, const char * data, size_t length) {
+    if(buffer->bufferType != JSON_BUFFER_PUSH) {
+        return JSON_ERROR_UNSUPPORTED_BUFFER;
+    }
+
+    if(((PushBuffer *) buffer)->finished) {
+        return JSON_ERROR_EOF;
+    }
+
+    if(buffer->index > buffer->history) {
+        size_t keepFrom = buffer->index - buffer->history;
+
+        memmove(buffer->buffer, &buffer->buffer[keepFrom], buffer->read - keepFrom);
+
+        json_stats_add(buffer->historyMoved, buffer->read - keepFrom);
+
+        buffer->index -= keepFrom;
+        buffer->read -= keepFrom;
+        buffer->offset += (int64_t) keepFrom;
+    }
+
+    if(length > SIZE_MAX - buffer->read) {
+        return JSON_ERROR_FILE_TOO_LARGE;
+    }
+
+    if(buffer->read + length > buffer->bufferSize) {
+        size_t size = (buffer->bufferSize > 0 ? buffer->bufferSize : 1);
+
+        while(size < buffer->read + length) {
+            size = (size > SIZE_MAX / 2 ? SIZE_MAX : size * 2);
+        }
+
+        char * resized = json_allocator_realloc(&buffer->allocator, buffer->buffer, size);
+
+        if(resized == NULL) {
+            return JSON_ERROR_REALLOC;
+        }
+
+        buffer->buffer = resized;
+        buffer->bufferSize = size;
+    }
+
+    memcpy(&buffer->buffer[buffer->read], data, length);
+    buffer->read += length;
+
+    json_stats_add(buffer->bytesRead, length);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Marks the end of the input of a push buffer, so that the last token can be completed.
+ */
+JsonError json_bufferPush_finish(JsonBuffer * buffer) {
+    if(buffer->bufferType != JSON_BUFFER_PUSH) {
+        return JSON_ERROR_UNSUPPORTED_BUFFER;
+    }
+
+    ((PushBuffer *) buffer)->finished = true;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Points a fixed buffer at new contents, reusing it in place of creating another buffer.
+ */
+JsonError json_bufferFixed_reset(JsonBuffer * buffer, char * contents, size_t bufferSize) {
+    if(buffer->bufferType != JSON_BUFFER_FIXED) {
+        return JSON_ERROR_UNSUPPORTED_BUFFER;
+    }
+
+    buffer->buffer = contents;
+    buffer->bufferSize = bufferSize;
+
+    buffer->index = 0;
+    buffer->read = bufferSize;
+    buffer->offset = 0;
+
+    json_buffer_startStats(buffer);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Closes the file of a buffered file and opens another one in its place, keeping the memory of the buffer.
+ *
+ * If the new file cannot be opened, JSON_ERROR_OPEN_FILE is returned and the buffer is left without a file,
+ * so it can only be reset again or destroyed.
+ */
+JsonError json_bufferedFile_reset(JsonBuffer * buffer, char * file) {
+    if(buffer->bufferType != JSON_BUFFER_FILE) {
+        return JSON_ERROR_UNSUPPORTED_BUFFER;
+    }
+
+    BufferedFile * stream = (BufferedFile *) buffer;
+
+    JsonError error = JSON_SUCCESS;
+
+    // The thread has to stop reading from the old file before it is closed.
+    if(stream->ahead != NULL) {
+        json_readAhead_stop(stream->ahead);
+    }
+
+    if(stream->file != -1 && close(stream->file) == -1) {
+        error = JSON_ERROR_CLOSE_FILE;
+    }
+
+    buffer->index = 0;
+    buffer->read = 0;
+    buffer->offset = 0;
+
+    json_buffer_startStats(buffer);
+
+    stream->file = open(file, O_RDONLY);
+
+    if(stream->file == -1) {
+        return JSON_ERROR_OPEN_FILE;
+    }
+
+    if(stream->ahead != NULL) {
+        JsonError startError = json_readAhead_start(stream);
+
+        if(startError != JSON_SUCCESS) {
+            return startError;
+        }
+    }
+
+    return error;
+}
+
+/*
+ * Discards all of the input of a push buffer, including its end if it was finished, keeping the memory it has grown to.
+ */
+JsonError json_bufferPush_reset(JsonBuffer * buffer) {
+    if(buffer->bufferType != JSON_BUFFER_PUSH) {
+        return JSON_ERROR_UNSUPPORTED_BUFFER;
+    }
+
+    buffer->index = 0;
+    buffer->read = 0;
+    buffer->offset = 0;
+
+    json_buffer_startStats(buffer);
+
+    ((PushBuffer *) buffer)->finished = false;
+
+    return JSON_SUCCESS;
+}
+
 /*
  * Frees the resources created for the buffer. Does not free the buffer passed when creating a fixed buffer.
  */
@@ -82,40 +684,83 @@ JsonError json_buffer_destroy(JsonBuffer * buffer) {
         file = ((BufferedFile *) buffer)->file;
     }
 
-    free(buffer);
+    ReadAhead * ahead = (buffer->bufferType == JSON_BUFFER_FILE ? ((BufferedFile *) buffer)->ahead : NULL);
+
+    if(ahead != NULL) {
+        json_readAhead_stop(ahead);
+
+        pthread_mutex_destroy(&ahead->lock);
+        pthread_cond_destroy(&ahead->changed);
+    }
+
+    JsonError error = JSON_SUCCESS;
+
+    if(buffer->bufferType == JSON_BUFFER_MMAP) {
+        MappedFile * mapped = (MappedFile *) buffer;
+
+        if(mapped->mappedSize > 0 && munmap(buffer->buffer, mapped->mappedSize) == -1) {
+            error = JSON_ERROR_UNMAP_FILE;
+        }
+    }
+
+    // The buffer is freed with a copy of its allocator, as the allocator is kept inside of it.
+    JsonAllocator allocator = buffer->allocator;
+
+    if(buffer->bufferType == JSON_BUFFER_PUSH) {
+        json_allocator_free(&allocator, buffer->buffer);
+    }
+
+    if(ahead != NULL) {
+        json_allocator_free(&allocator, ahead->memory);
+        json_allocator_free(&allocator, ahead);
+    }
+
+    json_allocator_free(&allocator, buffer);
 
     if(file != -1 && close(file) == -1) {
         return JSON_ERROR_CLOSE_FILE;
     }
 
-    return JSON_SUCCESS;
+    return error;
 }
 
 /*
  * Attempts to fill the buffer with more data.
  */
 JsonError json_buffer_fill(JsonBuffer * buffer) {
+    json_stats_add(buffer->fills, 1);
+
+    if(buffer->bufferType == JSON_BUFFER_PUSH && !((PushBuffer *) buffer)->finished) {
+        return JSON_ERROR_NEED_MORE;
+    }
+
     if(buffer->bufferType != JSON_BUFFER_FILE) {
         return JSON_ERROR_EOF;
     }
 
     BufferedFile * stream = (BufferedFile *) buffer;
 
-    int readFrom = buffer->read;
+    if(stream->ahead != NULL) {
+        return json_readAhead_fill(stream);
+    }
+
+    size_t readFrom = buffer->read;
 
     if(buffer->read > buffer->history) {
         readFrom = buffer->history;
 
-        int copyFrom = buffer->read - readFrom;
+        size_t copyFrom = buffer->read - readFrom;
 
         if(buffer->read >= buffer->history * 2) {
             memcpy(buffer->buffer, &buffer->buffer[copyFrom], buffer->history);
         } else {
             memmove(buffer->buffer, &buffer->buffer[copyFrom], buffer->history);
         }
+
+        json_stats_add(buffer->historyMoved, buffer->history);
     }
 
-    int charsRead = (int) read(stream->file, &buffer->buffer[readFrom], (size_t) (buffer->bufferSize - readFrom));
+    ssize_t charsRead = read(stream->file, &buffer->buffer[readFrom], buffer->bufferSize - readFrom);
 
     if(charsRead == -1) {
         return JSON_ERROR_READ_FILE;
@@ -123,8 +768,11 @@ JsonError json_buffer_fill(JsonBuffer * buffer) {
         return JSON_ERROR_EOF;
     }
 
+    json_stats_add(buffer->bytesRead, charsRead);
+
     buffer->index -= buffer->read - readFrom;
-    buffer->read = readFrom + charsRead;
+    buffer->offset += (int64_t) (buffer->read - readFrom);
+    buffer->read = readFrom + (size_t) charsRead;
 
     return JSON_SUCCESS;
 }
@@ -141,34 +789,88 @@ char json_buffer_getLastCharacter(JsonBuffer * buffer) {
     }
 }
 
+/*
+ * Gets the position of the buffer index in the whole of the input, which carries on counting as the buffer is refilled.
+ *
+ * For a file this is the offset to seek to in order to read from the same character again.
+ */
+int64_t json_buffer_getOffset(JsonBuffer * buffer) {
+    return buffer->offset + (int64_t) buffer->index;
+}
+
+/*
+ * Moves the buffer index to an offset in the whole of the input, as returned by json_buffer_getOffset.
+ *
+ * Offsets among the characters in the buffer only move the index. Otherwise a buffered file seeks the file
+ * and is filled from the offset, without any history before it, which fails with JSON_ERROR_SEEK for the
+ * other buffers as they cannot go back to input they no longer hold.
+ *
+ * If the file cannot be seeked JSON_ERROR_SEEK is returned, after which a buffer that reads ahead can only be
+ * reset or destroyed.
+ */
+JsonError json_buffer_seek(JsonBuffer * buffer, int64_t offset) {
+    if(offset >= buffer->offset && offset - buffer->offset <= (int64_t) buffer->read) {
+        buffer->index = (size_t) (offset - buffer->offset);
+        return JSON_SUCCESS;
+    }
+
+    if(buffer->bufferType != JSON_BUFFER_FILE || offset < 0) {
+        return JSON_ERROR_SEEK;
+    }
+
+    BufferedFile * stream = (BufferedFile *) buffer;
+
+    // The thread has to stop reading before the file is moved under it.
+    if(stream->ahead != NULL) {
+        json_readAhead_stop(stream->ahead);
+    }
+
+    if(lseek(stream->file, (off_t) offset, SEEK_SET) == -1) {
+        return JSON_ERROR_SEEK;
+    }
+
+    buffer->index = 0;
+    buffer->read = 0;
+    buffer->offset = offset;
+
+    if(stream->ahead != NULL) {
+        return json_readAhead_start(stream);
+    }
+
+    return JSON_SUCCESS;
+}
+
 /*
  * Gets a string for the characters around the character at the buffer index.
+ *
+ * The string is allocated with the allocator of the buffer, which it must be freed with.
  */
-char * json_buffer_getCharactersAroundCurrent(JsonBuffer * buffer, int * currentCharIndex, JsonError * error) {
-    const int charsToLeft = (buffer->index > buffer->history ? buffer->history : buffer->index);
-    const int size = charsToLeft + 1 + buffer->history;
+char * json_buffer_getCharactersAroundCurrent(JsonBuffer * buffer, size_t * currentCharIndex, JsonError * error) {
+    const size_t charsToLeft = (buffer->index > buffer->history ? buffer->history : buffer->index);
+    const size_t size = charsToLeft + 1 + buffer->history;
 
-    char * around = (char *) malloc((size_t) (size + 1));
+    char * around = (char *) json_allocator_alloc(&buffer->allocator, size + 1);
 
     if(around == NULL) {
         *error = JSON_ERROR_MALLOC;
         return NULL;
     }
 
-    for(int index = 0; index < size; index++) {
-        int bufferIndex = buffer->index - charsToLeft + index;
+    for(size_t index = 0; index < size; index++) {
+        size_t bufferIndex = buffer->index - charsToLeft + index;
 
         if(bufferIndex >= buffer->read) {
             JsonError fillError = json_buffer_fill(buffer);
 
-            if(fillError == JSON_ERROR_EOF) {
+            // Input that has not been pushed yet cannot be shown either.
+            if(fillError == JSON_ERROR_EOF || fillError == JSON_ERROR_NEED_MORE) {
                 around[index] = '\0';
 
                 break;
             } else if(fillError != JSON_SUCCESS) {
                 *error = fillError;
 
-                free(around);
+                json_allocator_free(&buffer->allocator, around);
 
                 return NULL;
             }
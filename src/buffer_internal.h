@@ -3,6 +3,11 @@
 #include "json.h"
 #endif
 
+#include <pthread.h>
+#include <sys/types.h>
+
+#include "stats_internal.h"
+
 /*
  * Get the character at the buffer index.
  */
@@ -30,6 +35,11 @@
  */
 #define json_buffer_ensureAvailable(jsonBuffer) (jsonBuffer->index < jsonBuffer->read ? JSON_SUCCESS : json_buffer_fill(jsonBuffer))
 
+/*
+ * Whether the whole input is held in the buffer and never moves, so that slices of it remain valid.
+ */
+#define json_buffer_isContiguous(jsonBuffer) (jsonBuffer->bufferType == JSON_BUFFER_FIXED || jsonBuffer->bufferType == JSON_BUFFER_MMAP)
+
 typedef enum BufferType BufferType;
 
 /*
@@ -37,10 +47,14 @@ typedef enum BufferType BufferType;
  *
  * JSON_BUFFER_FIXED: The user populates the buffer.
  * JSON_BUFFER_FILE: The buffer is filled from a file.
+ * JSON_BUFFER_MMAP: The buffer is a read-only mapping of a whole file.
+ * JSON_BUFFER_PUSH: The user appends chunks of input to the buffer as they arrive.
  */
 enum BufferType {
     JSON_BUFFER_FIXED,
-    JSON_BUFFER_FILE
+    JSON_BUFFER_FILE,
+    JSON_BUFFER_MMAP,
+    JSON_BUFFER_PUSH
 };
 
 /*
@@ -50,12 +64,61 @@ struct JsonBuffer {
     BufferType bufferType;
 
     char *buffer;
-    int bufferSize;
+    size_t bufferSize;
 
-    int index;
-    int read;
+    size_t index;
+    size_t read;
 
-    int history;
+    size_t history;
+
+    // The position in the whole of the input of the first character in the buffer, moved on as characters are discarded.
+    int64_t offset;
+
+    // Allocates the buffer and everything made for it, such as its tokenizer.
+    JsonAllocator allocator;
+
+#ifdef JSON_STATS
+    // The number of fills, characters brought into the buffer, and characters moved to keep the history.
+    size_t fills;
+    size_t bytesRead;
+    size_t historyMoved;
+#endif
+};
+
+typedef struct ReadAhead ReadAhead;
+
+/*
+ * The blocks of a buffered file that reads ahead, which a thread reads the file into in turn while the
+ * tokenizer reads from the current one.
+ *
+ * Each block has room in front of it for the history, which is copied there from the end of the block before
+ * when the buffer moves on to it.
+ */
+struct ReadAhead {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+
+    // Whether the thread was started, and whether it has been asked to stop.
+    bool running;
+    bool stopping;
+
+    // The memory allocated for the blocks, and the first block within it, aligned to a page.
+    char * memory;
+    char * blocks;
+
+    // The distance between blocks, and the room for history in front of each one.
+    size_t stride;
+    size_t room;
+
+    int count;
+
+    // The block the buffer is reading from, and the number of blocks after it that the thread has read into.
+    int current;
+    int ready;
+
+    // What read returned for each block, where 0 marks the end of the file and -1 a failure.
+    ssize_t * lengths;
 };
 
 typedef struct BufferedFile BufferedFile;
@@ -67,4 +130,33 @@ struct BufferedFile {
     JsonBuffer buffer;
 
     int file;
-};
\ No newline at end of file
+
+    // The blocks read ahead into, or NULL if the file is read when the buffer is filled.
+    ReadAhead * ahead;
+};
+
+typedef struct MappedFile MappedFile;
+
+/*
+ * The buffer struct for memory mapped files.
+ *
+ * The whole file is mapped at once, so the buffer never needs to be filled.
+ */
+struct MappedFile {
+    JsonBuffer buffer;
+
+    size_t mappedSize;
+};
+
+typedef struct PushBuffer PushBuffer;
+
+/*
+ * The buffer struct for input that is pushed in chunks.
+ *
+ * Filling the buffer fails with JSON_ERROR_NEED_MORE until the end of the input has been marked.
+ */
+struct PushBuffer {
+    JsonBuffer buffer;
+
+    bool finished;
+};
@@ -80,4 +80,83 @@ int json_char_UCSCodepointToUTF8(int codepoint, char * buffer) {
 
     // Invalid codepoint.
     return -1;
-}
\ No newline at end of file
+}
+
+/*
+ * Reads the UTF-8 encoded codepoint at the start of the buffer, looking at no more than length characters.
+ *
+ * Returns the number of characters read, or -1 if they are not a valid encoding, including overlong
+ * encodings, surrogates and codepoints above U+10FFFF.
+ */
+int json_char_UTF8ToUCSCodepoint(const char * buffer, size_t length, int * codepoint) {
+    if(length == 0) {
+        return -1;
+    }
+
+    unsigned char lead = (unsigned char) buffer[0];
+
+    int continuations;
+    int minimum;
+
+    if(lead <= 0x7F) {
+        // 0xxxxxxx
+
+        *codepoint = lead;
+
+        return 1;
+    } else if(lead >= 0xC0 && lead <= 0xDF) {
+        // 110xxxxx 10xxxxxx
+
+        continuations = 1;
+        minimum = 0x80;
+        *codepoint = lead & 0x1F;
+    } else if(lead >= 0xE0 && lead <= 0xEF) {
+        // 1110xxxx 10xxxxxx 10xxxxxx
+
+        continuations = 2;
+        minimum = 0x800;
+        *codepoint = lead & 0x0F;
+    } else if(lead >= 0xF0 && lead <= 0xF7) {
+        // 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+
+        continuations = 3;
+        minimum = 0x10000;
+        *codepoint = lead & 0x07;
+    } else {
+        // A continuation byte, or the start of a sequence longer than Unicode allows.
+        return -1;
+    }
+
+    if(length <= (size_t) continuations) {
+        return -1;
+    }
+
+    for(int index = 1; index <= continuations; index++) {
+        unsigned char current = (unsigned char) buffer[index];
+
+        if((current & 0xC0) != 0x80) {
+            return -1;
+        }
+
+        *codepoint = (*codepoint << 6) | (current & 0x3F);
+    }
+
+    if(*codepoint < minimum || *codepoint > 0x10FFFF || (*codepoint >= 0xD800 && *codepoint <= 0xDFFF)) {
+        return -1;
+    }
+
+    return continuations + 1;
+}
+
+/*
+ * Hashes the characters of a key with FNV-1a.
+ */
+unsigned int json_char_hash(const char * key, size_t length) {
+    unsigned int hash = 2166136261u;
+
+    for(size_t index = 0; index < length; index++) {
+        hash = (hash ^ (unsigned char) key[index]) * 16777619u;
+    }
+
+    return hash;
+}
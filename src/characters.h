@@ -1,4 +1,5 @@
 #include <stdbool.h>
+#include <stddef.h>
 
 /*
  * Returns whether the character is considered by JSON to be whitespace.
@@ -11,6 +12,11 @@
  */
 #define json_char_isWhitespace(c) (c == '\t' || c == '\n' || c == '\r' || c == ' ')
 
+/*
+ * Returns whether the character is a token on its own, being one of {, }, [, ], : or ,.
+ */
+#define json_char_isStructural(c) (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',')
+
 /*
  * Returns whether the character is considered by JSON to be a control character.
  */
@@ -24,4 +30,14 @@
 /*
  * Places the UCS codepoint as UTF-8 in the buffer.
  */
-int json_char_UCSCodepointToUTF8(int codepoint, char * buffer);
\ No newline at end of file
+int json_char_UCSCodepointToUTF8(int codepoint, char * buffer);
+
+/*
+ * Reads the UTF-8 encoded codepoint at the start of the buffer, returning the number of characters read or -1 if it is invalid.
+ */
+int json_char_UTF8ToUCSCodepoint(const char * buffer, size_t length, int * codepoint);
+
+/*
+ * Hashes the characters of a key with FNV-1a.
+ */
+unsigned int json_char_hash(const char * key, size_t length);
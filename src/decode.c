@@ -0,0 +1,219 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json.h"
+
+/*
+ * Gets the error for a token that cannot be where it was read, passing on the error of the tokenizer if it failed.
+ *
+ * Decoders read whole values, so pushed input must be complete, and running out of it fails with JSON_ERROR_NEED_MORE.
+ */
+JsonError json_decode_unexpected(TokenizerHandle * tokenizer, TokenType token) {
+    switch(token) {
+        case JSON_TOKEN_ERROR:
+            return json_tokenizer_getError(tokenizer);
+        case JSON_TOKEN_NEED_MORE:
+            return JSON_ERROR_NEED_MORE;
+        default:
+            return JSON_ERROR_UNEXPECTED_TOKEN;
+    }
+}
+
+/*
+ * Reads the key of the next member of an object, after the one numbered member, setting key to NULL at the end of the object.
+ *
+ * The key is a slice as given by json_tokenizer_getStringSlice, so it has to be matched before the colon is read.
+ */
+JsonError json_decode_nextKey(TokenizerHandle * tokenizer, size_t member, const char ** key, size_t * length) {
+    TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+    if(token == JSON_TOKEN_OBJECT_END) {
+        *key = NULL;
+        return JSON_SUCCESS;
+    }
+
+    if(member > 0) {
+        if(token != JSON_TOKEN_COMMA) {
+            return json_decode_unexpected(tokenizer, token);
+        }
+
+        token = json_tokenizer_readNextToken(tokenizer);
+    }
+
+    if(token != JSON_TOKEN_TEXT) {
+        return json_decode_unexpected(tokenizer, token);
+    }
+
+    json_tokenizer_getStringSlice(tokenizer, key, length);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Reads the colon between the key of a member and its value.
+ */
+JsonError json_decode_colon(TokenizerHandle * tokenizer) {
+    TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+    if(token != JSON_TOKEN_COLON) {
+        return json_decode_unexpected(tokenizer, token);
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Reads the first token of the element after the one numbered element, setting token to JSON_TOKEN_ARRAY_END at the end of the array.
+ *
+ * For the first element the start of the array is read too, and null is taken as an empty array.
+ */
+JsonError json_decode_nextElement(TokenizerHandle * tokenizer, size_t element, TokenType * token) {
+    *token = json_tokenizer_readNextToken(tokenizer);
+
+    if(element == 0) {
+        if(*token == JSON_TOKEN_NULL) {
+            *token = JSON_TOKEN_ARRAY_END;
+            return JSON_SUCCESS;
+        }
+
+        if(*token != JSON_TOKEN_ARRAY_START) {
+            return json_decode_unexpected(tokenizer, *token);
+        }
+
+        *token = json_tokenizer_readNextToken(tokenizer);
+
+        return JSON_SUCCESS;
+    }
+
+    if(*token == JSON_TOKEN_ARRAY_END) {
+        return JSON_SUCCESS;
+    }
+
+    if(*token != JSON_TOKEN_COMMA) {
+        return json_decode_unexpected(tokenizer, *token);
+    }
+
+    *token = json_tokenizer_readNextToken(tokenizer);
+
+    // A comma has to be followed by another element.
+    if(*token == JSON_TOKEN_ARRAY_END) {
+        return JSON_ERROR_UNEXPECTED_TOKEN;
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Sets value to the integer that was just read, leaving it unchanged for null.
+ *
+ * Returns JSON_ERROR_OUT_OF_RANGE if the integer does not fit in an int.
+ */
+JsonError json_decode_int(TokenizerHandle * tokenizer, TokenType token, int * value) {
+    if(token == JSON_TOKEN_NUMBER_INTEGER) {
+        long int integer = json_tokenizer_getIntegerValue(tokenizer);
+
+        if(integer < INT_MIN || integer > INT_MAX) {
+            return JSON_ERROR_OUT_OF_RANGE;
+        }
+
+        *value = (int) integer;
+        return JSON_SUCCESS;
+    }
+
+    if(token == JSON_TOKEN_NUMBER_BIG_INTEGER) {
+        return JSON_ERROR_OUT_OF_RANGE;
+    }
+
+    return token == JSON_TOKEN_NULL ? JSON_SUCCESS : json_decode_unexpected(tokenizer, token);
+}
+
+/*
+ * Sets value to the integer that was just read, leaving it unchanged for null.
+ *
+ * Returns JSON_ERROR_OUT_OF_RANGE if the integer does not fit in a long int.
+ */
+JsonError json_decode_long(TokenizerHandle * tokenizer, TokenType token, long int * value) {
+    if(token == JSON_TOKEN_NUMBER_INTEGER) {
+        *value = json_tokenizer_getIntegerValue(tokenizer);
+        return JSON_SUCCESS;
+    }
+
+    if(token == JSON_TOKEN_NUMBER_BIG_INTEGER) {
+        return JSON_ERROR_OUT_OF_RANGE;
+    }
+
+    return token == JSON_TOKEN_NULL ? JSON_SUCCESS : json_decode_unexpected(tokenizer, token);
+}
+
+/*
+ * Sets value to the number that was just read, which may be an integer, leaving it unchanged for null.
+ *
+ * Returns JSON_ERROR_OUT_OF_RANGE if the number is too large to be a double.
+ */
+JsonError json_decode_double(TokenizerHandle * tokenizer, TokenType token, double * value) {
+    switch(token) {
+        case JSON_TOKEN_NUMBER_DECIMAL:
+            *value = json_tokenizer_getDecimalValue(tokenizer);
+            return JSON_SUCCESS;
+        case JSON_TOKEN_NUMBER_INTEGER:
+            *value = (double) json_tokenizer_getIntegerValue(tokenizer);
+            return JSON_SUCCESS;
+        case JSON_TOKEN_NUMBER_BIG_INTEGER: {
+            // Only integers too large for a long int get here, which a double holds approximately.
+            char * number = json_tokenizer_getNumberValue(tokenizer);
+
+            if(number == NULL) {
+                return JSON_ERROR_MALLOC;
+            }
+
+            *value = strtod(number, NULL);
+            return JSON_SUCCESS;
+        }
+        case JSON_TOKEN_NUMBER_BIG_DECIMAL:
+            return JSON_ERROR_OUT_OF_RANGE;
+        case JSON_TOKEN_NULL:
+            return JSON_SUCCESS;
+        default:
+            return json_decode_unexpected(tokenizer, token);
+    }
+}
+
+/*
+ * Sets value to the boolean that was just read, leaving it unchanged for null.
+ */
+JsonError json_decode_bool(TokenizerHandle * tokenizer, TokenType token, bool * value) {
+    if(token == JSON_TOKEN_TRUE || token == JSON_TOKEN_FALSE) {
+        *value = (token == JSON_TOKEN_TRUE);
+        return JSON_SUCCESS;
+    }
+
+    return token == JSON_TOKEN_NULL ? JSON_SUCCESS : json_decode_unexpected(tokenizer, token);
+}
+
+/*
+ * Copies the string that was just read into value, which holds size characters including the null terminator,
+ * leaving it unchanged for null.
+ *
+ * The string is copied straight from where the tokenizer has it. Returns JSON_ERROR_OUT_OF_RANGE if it does
+ * not fit, in which case value is left unchanged.
+ */
+JsonError json_decode_string(TokenizerHandle * tokenizer, TokenType token, char * value, size_t size) {
+    if(token != JSON_TOKEN_TEXT) {
+        return token == JSON_TOKEN_NULL ? JSON_SUCCESS : json_decode_unexpected(tokenizer, token);
+    }
+
+    const char * text;
+    size_t length;
+
+    json_tokenizer_getStringSlice(tokenizer, &text, &length);
+
+    if(length >= size) {
+        return JSON_ERROR_OUT_OF_RANGE;
+    }
+
+    memcpy(value, text, length);
+    value[length] = '\0';
+
+    return JSON_SUCCESS;
+}
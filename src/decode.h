@@ -0,0 +1,149 @@
+#ifndef JSON
+#define JSON
+#include "json.h"
+#endif
+
+#include <string.h>
+
+/*
+ * Defines a function that decodes a JSON object straight into a struct, with the fields listed by an X-macro.
+ *
+ * The function is declared as:
+ *
+ *     JsonError name(TokenizerHandle * tokenizer, TokenType token, type * target);
+ *
+ * where token is the first token of the value, so a whole input is decoded with
+ * name(tokenizer, json_tokenizer_readNextToken(tokenizer), &target). The fields are listed as:
+ *
+ *     #define ORDER_FIELDS(FIELD) \
+ *         FIELD(LONG, id) \
+ *         FIELD(STRING, note) \
+ *         FIELD(OBJECT, customer, json_decodeCustomer) \
+ *         FIELD(ARRAY, items, itemCount, json_decodeItem)
+ *
+ *     json_decode_define(json_decodeOrder, Order, ORDER_FIELDS)
+ *
+ * Each field is matched by the key with the same name as its member, and is one of:
+ * - INT, LONG, DOUBLE or BOOL, for members of type int, long int, double or bool
+ * - STRING, for a char array that the string is copied into
+ * - OBJECT, for a struct decoded by another decoder defined this way
+ * - ARRAY, for a fixed size array, with the member set to the number of elements read, and a decoder for the
+ *   elements, which may be another decoder defined this way or one of json_decode_int, json_decode_long,
+ *   json_decode_double or json_decode_bool
+ *
+ * Keys are matched by comparing them against the name of each field, whose length is known when compiling,
+ * and the value is then converted by a switch on the field, so nothing is built up in between and no key is
+ * copied. Members of other keys are skipped with json_tokenizer_skipValue. Fields whose key is missing or
+ * whose value is null are left unchanged, so the struct should be initialized before it is decoded into,
+ * except for an ARRAY that is null, which is taken as empty and has its count set to 0.
+ */
+#define json_decode_define(name, type, fields) \
+    JsonError name(TokenizerHandle * tokenizer, TokenType token, type * target) { \
+        enum { fields(json_decode_enum) json_decodeFields_end }; \
+        \
+        if(token != JSON_TOKEN_OBJECT_START) { \
+            return token == JSON_TOKEN_NULL ? JSON_SUCCESS : json_decode_unexpected(tokenizer, token); \
+        } \
+        \
+        for(size_t member = 0; ; member++) { \
+            const char * key; \
+            size_t length; \
+            \
+            JsonError error = json_decode_nextKey(tokenizer, member, &key, &length); \
+            \
+            if(error != JSON_SUCCESS || key == NULL) { \
+                return error; \
+            } \
+            \
+            int field = fields(json_decode_match) -1; \
+            \
+            error = json_decode_colon(tokenizer); \
+            \
+            if(error != JSON_SUCCESS) { \
+                return error; \
+            } \
+            \
+            switch(field) { \
+                fields(json_decode_case) \
+                default: \
+                    error = json_tokenizer_skipValue(tokenizer); \
+                    break; \
+            } \
+            \
+            if(error != JSON_SUCCESS) { \
+                return error; \
+            } \
+        } \
+    }
+
+/*
+ * Names the field in the enum of the decoder.
+ *
+ * The member always comes straight after the kind, and a 0 is passed after it so that there is something
+ * for the ... to take when the field has nothing else.
+ */
+#define json_decode_enum(kind, ...) json_decode_enumMember(__VA_ARGS__, 0)
+#define json_decode_enumMember(member, ...) json_decodeField_##member,
+
+/*
+ * Gives the field if the key has its name, or otherwise goes on to the next field.
+ */
+#define json_decode_match(kind, ...) json_decode_matchMember(__VA_ARGS__, 0)
+#define json_decode_matchMember(member, ...) \
+    (length == sizeof(#member) - 1 && memcmp(key, #member, sizeof(#member) - 1) == 0) ? json_decodeField_##member :
+
+/*
+ * Reads the value of the field into its member, by the kind of the field.
+ */
+#define json_decode_case(kind, ...) json_decode_case##kind(__VA_ARGS__)
+
+#define json_decode_caseINT(member) \
+    case json_decodeField_##member: \
+        error = json_decode_int(tokenizer, json_tokenizer_readNextToken(tokenizer), &target->member); \
+        break;
+
+#define json_decode_caseLONG(member) \
+    case json_decodeField_##member: \
+        error = json_decode_long(tokenizer, json_tokenizer_readNextToken(tokenizer), &target->member); \
+        break;
+
+#define json_decode_caseDOUBLE(member) \
+    case json_decodeField_##member: \
+        error = json_decode_double(tokenizer, json_tokenizer_readNextToken(tokenizer), &target->member); \
+        break;
+
+#define json_decode_caseBOOL(member) \
+    case json_decodeField_##member: \
+        error = json_decode_bool(tokenizer, json_tokenizer_readNextToken(tokenizer), &target->member); \
+        break;
+
+#define json_decode_caseSTRING(member) \
+    case json_decodeField_##member: \
+        error = json_decode_string(tokenizer, json_tokenizer_readNextToken(tokenizer), target->member, sizeof(target->member)); \
+        break;
+
+#define json_decode_caseOBJECT(member, decoder) \
+    case json_decodeField_##member: \
+        error = decoder(tokenizer, json_tokenizer_readNextToken(tokenizer), &target->member); \
+        break;
+
+#define json_decode_caseARRAY(member, count, decoder) \
+    case json_decodeField_##member: \
+        target->count = 0; \
+        \
+        for(size_t element = 0; (error = json_decode_nextElement(tokenizer, element, &token)) == JSON_SUCCESS && \
+                                token != JSON_TOKEN_ARRAY_END; element++) { \
+            if(element == sizeof(target->member) / sizeof(target->member[0])) { \
+                error = JSON_ERROR_OUT_OF_RANGE; \
+                break; \
+            } \
+            \
+            error = decoder(tokenizer, token, &target->member[element]); \
+            \
+            if(error != JSON_SUCCESS) { \
+                break; \
+            } \
+            \
+            target->count = element + 1; \
+        } \
+        break;
@@ -0,0 +1,440 @@
+#include <string.h>
+
+#include "arena_internal.h"
+
+typedef struct JsonMember JsonMember;
+
+/*
+ * A value in a document. All of the memory of a value is allocated from the arena of its document.
+ */
+struct JsonValue {
+    JsonValueType type;
+
+    // The number of characters in a string, or the number of children of an object or array.
+    size_t length;
+
+    union {
+        long int integer;
+        double decimal;
+        bool boolean;
+        char * string;
+        JsonValue * elements;
+        JsonMember * members;
+    } as;
+};
+
+/*
+ * A key and value in an object. The members of an object are stored contiguously.
+ */
+struct JsonMember {
+    char * key;
+    size_t keyLength;
+
+    JsonValue value;
+};
+
+/*
+ * A document parsed from a tokenizer.
+ */
+struct JsonDocument {
+    JsonArena * arena;
+
+    JsonValue root;
+};
+
+typedef enum DocumentState DocumentState;
+
+/*
+ * The tokens the document builder expects next.
+ */
+enum DocumentState {
+    JSON_DOCUMENT_EXPECT_VALUE,
+    JSON_DOCUMENT_EXPECT_VALUE_OR_END,
+    JSON_DOCUMENT_EXPECT_KEY,
+    JSON_DOCUMENT_EXPECT_KEY_OR_END,
+    JSON_DOCUMENT_EXPECT_COLON,
+    JSON_DOCUMENT_EXPECT_COMMA_OR_END,
+    JSON_DOCUMENT_DONE
+};
+
+/*
+ * Marks that a container has no parent while the document is being built.
+ */
+#define JSON_DOCUMENT_NO_PARENT ((size_t) -1)
+
+/*
+ * Get a string with the name of a given value type.
+ */
+char * json_value_typeName(JsonValueType type) {
+    switch(type) {
+        case JSON_VALUE_OBJECT:
+            return "Object";
+        case JSON_VALUE_ARRAY:
+            return "Array";
+        case JSON_VALUE_STRING:
+            return "String";
+        case JSON_VALUE_INTEGER:
+            return "Integer";
+        case JSON_VALUE_DECIMAL:
+            return "Decimal";
+        case JSON_VALUE_BIG_NUMBER:
+            return "Big number";
+        case JSON_VALUE_BOOLEAN:
+            return "Boolean";
+        case JSON_VALUE_NULL:
+            return "Null";
+        default:
+            return "Unknown value type";
+    }
+}
+
+/*
+ * Copies length characters into the arena followed by a null terminator.
+ */
+char * json_document_copyString(JsonArena * arena, const char * string, size_t length, JsonError * error) {
+    char * copy = (char *) json_arena_alloc(arena, length + 1, error);
+
+    if(copy == NULL) {
+        return NULL;
+    }
+
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+
+    return copy;
+}
+
+/*
+ * Sets value to the scalar value of the token that was just read.
+ *
+ * Returns JSON_ERROR_UNEXPECTED_TOKEN if the token is not the start of a value.
+ */
+JsonError json_document_readScalar(TokenizerHandle * tokenizer, JsonArena * arena, TokenType token, JsonValue * value) {
+    JsonError error = JSON_SUCCESS;
+
+    const char * text;
+    size_t length;
+
+    switch(token) {
+        case JSON_TOKEN_TEXT:
+            json_tokenizer_getStringSlice(tokenizer, &text, &length);
+
+            value->type = JSON_VALUE_STRING;
+            value->length = length;
+            value->as.string = json_document_copyString(arena, text, length, &error);
+
+            return error;
+        case JSON_TOKEN_NUMBER_INTEGER:
+            value->type = JSON_VALUE_INTEGER;
+            value->as.integer = json_tokenizer_getIntegerValue(tokenizer);
+
+            return JSON_SUCCESS;
+        case JSON_TOKEN_NUMBER_DECIMAL:
+            value->type = JSON_VALUE_DECIMAL;
+            value->as.decimal = json_tokenizer_getDecimalValue(tokenizer);
+
+            return JSON_SUCCESS;
+        case JSON_TOKEN_NUMBER_BIG_INTEGER:
+        case JSON_TOKEN_NUMBER_BIG_DECIMAL:
+            json_tokenizer_getNumberSlice(tokenizer, &text, &length);
+
+            value->type = JSON_VALUE_BIG_NUMBER;
+            value->length = length;
+            value->as.string = json_document_copyString(arena, text, length, &error);
+
+            return error;
+        case JSON_TOKEN_TRUE:
+        case JSON_TOKEN_FALSE:
+            value->type = JSON_VALUE_BOOLEAN;
+            value->as.boolean = (token == JSON_TOKEN_TRUE);
+
+            return JSON_SUCCESS;
+        case JSON_TOKEN_NULL:
+            value->type = JSON_VALUE_NULL;
+
+            return JSON_SUCCESS;
+        default:
+            return JSON_ERROR_UNEXPECTED_TOKEN;
+    }
+}
+
+/*
+ * Parses the next value from the tokenizer into a document allocated from the arena.
+ *
+ * The document, and all of its values, keys and strings, are freed when the arena is reset or destroyed.
+ * The children of objects and arrays are stored contiguously.
+ *
+ * Values are collected on the scratch space of the arena until their container is closed,
+ * so parsing into an arena that has been reset does not allocate once the arena has grown.
+ */
+JsonDocument * json_document_parse(TokenizerHandle * tokenizer, JsonArena * arena, JsonError * error) {
+    JsonDocument * document = (JsonDocument *) json_arena_alloc(arena, sizeof(JsonDocument), error);
+
+    if(document == NULL) {
+        return NULL;
+    }
+
+    document->arena = arena;
+
+    // The values read so far, with each open container followed by its children.
+    JsonMember * pending = NULL;
+    size_t pendingCount = 0;
+    size_t pendingCapacity = 0;
+
+    // The index in pending of the innermost open container.
+    size_t container = JSON_DOCUMENT_NO_PARENT;
+
+    // The key of the next member of an object.
+    char * key = NULL;
+    size_t keyLength = 0;
+
+    DocumentState state = JSON_DOCUMENT_EXPECT_VALUE;
+
+    while(state != JSON_DOCUMENT_DONE) {
+        TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+        if(token == JSON_TOKEN_ERROR) {
+            *error = json_tokenizer_getError(tokenizer);
+            return NULL;
+        }
+
+        if(token == JSON_TOKEN_EOF) {
+            *error = JSON_ERROR_EOF;
+            return NULL;
+        }
+
+        // Documents are not resumable, so pushed input must be complete before parsing.
+        if(token == JSON_TOKEN_NEED_MORE) {
+            *error = JSON_ERROR_NEED_MORE;
+            return NULL;
+        }
+
+        // An object that was just opened may be closed straight away, and otherwise needs a key like any other.
+        if(state == JSON_DOCUMENT_EXPECT_KEY_OR_END) {
+            if(token == JSON_TOKEN_OBJECT_END)
+                goto closeContainer;
+
+            state = JSON_DOCUMENT_EXPECT_KEY;
+        }
+
+        switch(state) {
+            case JSON_DOCUMENT_EXPECT_KEY:
+                if(token != JSON_TOKEN_TEXT) {
+                    *error = JSON_ERROR_UNEXPECTED_TOKEN;
+                    return NULL;
+                }
+
+                const char * text;
+                json_tokenizer_getStringSlice(tokenizer, &text, &keyLength);
+
+                key = json_document_copyString(arena, text, keyLength, error);
+
+                if(key == NULL)
+                    return NULL;
+
+                state = JSON_DOCUMENT_EXPECT_COLON;
+                continue;
+            case JSON_DOCUMENT_EXPECT_COLON:
+                if(token != JSON_TOKEN_COLON) {
+                    *error = JSON_ERROR_UNEXPECTED_TOKEN;
+                    return NULL;
+                }
+
+                state = JSON_DOCUMENT_EXPECT_VALUE;
+                continue;
+            case JSON_DOCUMENT_EXPECT_COMMA_OR_END:
+                if(token == JSON_TOKEN_COMMA) {
+                    state = (pending[container].value.type == JSON_VALUE_OBJECT ? JSON_DOCUMENT_EXPECT_KEY : JSON_DOCUMENT_EXPECT_VALUE);
+                    continue;
+                }
+
+                if(token == JSON_TOKEN_OBJECT_END || token == JSON_TOKEN_ARRAY_END)
+                    goto closeContainer;
+
+                *error = JSON_ERROR_UNEXPECTED_TOKEN;
+                return NULL;
+            case JSON_DOCUMENT_EXPECT_VALUE_OR_END:
+                if(token == JSON_TOKEN_ARRAY_END)
+                    goto closeContainer;
+
+                break;
+            default:
+                break;
+        }
+
+        // Read a value, which is added to the pending values.
+        {
+            if(pendingCount == pendingCapacity) {
+                pending = (JsonMember *) json_arena_reserveScratch(arena, (pendingCount + 1) * sizeof(JsonMember), error);
+
+                if(pending == NULL)
+                    return NULL;
+
+                pendingCapacity = arena->scratchSize / sizeof(JsonMember);
+            }
+
+            JsonMember * member = &pending[pendingCount++];
+
+            member->key = key;
+            member->keyLength = keyLength;
+
+            key = NULL;
+            keyLength = 0;
+
+            if(token == JSON_TOKEN_OBJECT_START || token == JSON_TOKEN_ARRAY_START) {
+                // Remember the parent in the length until the container is closed.
+                member->value.type = (token == JSON_TOKEN_OBJECT_START ? JSON_VALUE_OBJECT : JSON_VALUE_ARRAY);
+                member->value.length = container;
+
+                container = pendingCount - 1;
+
+                state = (token == JSON_TOKEN_OBJECT_START ? JSON_DOCUMENT_EXPECT_KEY_OR_END : JSON_DOCUMENT_EXPECT_VALUE_OR_END);
+                continue;
+            }
+
+            *error = json_document_readScalar(tokenizer, arena, token, &member->value);
+
+            if(*error != JSON_SUCCESS)
+                return NULL;
+
+            state = (container == JSON_DOCUMENT_NO_PARENT ? JSON_DOCUMENT_DONE : JSON_DOCUMENT_EXPECT_COMMA_OR_END);
+            continue;
+        }
+
+        // Close the innermost container, moving its children into the arena.
+        closeContainer:
+        {
+            JsonValue * value = &pending[container].value;
+
+            JsonValueType expectedType = (token == JSON_TOKEN_OBJECT_END ? JSON_VALUE_OBJECT : JSON_VALUE_ARRAY);
+
+            if(value->type != expectedType) {
+                *error = JSON_ERROR_UNEXPECTED_TOKEN;
+                return NULL;
+            }
+
+            size_t parent = value->length;
+            size_t count = pendingCount - container - 1;
+
+            JsonMember * children = &pending[container + 1];
+
+            if(value->type == JSON_VALUE_OBJECT) {
+                value->as.members = (JsonMember *) json_arena_alloc(arena, count * sizeof(JsonMember), error);
+
+                if(value->as.members == NULL)
+                    return NULL;
+
+                memcpy(value->as.members, children, count * sizeof(JsonMember));
+            } else {
+                value->as.elements = (JsonValue *) json_arena_alloc(arena, count * sizeof(JsonValue), error);
+
+                if(value->as.elements == NULL)
+                    return NULL;
+
+                for(size_t index = 0; index < count; index++) {
+                    value->as.elements[index] = children[index].value;
+                }
+            }
+
+            value->length = count;
+
+            pendingCount = container + 1;
+            container = parent;
+
+            state = (container == JSON_DOCUMENT_NO_PARENT ? JSON_DOCUMENT_DONE : JSON_DOCUMENT_EXPECT_COMMA_OR_END);
+        }
+    }
+
+    document->root = pending[0].value;
+
+    *error = JSON_SUCCESS;
+
+    return document;
+}
+
+/*
+ * Get the root value of the document.
+ */
+JsonValue * json_document_getRoot(JsonDocument * document) {
+    return &document->root;
+}
+
+/*
+ * Get the type of the value.
+ */
+JsonValueType json_value_getType(JsonValue * value) {
+    return value->type;
+}
+
+/*
+ * Get the number of characters in a string or big number, or the number of children of an object or array.
+ */
+size_t json_value_getLength(JsonValue * value) {
+    return value->length;
+}
+
+/*
+ * Get the element at index in an array.
+ */
+JsonValue * json_value_getElement(JsonValue * array, size_t index) {
+    return &array->as.elements[index];
+}
+
+/*
+ * Get the key of the member at index in an object.
+ */
+char * json_value_getKey(JsonValue * object, size_t index) {
+    return object->as.members[index].key;
+}
+
+/*
+ * Get the value of the member at index in an object.
+ */
+JsonValue * json_value_getMember(JsonValue * object, size_t index) {
+    return &object->as.members[index].value;
+}
+
+/*
+ * Get the value of the first member of an object with the key, or NULL if there is no such member.
+ */
+JsonValue * json_value_find(JsonValue * object, char * key) {
+    size_t keyLength = strlen(key);
+
+    for(size_t index = 0; index < object->length; index++) {
+        JsonMember * member = &object->as.members[index];
+
+        if(member->keyLength == keyLength && memcmp(member->key, key, keyLength) == 0) {
+            return &member->value;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Get the null terminated characters of a string or big number.
+ */
+char * json_value_getString(JsonValue * value) {
+    return value->as.string;
+}
+
+/*
+ * Get the value of an integer.
+ */
+long int json_value_getInteger(JsonValue * value) {
+    return value->as.integer;
+}
+
+/*
+ * Get the value of a decimal number.
+ */
+double json_value_getDecimal(JsonValue * value) {
+    return value->as.decimal;
+}
+
+/*
+ * Get the value of a boolean.
+ */
+bool json_value_getBoolean(JsonValue * value) {
+    return value->as.boolean;
+}
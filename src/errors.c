@@ -3,6 +3,8 @@
 #include <stdlib.h>
 
 #include "errors_internal.h"
+#include "buffer_internal.h"
+#include "allocator_internal.h"
 
 /*
  * Used as a prefix for all log messages
@@ -48,6 +50,42 @@ char * json_error_name(JsonError error) {
             return "Expected false";
         case JSON_ERROR_EXPECTED_NULL:
             return "Expected null";
+        case JSON_ERROR_MAP_FILE:
+            return "Error memory mapping file";
+        case JSON_ERROR_UNMAP_FILE:
+            return "Error unmapping file";
+        case JSON_ERROR_FILE_TOO_LARGE:
+            return "Input is too large to be buffered";
+        case JSON_ERROR_UNEXPECTED_TOKEN:
+            return "Unexpected token";
+        case JSON_ERROR_UNSUPPORTED_BUFFER:
+            return "Not supported by this type of buffer";
+        case JSON_ERROR_NEED_MORE:
+            return "More input is needed";
+        case JSON_ERROR_CREATE_THREAD:
+            return "Unable to create thread";
+        case JSON_ERROR_MAX_DEPTH:
+            return "Nested too deeply";
+        case JSON_ERROR_ABORTED:
+            return "Stopped by a handler";
+        case JSON_ERROR_INVALID_UTF8:
+            return "Invalid UTF-8 in text";
+        case JSON_ERROR_WRITE_FILE:
+            return "Unable to write file";
+        case JSON_ERROR_NON_FINITE_NUMBER:
+            return "Infinity and NaN cannot be written as JSON";
+        case JSON_ERROR_STATS_DISABLED:
+            return "Statistics were not compiled in, build with JSON_STATS";
+        case JSON_ERROR_NOT_FOUND:
+            return "Key not found in object";
+        case JSON_ERROR_OUT_OF_ORDER:
+            return "Value read after the parser moved past it";
+        case JSON_ERROR_INVALID_POINTER:
+            return "Invalid JSON Pointer";
+        case JSON_ERROR_SEEK:
+            return "Unable to seek to the offset in the input";
+        case JSON_ERROR_OUT_OF_RANGE:
+            return "Value does not fit in the field it is decoded into";
         default:
             return "Unknown error code";
     }
@@ -103,7 +141,7 @@ void json_error_printContext(FILE * stream, JsonBuffer * buffer) {
  * Prints the characters around the current buffer index to the stream with a prefix put on each line.
  */
 void json_error_printContext_internal(FILE * stream, JsonBuffer * buffer, char * prefix) {
-    int currentCharIndex;
+    size_t currentCharIndex;
     JsonError error;
 
     char * charactersAround = json_buffer_getCharactersAroundCurrent(buffer, &currentCharIndex, &error);
@@ -117,12 +155,12 @@ void json_error_printContext_internal(FILE * stream, JsonBuffer * buffer, char *
 
     fprintf(stream, JSON_LOG_PREFIX "%s%s\n", prefix, charactersAround);
 
-    char * currentCharacterIndicator = (char *) malloc((size_t) (currentCharIndex + 2));
+    char * currentCharacterIndicator = (char *) json_allocator_alloc(&buffer->allocator, currentCharIndex + 2);
 
     if(currentCharacterIndicator == NULL) {
         fprintf(stream, JSON_LOG_PREFIX "%sError allocating string for current character indicator.\n", prefix);
 
-        free(charactersAround);
+        json_allocator_free(&buffer->allocator, charactersAround);
         return;
     }
 
@@ -133,8 +171,8 @@ void json_error_printContext_internal(FILE * stream, JsonBuffer * buffer, char *
 
     fprintf(stream, JSON_LOG_PREFIX "%s%s\n", prefix, currentCharacterIndicator);
 
-    free(charactersAround);
-    free(currentCharacterIndicator);
+    json_allocator_free(&buffer->allocator, charactersAround);
+    json_allocator_free(&buffer->allocator, currentCharacterIndicator);
 }
 
 /*
@@ -0,0 +1,711 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "json.h"
+#include "characters.h"
+
+/*
+ * Marks the start of a sidecar index, along with the version of its layout.
+ */
+#define JSON_INDEX_MAGIC "JSONIDX1"
+
+/*
+ * Added to the name of a file to get the name of its sidecar index.
+ */
+#define JSON_INDEX_SUFFIX ".index"
+
+#define JSON_INDEX_BUFFER_SIZE (1024 * 1024)
+#define JSON_INDEX_HISTORY 10
+
+typedef struct IndexHeader IndexHeader;
+
+typedef struct IndexBuilder IndexBuilder;
+
+/*
+ * The start of a sidecar index.
+ *
+ * It is followed by the offsets of the top-level values, the offsets of the children of the top-level value if there
+ * is only one, the end of the key of each child in the keys if that value is an object, and then the keys.
+ */
+struct IndexHeader {
+    char magic[8];
+
+    // The size and modification time of the file when it was indexed, which it has to still have for the index to be used.
+    uint64_t fileSize;
+    int64_t modifiedSeconds;
+    int64_t modifiedNanoseconds;
+
+    uint64_t valueCount;
+    uint64_t childCount;
+    uint64_t keysLength;
+
+    // The token starting the top-level value if there is only one, otherwise JSON_TOKEN_EOF.
+    uint32_t token;
+    uint32_t unused;
+};
+
+/*
+ * A sidecar index read into memory, or built and written.
+ */
+struct JsonIndex {
+    // The whole of the index as it is kept in the sidecar, which everything below points into.
+    char * contents;
+
+    IndexHeader * header;
+
+    int64_t * values;
+    int64_t * children;
+    uint64_t * keyEnds;
+    char * keys;
+
+    // The hash table of the first child with each key, each slot holding one more than the index of the child, or 0 when empty.
+    size_t * slots;
+    size_t mask;
+};
+
+/*
+ * The offsets and keys found while tokenizing a file, grown as they are found.
+ */
+struct IndexBuilder {
+    int64_t * values;
+    size_t valueCount;
+    size_t valueCapacity;
+
+    int64_t * children;
+    size_t childCount;
+    size_t childCapacity;
+
+    uint64_t * keyEnds;
+    size_t keyEndCapacity;
+
+    char * keys;
+    size_t keysLength;
+    size_t keysCapacity;
+};
+
+/*
+ * Makes room in an array for at least needed items of size bytes, doubling its capacity.
+ */
+static JsonError json_index_reserve(void ** array, size_t * capacity, size_t needed, size_t size) {
+    if(needed <= *capacity) {
+        return JSON_SUCCESS;
+    }
+
+    size_t grown = (*capacity > 0 ? *capacity * 2 : 256);
+
+    while(grown < needed) {
+        grown *= 2;
+    }
+
+    void * resized = realloc(*array, grown * size);
+
+    if(resized == NULL) {
+        return JSON_ERROR_REALLOC;
+    }
+
+    *array = resized;
+    *capacity = grown;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Adds the offset of a top-level value.
+ */
+static JsonError json_index_addValue(IndexBuilder * builder, int64_t offset) {
+    JsonError error = json_index_reserve((void **) &builder->values, &builder->valueCapacity, builder->valueCount + 1, sizeof(int64_t));
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    builder->values[builder->valueCount++] = offset;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Adds the offset of a child of the first top-level value, along with its key if it is a member of an object.
+ */
+static JsonError json_index_addChild(IndexBuilder * builder, int64_t offset, const char * key, size_t length) {
+    JsonError error = json_index_reserve((void **) &builder->children, &builder->childCapacity, builder->childCount + 1, sizeof(int64_t));
+
+    if(error == JSON_SUCCESS) {
+        error = json_index_reserve((void **) &builder->keyEnds, &builder->keyEndCapacity, builder->childCount + 1, sizeof(uint64_t));
+    }
+
+    if(error == JSON_SUCCESS) {
+        error = json_index_reserve((void **) &builder->keys, &builder->keysCapacity, builder->keysLength + length, 1);
+    }
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    if(length > 0) {
+        memcpy(&builder->keys[builder->keysLength], key, length);
+        builder->keysLength += length;
+    }
+
+    builder->children[builder->childCount] = offset;
+    builder->keyEnds[builder->childCount] = builder->keysLength;
+    builder->childCount++;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Gets the error for a token read where another one was expected.
+ */
+static JsonError json_index_unexpected(TokenizerHandle * tokenizer, TokenType token) {
+    if(token == JSON_TOKEN_ERROR) {
+        return json_tokenizer_getError(tokenizer);
+    }
+
+    return (token == JSON_TOKEN_EOF ? JSON_ERROR_EOF : JSON_ERROR_UNEXPECTED_TOKEN);
+}
+
+/*
+ * Finds the offset of each child of the object or array just started, skipping over the values themselves.
+ */
+static JsonError json_index_scanChildren(TokenizerHandle * tokenizer, IndexBuilder * builder, TokenType container) {
+    JsonBuffer * buffer = json_tokenizer_getBuffer(tokenizer);
+
+    TokenType end = (container == JSON_TOKEN_OBJECT_START ? JSON_TOKEN_OBJECT_END : JSON_TOKEN_ARRAY_END);
+    bool first = true;
+
+    while(true) {
+        const char * key = NULL;
+        size_t length = 0;
+
+        if(container == JSON_TOKEN_OBJECT_START) {
+            TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+            if(token == end && first) {
+                return JSON_SUCCESS;
+            } else if(token != JSON_TOKEN_TEXT) {
+                return json_index_unexpected(tokenizer, token);
+            }
+
+            json_tokenizer_getStringSlice(tokenizer, &key, &length);
+
+            // The key is copied before the colon is read, as reading it can replace the key.
+            JsonError error = json_index_addChild(builder, 0, key, length);
+
+            if(error != JSON_SUCCESS)
+                return error;
+
+            token = json_tokenizer_readNextToken(tokenizer);
+
+            if(token != JSON_TOKEN_COLON) {
+                return json_index_unexpected(tokenizer, token);
+            }
+
+            builder->children[builder->childCount - 1] = json_buffer_getOffset(buffer);
+        }
+
+        int64_t offset = json_buffer_getOffset(buffer);
+
+        JsonError error = json_tokenizer_skipValue(tokenizer);
+
+        // An empty array ends where its first element would start.
+        if(error == JSON_ERROR_UNEXPECTED_TOKEN && first && container == JSON_TOKEN_ARRAY_START) {
+            TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+            return (token == end ? JSON_SUCCESS : json_index_unexpected(tokenizer, token));
+        } else if(error != JSON_SUCCESS) {
+            return error;
+        }
+
+        if(container == JSON_TOKEN_ARRAY_START) {
+            error = json_index_addChild(builder, offset, NULL, 0);
+
+            if(error != JSON_SUCCESS)
+                return error;
+        }
+
+        first = false;
+
+        TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+        if(token == end) {
+            return JSON_SUCCESS;
+        } else if(token != JSON_TOKEN_COMMA) {
+            return json_index_unexpected(tokenizer, token);
+        }
+    }
+}
+
+/*
+ * Tokenizes the whole of the input, finding the offset of every top-level value and, if there is only one,
+ * of its children, returning the token that starts it or JSON_TOKEN_EOF if there is not only one.
+ *
+ * Only the top two levels are tokenized, and the values below them are skipped without being fully validated.
+ */
+static JsonError json_index_scan(TokenizerHandle * tokenizer, IndexBuilder * builder, TokenType * only) {
+    JsonBuffer * buffer = json_tokenizer_getBuffer(tokenizer);
+
+    int64_t offset = json_buffer_getOffset(buffer);
+    TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+    *only = JSON_TOKEN_EOF;
+
+    if(token == JSON_TOKEN_EOF) {
+        return JSON_SUCCESS;
+    }
+
+    bool container = (token == JSON_TOKEN_OBJECT_START || token == JSON_TOKEN_ARRAY_START);
+
+    if(!container && (token < JSON_TOKEN_TEXT || token > JSON_TOKEN_NULL)) {
+        return json_index_unexpected(tokenizer, token);
+    }
+
+    JsonError error = json_index_addValue(builder, offset);
+
+    if(error == JSON_SUCCESS && container) {
+        error = json_index_scanChildren(tokenizer, builder, token);
+    }
+
+    // Any further values, as in newline delimited JSON, are only skipped over.
+    while(error == JSON_SUCCESS) {
+        offset = json_buffer_getOffset(buffer);
+        error = json_tokenizer_skipValue(tokenizer);
+
+        if(error == JSON_SUCCESS) {
+            error = json_index_addValue(builder, offset);
+        }
+    }
+
+    if(error != JSON_ERROR_EOF) {
+        return error;
+    }
+
+    if(builder->valueCount == 1) {
+        *only = token;
+    } else {
+        builder->childCount = 0;
+        builder->keysLength = 0;
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Points the index into its contents, checking that they are laid out as the header says and were made for the
+ * file with the status passed, and builds the hash table of the keys.
+ *
+ * Returns JSON_ERROR_READ_FILE if the contents cannot be used, which takes over the contents either way.
+ */
+static JsonError json_index_attach(JsonIndex * index, char * contents, size_t length, const struct stat * status) {
+    index->contents = contents;
+
+    if(length < sizeof(IndexHeader)) {
+        return JSON_ERROR_READ_FILE;
+    }
+
+    IndexHeader * header = (IndexHeader *) contents;
+
+    if(memcmp(header->magic, JSON_INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+       header->fileSize != (uint64_t) status->st_size ||
+       header->modifiedSeconds != (int64_t) status->st_mtim.tv_sec ||
+       header->modifiedNanoseconds != (int64_t) status->st_mtim.tv_nsec) {
+        return JSON_ERROR_READ_FILE;
+    }
+
+    // The counts are checked against the length first, so that adding up the size of the arrays cannot overflow.
+    size_t available = (length - sizeof(IndexHeader)) / sizeof(int64_t);
+
+    if(header->valueCount > available || header->childCount > available || header->keysLength > length) {
+        return JSON_ERROR_READ_FILE;
+    }
+
+    size_t keyCount = (header->token == JSON_TOKEN_OBJECT_START ? header->childCount : 0);
+
+    if(sizeof(IndexHeader) + (header->valueCount + header->childCount + keyCount) * sizeof(int64_t) + header->keysLength != length) {
+        return JSON_ERROR_READ_FILE;
+    }
+
+    index->header = header;
+    index->values = (int64_t *) &header[1];
+    index->children = &index->values[header->valueCount];
+    index->keyEnds = (uint64_t *) &index->children[header->childCount];
+    index->keys = (char *) &index->keyEnds[keyCount];
+
+    for(size_t key = 0; key < keyCount; key++) {
+        if(index->keyEnds[key] > header->keysLength || (key > 0 && index->keyEnds[key] < index->keyEnds[key - 1])) {
+            return JSON_ERROR_READ_FILE;
+        }
+    }
+
+    // Keep at least twice as many slots as keys, so that probes stay short.
+    size_t slotCount = 1;
+
+    while(slotCount < keyCount * 2) {
+        slotCount *= 2;
+    }
+
+    index->slots = (size_t *) calloc(slotCount, sizeof(size_t));
+    index->mask = slotCount - 1;
+
+    if(index->slots == NULL) {
+        return JSON_ERROR_MALLOC;
+    }
+
+    for(size_t key = 0; key < keyCount; key++) {
+        size_t start = (key > 0 ? index->keyEnds[key - 1] : 0);
+        size_t keyLength = index->keyEnds[key] - start;
+
+        size_t slot = json_char_hash(&index->keys[start], keyLength) & index->mask;
+
+        while(index->slots[slot] != 0) {
+            size_t other = index->slots[slot] - 1;
+            size_t otherStart = (other > 0 ? index->keyEnds[other - 1] : 0);
+
+            // Only the first member with a key is found, as with json_value_find.
+            if(index->keyEnds[other] - otherStart == keyLength && memcmp(&index->keys[otherStart], &index->keys[start], keyLength) == 0) {
+                break;
+            }
+
+            slot = (slot + 1) & index->mask;
+        }
+
+        if(index->slots[slot] == 0) {
+            index->slots[slot] = key + 1;
+        }
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Reads the sidecar index at path, if there is one that was made for the file with the status passed.
+ */
+static JsonError json_index_load(JsonIndex * index, const char * path, const struct stat * status) {
+    int file = open(path, O_RDONLY);
+
+    if(file == -1) {
+        return JSON_ERROR_OPEN_FILE;
+    }
+
+    struct stat sidecar;
+
+    if(fstat(file, &sidecar) == -1) {
+        close(file);
+        return JSON_ERROR_READ_FILE;
+    }
+
+    size_t length = (size_t) sidecar.st_size;
+    char * contents = (char *) malloc(length > 0 ? length : 1);
+
+    if(contents == NULL) {
+        close(file);
+        return JSON_ERROR_MALLOC;
+    }
+
+    size_t done = 0;
+
+    while(done < length) {
+        ssize_t count = read(file, &contents[done], length - done);
+
+        if(count <= 0) {
+            break;
+        }
+
+        done += (size_t) count;
+    }
+
+    close(file);
+
+    if(done < length) {
+        free(contents);
+        return JSON_ERROR_READ_FILE;
+    }
+
+    return json_index_attach(index, contents, length, status);
+}
+
+/*
+ * Copies one of the arrays of the builder into the contents of an index, returning where the next one goes.
+ *
+ * Arrays that nothing was added to were never allocated, so they are not copied at all.
+ */
+static char * json_index_copy(char * next, const void * array, size_t size) {
+    if(size > 0) {
+        memcpy(next, array, size);
+    }
+
+    return next + size;
+}
+
+/*
+ * Builds the index of the file with the status passed by tokenizing it.
+ */
+static JsonError json_index_build(JsonIndex * index, char * file, const struct stat * status) {
+    JsonError error;
+
+    JsonBuffer * buffer = json_bufferedFile_openAhead(file, JSON_INDEX_BUFFER_SIZE, JSON_INDEX_HISTORY, 2, &error);
+
+    if(buffer == NULL) {
+        return error;
+    }
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(buffer, &error);
+
+    if(tokenizer == NULL) {
+        json_buffer_destroy(buffer);
+        return error;
+    }
+
+    IndexBuilder builder = {0};
+    TokenType only;
+
+    error = json_index_scan(tokenizer, &builder, &only);
+
+    json_tokenizer_destroy(tokenizer);
+
+    size_t keyCount = (only == JSON_TOKEN_OBJECT_START ? builder.childCount : 0);
+    size_t length = sizeof(IndexHeader) + (builder.valueCount + builder.childCount + keyCount) * sizeof(int64_t) + builder.keysLength;
+
+    char * contents = NULL;
+
+    if(error == JSON_SUCCESS) {
+        contents = (char *) malloc(length);
+
+        if(contents == NULL) {
+            error = JSON_ERROR_MALLOC;
+        }
+    }
+
+    if(error == JSON_SUCCESS) {
+        IndexHeader * header = (IndexHeader *) contents;
+
+        memset(header, 0, sizeof(IndexHeader));
+        memcpy(header->magic, JSON_INDEX_MAGIC, sizeof(header->magic));
+
+        header->fileSize = (uint64_t) status->st_size;
+        header->modifiedSeconds = (int64_t) status->st_mtim.tv_sec;
+        header->modifiedNanoseconds = (int64_t) status->st_mtim.tv_nsec;
+
+        header->valueCount = builder.valueCount;
+        header->childCount = builder.childCount;
+        header->keysLength = builder.keysLength;
+        header->token = (uint32_t) only;
+
+        char * next = (char *) &header[1];
+
+        next = json_index_copy(next, builder.values, builder.valueCount * sizeof(int64_t));
+        next = json_index_copy(next, builder.children, builder.childCount * sizeof(int64_t));
+        next = json_index_copy(next, builder.keyEnds, keyCount * sizeof(uint64_t));
+        json_index_copy(next, builder.keys, builder.keysLength);
+
+        error = json_index_attach(index, contents, length, status);
+    }
+
+    free(builder.values);
+    free(builder.children);
+    free(builder.keyEnds);
+    free(builder.keys);
+
+    return error;
+}
+
+/*
+ * Writes the index to the sidecar at path, by way of a temporary file renamed over it so that other readers
+ * never see part of an index.
+ */
+static JsonError json_index_save(JsonIndex * index, const char * path) {
+    size_t length = strlen(path);
+    char * temporary = (char *) malloc(length + sizeof(".tmp"));
+
+    if(temporary == NULL) {
+        return JSON_ERROR_MALLOC;
+    }
+
+    memcpy(temporary, path, length);
+    memcpy(&temporary[length], ".tmp", sizeof(".tmp"));
+
+    int file = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(file == -1) {
+        free(temporary);
+        return JSON_ERROR_OPEN_FILE;
+    }
+
+    IndexHeader * header = index->header;
+    size_t keyCount = (header->token == JSON_TOKEN_OBJECT_START ? header->childCount : 0);
+    size_t size = sizeof(IndexHeader) + (header->valueCount + header->childCount + keyCount) * sizeof(int64_t) + header->keysLength;
+
+    JsonError error = JSON_SUCCESS;
+
+    for(size_t done = 0; done < size && error == JSON_SUCCESS;) {
+        ssize_t count = write(file, &index->contents[done], size - done);
+
+        if(count <= 0) {
+            error = JSON_ERROR_WRITE_FILE;
+        } else {
+            done += (size_t) count;
+        }
+    }
+
+    if(close(file) == -1 && error == JSON_SUCCESS) {
+        error = JSON_ERROR_CLOSE_FILE;
+    }
+
+    if(error == JSON_SUCCESS && rename(temporary, path) == -1) {
+        error = JSON_ERROR_WRITE_FILE;
+    }
+
+    if(error != JSON_SUCCESS) {
+        unlink(temporary);
+    }
+
+    free(temporary);
+
+    return error;
+}
+
+/*
+ * Opens the index of a file, kept in a sidecar next to it named after it with .index added, so that the
+ * top-level values and the children of the top-level value can be seeked to without tokenizing up to them.
+ *
+ * If there is no sidecar, or it was made for a file of another size or modification time, the file is tokenized
+ * to build the index and the sidecar is written. Only the top two levels are tokenized, the values below them
+ * are only skipped over, and writing the sidecar is allowed to fail, in which case the next open builds it again.
+ */
+JsonIndex * json_index_open(char * file, JsonError * error) {
+    struct stat status;
+
+    if(stat(file, &status) == -1) {
+        *error = JSON_ERROR_OPEN_FILE;
+        return NULL;
+    }
+
+    size_t length = strlen(file);
+    char * path = (char *) malloc(length + sizeof(JSON_INDEX_SUFFIX));
+    JsonIndex * index = (JsonIndex *) calloc(1, sizeof(JsonIndex));
+
+    if(path == NULL || index == NULL) {
+        free(path);
+        free(index);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    memcpy(path, file, length);
+    memcpy(&path[length], JSON_INDEX_SUFFIX, sizeof(JSON_INDEX_SUFFIX));
+
+    *error = json_index_load(index, path, &status);
+
+    if(*error != JSON_SUCCESS) {
+        free(index->contents);
+        free(index->slots);
+        memset(index, 0, sizeof(JsonIndex));
+
+        *error = json_index_build(index, file, &status);
+
+        if(*error == JSON_SUCCESS) {
+            json_index_save(index, path);
+        }
+    }
+
+    free(path);
+
+    if(*error != JSON_SUCCESS) {
+        json_index_destroy(index);
+        return NULL;
+    }
+
+    return index;
+}
+
+/*
+ * Frees the index.
+ */
+void json_index_destroy(JsonIndex * index) {
+    free(index->contents);
+    free(index->slots);
+    free(index);
+}
+
+/*
+ * Gets the offsets of the records, which are the top-level values if there are several, as in newline delimited JSON,
+ * or the elements of the top-level array otherwise.
+ */
+static const int64_t * json_index_getRecords(JsonIndex * index, size_t * count) {
+    if(index->header->token == JSON_TOKEN_ARRAY_START) {
+        *count = index->header->childCount;
+        return index->children;
+    }
+
+    *count = index->header->valueCount;
+    return index->values;
+}
+
+/*
+ * Gets the number of records in the file, which are the top-level values if there are several, as in newline
+ * delimited JSON, or the elements of the top-level array otherwise.
+ */
+size_t json_index_getRecordCount(JsonIndex * index) {
+    size_t count;
+    json_index_getRecords(index, &count);
+
+    return count;
+}
+
+/*
+ * Moves the tokenizer to an offset in its input and starts reading from there.
+ */
+static JsonError json_index_seek(TokenizerHandle * tokenizer, int64_t offset) {
+    JsonError error = json_buffer_seek(json_tokenizer_getBuffer(tokenizer), offset);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    return json_tokenizer_reset(tokenizer, NULL);
+}
+
+/*
+ * Moves a tokenizer reading the indexed file to the start of a record, so that the next tokens read are its value.
+ *
+ * Reading carries on past the value into the rest of the file, so the value should be read on its own,
+ * for example with json_document_parse or json_tokenizer_skipValue.
+ * Returns JSON_ERROR_NOT_FOUND if there are not that many records.
+ */
+JsonError json_index_seekRecord(JsonIndex * index, TokenizerHandle * tokenizer, size_t record) {
+    size_t count;
+    const int64_t * records = json_index_getRecords(index, &count);
+
+    if(record >= count) {
+        return JSON_ERROR_NOT_FOUND;
+    }
+
+    return json_index_seek(tokenizer, records[record]);
+}
+
+/*
+ * Moves a tokenizer reading the indexed file to the value of the first member with the key in the top-level object,
+ * in the same way as json_index_seekRecord.
+ *
+ * Returns JSON_ERROR_NOT_FOUND if there is no such member, or the top-level value is not an object.
+ */
+JsonError json_index_seekKey(JsonIndex * index, TokenizerHandle * tokenizer, const char * key) {
+    if(index->header->token != JSON_TOKEN_OBJECT_START) {
+        return JSON_ERROR_NOT_FOUND;
+    }
+
+    size_t length = strlen(key);
+
+    for(size_t slot = json_char_hash(key, length) & index->mask; index->slots[slot] != 0; slot = (slot + 1) & index->mask) {
+        size_t child = index->slots[slot] - 1;
+        size_t start = (child > 0 ? index->keyEnds[child - 1] : 0);
+
+        if(index->keyEnds[child] - start == length && memcmp(&index->keys[start], key, length) == 0) {
+            return json_index_seek(tokenizer, index->children[child]);
+        }
+    }
+
+    return JSON_ERROR_NOT_FOUND;
+}
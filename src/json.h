@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "characters.h"
 
 //
@@ -26,20 +28,81 @@ enum JsonError {
     JSON_ERROR_INVALID_UNICODE_ESCAPED_CHAR,
     JSON_ERROR_EXPECTED_TRUE,
     JSON_ERROR_EXPECTED_FALSE,
-    JSON_ERROR_EXPECTED_NULL
+    JSON_ERROR_EXPECTED_NULL,
+    JSON_ERROR_MAP_FILE,
+    JSON_ERROR_UNMAP_FILE,
+    JSON_ERROR_FILE_TOO_LARGE,
+    JSON_ERROR_UNEXPECTED_TOKEN,
+    JSON_ERROR_UNSUPPORTED_BUFFER,
+    JSON_ERROR_NEED_MORE,
+    JSON_ERROR_CREATE_THREAD,
+    JSON_ERROR_MAX_DEPTH,
+    JSON_ERROR_ABORTED,
+    JSON_ERROR_INVALID_UTF8,
+    JSON_ERROR_WRITE_FILE,
+    JSON_ERROR_NON_FINITE_NUMBER,
+    JSON_ERROR_STATS_DISABLED,
+    JSON_ERROR_NOT_FOUND,
+    JSON_ERROR_OUT_OF_ORDER,
+    JSON_ERROR_INVALID_POINTER,
+    JSON_ERROR_SEEK,
+    JSON_ERROR_OUT_OF_RANGE
 };
 
 char * json_error_name(JsonError error);
 
+//
+// Json Allocators
+//
+
+typedef struct JsonAllocator JsonAllocator;
+
+struct JsonAllocator {
+    void * (*alloc)(size_t size, void * context);
+    void * (*realloc)(void * pointer, size_t size, void * context);
+    void (*free)(void * pointer, void * context);
+    void * context;
+};
+
+const JsonAllocator * json_allocator_getDefault(void);
+
+JsonAllocator json_allocator_createFixed(void * memory, size_t size);
+
 //
 // Json Buffers
 //
 
 typedef struct JsonBuffer JsonBuffer;
 
-JsonBuffer * json_bufferFixed_create(char * buffer, int bufferSize, int history, JsonError * error);
+JsonBuffer * json_bufferFixed_create(char * buffer, size_t bufferSize, size_t history, JsonError * error);
+
+JsonBuffer * json_bufferedFile_open(char * file, size_t bufferSize, size_t history, JsonError * error);
+
+JsonBuffer * json_bufferedFile_openAhead(char * file, size_t bufferSize, size_t history, int blocks, JsonError * error);
+
+JsonBuffer * json_bufferMapped_open(char * file, size_t history, bool hugePages, JsonError * error);
+
+JsonBuffer * json_bufferPush_create(size_t bufferSize, size_t history, JsonError * error);
 
-JsonBuffer * json_bufferedFile_open(char * file, int bufferSize, int history, JsonError * error);
+JsonBuffer * json_bufferFixed_createWith(char * buffer, size_t bufferSize, size_t history, const JsonAllocator * allocator, JsonError * error);
+
+JsonBuffer * json_bufferedFile_openWith(char * file, size_t bufferSize, size_t history, const JsonAllocator * allocator, JsonError * error);
+
+JsonBuffer * json_bufferedFile_openAheadWith(char * file, size_t bufferSize, size_t history, int blocks, const JsonAllocator * allocator, JsonError * error);
+
+JsonBuffer * json_bufferMapped_openWith(char * file, size_t history, bool hugePages, const JsonAllocator * allocator, JsonError * error);
+
+JsonBuffer * json_bufferPush_createWith(size_t bufferSize, size_t history, const JsonAllocator * allocator, JsonError * error);
+
+JsonError json_bufferPush_append(JsonBuffer * buffer, const char * data, size_t length);
+
+JsonError json_bufferPush_finish(JsonBuffer * buffer);
+
+JsonError json_bufferFixed_reset(JsonBuffer * buffer, char * contents, size_t bufferSize);
+
+JsonError json_bufferedFile_reset(JsonBuffer * buffer, char * file);
+
+JsonError json_bufferPush_reset(JsonBuffer * buffer);
 
 JsonError json_buffer_destroy(JsonBuffer * buffer);
 
@@ -47,7 +110,11 @@ JsonError json_buffer_fill(JsonBuffer * buffer);
 
 char json_buffer_getLastCharacter(JsonBuffer * buffer);
 
-char * json_buffer_getCharactersAroundCurrent(JsonBuffer * buffer, int * currentCharIndex, JsonError * error);
+int64_t json_buffer_getOffset(JsonBuffer * buffer);
+
+JsonError json_buffer_seek(JsonBuffer * buffer, int64_t offset);
+
+char * json_buffer_getCharactersAroundCurrent(JsonBuffer * buffer, size_t * currentCharIndex, JsonError * error);
 
 //
 // Json Error Logging
@@ -63,6 +130,18 @@ void json_error_printReason(FILE * stream, JsonError error);
 
 void json_error_printContext(FILE * stream, JsonBuffer * buffer);
 
+//
+// Json Keys
+//
+
+typedef struct JsonKeys JsonKeys;
+
+JsonKeys * json_keys_create(const char * const * keys, int count, JsonError * error);
+
+void json_keys_destroy(JsonKeys * keys);
+
+int json_keys_find(const JsonKeys * keys, const char * key, size_t length);
+
 //
 // Json Tokenizer
 //
@@ -71,6 +150,10 @@ typedef struct TokenizerHandle TokenizerHandle;
 
 typedef enum TokenType TokenType;
 
+typedef enum TokenizerEngine TokenizerEngine;
+
+typedef struct TokenizerStats TokenizerStats;
+
 enum TokenType {
     JSON_TOKEN_ERROR,
 
@@ -88,23 +171,66 @@ enum TokenType {
     JSON_TOKEN_TRUE,
     JSON_TOKEN_FALSE,
     JSON_TOKEN_NULL,
-    JSON_TOKEN_EOF
+    JSON_TOKEN_EOF,
+    JSON_TOKEN_NEED_MORE
 };
 
 char * json_token_name(TokenType token);
 
-TokenizerHandle * json_tokenizer_openFile(char * file, int bufferSize, int history, JsonError * error);
+enum TokenizerEngine {
+    JSON_ENGINE_STREAMING,
+    JSON_ENGINE_INDEXED
+};
+
+char * json_engine_name(TokenizerEngine engine);
+
+struct TokenizerStats {
+    size_t fills;
+    size_t bytesRead;
+    size_t historyMoved;
+    size_t valueBufferReallocs;
+    size_t valueBufferPeak;
+    size_t tokens[JSON_TOKEN_NEED_MORE + 1];
+    size_t escapes;
+    size_t whitespace;
+};
+
+TokenizerHandle * json_tokenizer_openFile(char * file, size_t bufferSize, size_t history, JsonError * error);
+
+TokenizerHandle * json_tokenizer_openMappedFile(char * file, size_t history, bool hugePages, JsonError * error);
+
+TokenizerHandle * json_tokenizer_createPush(size_t bufferSize, size_t history, JsonError * error);
 
 TokenizerHandle * json_tokenizer_create(JsonBuffer * buffer, JsonError * error);
 
 JsonError json_tokenizer_destroy(TokenizerHandle * tokenizer);
 
+JsonError json_tokenizer_reset(TokenizerHandle * tokenizer, JsonBuffer * buffer);
+
+JsonError json_tokenizer_setEngine(TokenizerHandle * tokenizer, TokenizerEngine engine);
+
+TokenizerEngine json_tokenizer_getEngine(TokenizerHandle * tokenizer);
+
+JsonError json_tokenizer_feed(TokenizerHandle * tokenizer, const char * chunk, size_t length);
+
+JsonError json_tokenizer_finish(TokenizerHandle * tokenizer);
+
 TokenType json_tokenizer_readNextToken(TokenizerHandle * tokenizer);
 
+JsonError json_tokenizer_skipValue(TokenizerHandle * tokenizer);
+
 char * json_tokenizer_getStringValue(TokenizerHandle * tokenizer);
 
+void json_tokenizer_getStringSlice(TokenizerHandle * tokenizer, const char ** start, size_t * length);
+
+void json_tokenizer_setKeys(TokenizerHandle * tokenizer, const JsonKeys * keys);
+
+int json_tokenizer_getKeyId(TokenizerHandle * tokenizer);
+
 char * json_tokenizer_getNumberValue(TokenizerHandle * tokenizer);
 
+void json_tokenizer_getNumberSlice(TokenizerHandle * tokenizer, const char ** start, size_t * length);
+
 double json_tokenizer_getDecimalValue(TokenizerHandle * tokenizer);
 
 long json_tokenizer_getIntegerValue(TokenizerHandle * tokenizer);
@@ -113,4 +239,273 @@ JsonError json_tokenizer_getError(TokenizerHandle * tokenizer);
 
 JsonBuffer * json_tokenizer_getBuffer(TokenizerHandle * tokenizer);
 
-void json_tokenizer_logError(TokenizerHandle * tokenizer);
\ No newline at end of file
+void json_tokenizer_logError(TokenizerHandle * tokenizer);
+
+JsonError json_tokenizer_getStats(TokenizerHandle * tokenizer, TokenizerStats * stats);
+
+//
+// Json Tokenizer Pool
+//
+
+TokenizerHandle * json_tokenizerPool_acquire(char * contents, size_t bufferSize, size_t history, JsonError * error);
+
+JsonError json_tokenizerPool_release(TokenizerHandle * tokenizer);
+
+void json_tokenizerPool_clear(void);
+
+//
+// Json Arena
+//
+
+typedef struct JsonArena JsonArena;
+
+JsonArena * json_arena_create(size_t blockSize, JsonError * error);
+
+void json_arena_destroy(JsonArena * arena);
+
+void json_arena_reset(JsonArena * arena);
+
+void * json_arena_alloc(JsonArena * arena, size_t size, JsonError * error);
+
+//
+// Json Document
+//
+
+typedef struct JsonDocument JsonDocument;
+
+typedef struct JsonValue JsonValue;
+
+typedef enum JsonValueType JsonValueType;
+
+enum JsonValueType {
+    JSON_VALUE_OBJECT,
+    JSON_VALUE_ARRAY,
+    JSON_VALUE_STRING,
+    JSON_VALUE_INTEGER,
+    JSON_VALUE_DECIMAL,
+    JSON_VALUE_BIG_NUMBER,
+    JSON_VALUE_BOOLEAN,
+    JSON_VALUE_NULL
+};
+
+char * json_value_typeName(JsonValueType type);
+
+JsonDocument * json_document_parse(TokenizerHandle * tokenizer, JsonArena * arena, JsonError * error);
+
+JsonValue * json_document_getRoot(JsonDocument * document);
+
+JsonValueType json_value_getType(JsonValue * value);
+
+size_t json_value_getLength(JsonValue * value);
+
+JsonValue * json_value_getElement(JsonValue * array, size_t index);
+
+char * json_value_getKey(JsonValue * object, size_t index);
+
+JsonValue * json_value_getMember(JsonValue * object, size_t index);
+
+JsonValue * json_value_find(JsonValue * object, char * key);
+
+char * json_value_getString(JsonValue * value);
+
+long int json_value_getInteger(JsonValue * value);
+
+double json_value_getDecimal(JsonValue * value);
+
+bool json_value_getBoolean(JsonValue * value);
+
+//
+// Json On Demand
+//
+
+typedef struct OndemandParser OndemandParser;
+
+typedef struct OndemandValue OndemandValue;
+
+struct OndemandValue {
+    OndemandParser * parser;
+    int64_t start;
+    int depth;
+    unsigned int container;
+    TokenType token;
+    bool read;
+    bool first;
+};
+
+OndemandParser * json_ondemand_create(TokenizerHandle * tokenizer, int maxDepth, JsonError * error);
+
+void json_ondemand_destroy(OndemandParser * parser);
+
+JsonError json_ondemand_start(OndemandParser * parser, OndemandValue * root);
+
+JsonError json_ondemand_find(OndemandValue * object, const char * key, OndemandValue * value);
+
+JsonError json_ondemand_nextMember(OndemandValue * object, const char ** key, size_t * keyLength, OndemandValue * value);
+
+JsonError json_ondemand_nextElement(OndemandValue * array, OndemandValue * element);
+
+JsonError json_ondemand_getType(OndemandValue * value, JsonValueType * type);
+
+JsonError json_ondemand_getString(OndemandValue * value, const char ** string, size_t * length);
+
+JsonError json_ondemand_getInteger(OndemandValue * value, long int * integer);
+
+JsonError json_ondemand_getDecimal(OndemandValue * value, double * decimal);
+
+JsonError json_ondemand_getBoolean(OndemandValue * value, bool * boolean);
+
+//
+// Json Lines
+//
+
+typedef JsonError (*JsonRecordCallback)(JsonValue * record, size_t offset, void * context);
+
+JsonError json_ndjson_process(JsonBuffer * buffer, int threads, bool ordered, JsonRecordCallback callback, void * context, size_t * errorOffset);
+
+//
+// Json Sax Parser
+//
+
+typedef struct SaxParser SaxParser;
+
+typedef struct JsonHandlers JsonHandlers;
+
+struct JsonHandlers {
+    JsonError (*onStartObject)(void * context);
+    JsonError (*onEndObject)(void * context);
+    JsonError (*onStartArray)(void * context);
+    JsonError (*onEndArray)(void * context);
+    JsonError (*onKey)(const char * key, size_t length, void * context);
+    JsonError (*onString)(const char * value, size_t length, void * context);
+    JsonError (*onInteger)(long int value, void * context);
+    JsonError (*onDecimal)(double value, void * context);
+    JsonError (*onNumber)(const char * number, size_t length, void * context);
+    JsonError (*onBoolean)(bool value, void * context);
+    JsonError (*onNull)(void * context);
+};
+
+SaxParser * json_sax_create(const JsonHandlers * handlers, void * context, int maxDepth, JsonError * error);
+
+void json_sax_destroy(SaxParser * parser);
+
+void json_sax_reset(SaxParser * parser);
+
+JsonError json_sax_parse(SaxParser * parser, TokenizerHandle * tokenizer);
+
+//
+// Json Path Extraction
+//
+
+typedef struct JsonPaths JsonPaths;
+
+typedef struct PathExtractor PathExtractor;
+
+typedef JsonError (*JsonPathCallback)(int path, TokenType token, TokenizerHandle * tokenizer, void * context);
+
+JsonPaths * json_paths_compile(const char * const * pointers, int count, JsonError * error);
+
+void json_paths_destroy(JsonPaths * paths);
+
+PathExtractor * json_pathExtractor_create(const JsonPaths * paths, JsonPathCallback callback, void * context, JsonError * error);
+
+void json_pathExtractor_destroy(PathExtractor * extractor);
+
+void json_pathExtractor_reset(PathExtractor * extractor);
+
+JsonError json_pathExtractor_extract(PathExtractor * extractor, TokenizerHandle * tokenizer);
+
+//
+// Json Index
+//
+
+typedef struct JsonIndex JsonIndex;
+
+JsonIndex * json_index_open(char * file, JsonError * error);
+
+void json_index_destroy(JsonIndex * index);
+
+size_t json_index_getRecordCount(JsonIndex * index);
+
+JsonError json_index_seekRecord(JsonIndex * index, TokenizerHandle * tokenizer, size_t record);
+
+JsonError json_index_seekKey(JsonIndex * index, TokenizerHandle * tokenizer, const char * key);
+
+//
+// Json Struct Decoding
+//
+
+JsonError json_decode_unexpected(TokenizerHandle * tokenizer, TokenType token);
+
+JsonError json_decode_nextKey(TokenizerHandle * tokenizer, size_t member, const char ** key, size_t * length);
+
+JsonError json_decode_colon(TokenizerHandle * tokenizer);
+
+JsonError json_decode_nextElement(TokenizerHandle * tokenizer, size_t element, TokenType * token);
+
+JsonError json_decode_int(TokenizerHandle * tokenizer, TokenType token, int * value);
+
+JsonError json_decode_long(TokenizerHandle * tokenizer, TokenType token, long int * value);
+
+JsonError json_decode_double(TokenizerHandle * tokenizer, TokenType token, double * value);
+
+JsonError json_decode_bool(TokenizerHandle * tokenizer, TokenType token, bool * value);
+
+JsonError json_decode_string(TokenizerHandle * tokenizer, TokenType token, char * value, size_t size);
+
+//
+// Json Validation
+//
+
+JsonError json_validate(JsonBuffer * buffer, size_t * errorOffset);
+
+//
+// Json Writer
+//
+
+typedef struct JsonWriter JsonWriter;
+
+typedef enum JsonWriterOptions JsonWriterOptions;
+
+enum JsonWriterOptions {
+    JSON_WRITER_COMPACT = 0,
+    JSON_WRITER_PRETTY = 1,
+    JSON_WRITER_ASCII = 2
+};
+
+JsonWriter * json_writer_create(int options, JsonError * error);
+
+JsonWriter * json_writer_createFile(int file, int options, JsonError * error);
+
+JsonError json_writer_flush(JsonWriter * writer);
+
+JsonError json_writer_destroy(JsonWriter * writer);
+
+const char * json_writer_getOutput(JsonWriter * writer, size_t * length);
+
+JsonError json_writer_startObject(JsonWriter * writer);
+
+JsonError json_writer_endObject(JsonWriter * writer);
+
+JsonError json_writer_startArray(JsonWriter * writer);
+
+JsonError json_writer_endArray(JsonWriter * writer);
+
+JsonError json_writer_writeKey(JsonWriter * writer, const char * key, size_t length);
+
+JsonError json_writer_writeString(JsonWriter * writer, const char * value, size_t length);
+
+JsonError json_writer_writeInteger(JsonWriter * writer, long int value);
+
+JsonError json_writer_writeDecimal(JsonWriter * writer, double value);
+
+JsonError json_writer_writeNumber(JsonWriter * writer, const char * number, size_t length);
+
+JsonError json_writer_writeBoolean(JsonWriter * writer, bool value);
+
+JsonError json_writer_writeNull(JsonWriter * writer);
+
+bool json_writer_isComplete(JsonWriter * writer);
+
+size_t json_writer_getLength(JsonWriter * writer);
+
+JsonError json_reformat(JsonBuffer * buffer, JsonWriter * writer, size_t * errorOffset);
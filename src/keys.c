@@ -0,0 +1,144 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json.h"
+#include "characters.h"
+
+typedef struct KeySymbol KeySymbol;
+
+/*
+ * A registered key, along with its hash so that most other keys in the same slot are told apart without comparing them.
+ */
+struct KeySymbol {
+    const char * key;
+    size_t length;
+    unsigned int hash;
+};
+
+/*
+ * The keys registered with a symbol table, which is never changed once built so it can be shared between tokenizers.
+ */
+struct JsonKeys {
+    KeySymbol * symbols;
+    int count;
+
+    // The registered keys, one after another, pointed into by the symbols.
+    char * characters;
+
+    // The hash table of the symbols, each slot holding one more than the id of a key, or 0 when empty.
+    int * slots;
+    unsigned int mask;
+
+    // The lengths of the shortest and longest keys, so that strings of any other length are not hashed at all.
+    size_t shortest;
+    size_t longest;
+};
+
+/*
+ * Builds a symbol table of keys, where the id of each key is its position in keys.
+ *
+ * The keys are copied, and looked up in a hash table with at least twice as many slots as keys so probes stay short.
+ * If a key is given more than once, it is found with the id of its first position.
+ */
+JsonKeys * json_keys_create(const char * const * keys, int count, JsonError * error) {
+    size_t characters = 0;
+
+    for(int id = 0; id < count; id++) {
+        characters += strlen(keys[id]);
+    }
+
+    unsigned int size = 1;
+
+    while(size < 2 * (unsigned int) count) {
+        size *= 2;
+    }
+
+    JsonKeys * table = (JsonKeys *) calloc(1, sizeof(JsonKeys));
+
+    if(table == NULL) {
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    table->symbols = (KeySymbol *) malloc(((size_t) count + 1) * sizeof(KeySymbol));
+    table->characters = (char *) malloc(characters + 1);
+    table->slots = (int *) calloc(size, sizeof(int));
+
+    if(table->symbols == NULL || table->characters == NULL || table->slots == NULL) {
+        json_keys_destroy(table);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    table->count = count;
+    table->mask = size - 1;
+    table->shortest = SIZE_MAX;
+    table->longest = 0;
+
+    char * next = table->characters;
+
+    for(int id = 0; id < count; id++) {
+        KeySymbol * symbol = &table->symbols[id];
+
+        symbol->length = strlen(keys[id]);
+        symbol->key = memcpy(next, keys[id], symbol->length);
+        symbol->hash = json_char_hash(symbol->key, symbol->length);
+
+        next += symbol->length;
+
+        if(symbol->length < table->shortest) {
+            table->shortest = symbol->length;
+        }
+
+        if(symbol->length > table->longest) {
+            table->longest = symbol->length;
+        }
+
+        // A key given again keeps the slot of its first position.
+        if(json_keys_find(table, symbol->key, symbol->length) >= 0)
+            continue;
+
+        unsigned int slot = symbol->hash & table->mask;
+
+        while(table->slots[slot] != 0) {
+            slot = (slot + 1) & table->mask;
+        }
+
+        table->slots[slot] = id + 1;
+    }
+
+    *error = JSON_SUCCESS;
+
+    return table;
+}
+
+/*
+ * Frees the symbol table, which must no longer be set on any tokenizer.
+ */
+void json_keys_destroy(JsonKeys * keys) {
+    free(keys->symbols);
+    free(keys->characters);
+    free(keys->slots);
+    free(keys);
+}
+
+/*
+ * Gets the id of the key with the characters passed, which do not need to be null terminated, or -1 if it was not registered.
+ */
+int json_keys_find(const JsonKeys * keys, const char * key, size_t length) {
+    if(length < keys->shortest || length > keys->longest)
+        return -1;
+
+    unsigned int hash = json_char_hash(key, length);
+
+    for(unsigned int slot = hash & keys->mask; keys->slots[slot] != 0; slot = (slot + 1) & keys->mask) {
+        const KeySymbol * symbol = &keys->symbols[keys->slots[slot] - 1];
+
+        if(symbol->hash == hash && symbol->length == length && memcmp(symbol->key, key, length) == 0)
+            return keys->slots[slot] - 1;
+    }
+
+    return -1;
+}
@@ -1,28 +1,67 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "json.h"
 
-int main(int argc, char *argv[]) {
-    if(argc != 2) {
-        printf("Expected a single input file\n");
-        return EXIT_FAILURE;
-    }
+#define JSON_MAIN_BUFFER_SIZE (1024 * 1024)
+#define JSON_MAIN_HISTORY 10
+
+// The number of buffers the file is read ahead into while the previous one is processed.
+#define JSON_MAIN_BLOCKS 2
+
+/*
+ * Gets the current time in seconds.
+ */
+static double json_main_getTime(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
 
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/*
+ * Prints how the command should be run.
+ */
+static void json_main_printUsage(FILE * stream) {
+    fprintf(stream, "Usage: json <command> [--stats] <file>\n");
+    fprintf(stream, "\n");
+    fprintf(stream, "Commands:\n");
+    fprintf(stream, "  minify    Write the file to standard output without whitespace\n");
+    fprintf(stream, "  pretty    Write the file to standard output indented\n");
+    fprintf(stream, "  validate  Check that the file is a single valid JSON value\n");
+    fprintf(stream, "  tokens    Print each token in the file\n");
+    fprintf(stream, "\n");
+    fprintf(stream, "Options:\n");
+    fprintf(stream, "  --stats   Print the bytes read, and the bytes written or tokens read, and the throughput to standard error\n");
+}
+
+/*
+ * Prints each token in the file along with its value.
+ */
+static int json_main_printTokens(char * file, bool stats) {
     JsonError error;
-    TokenizerHandle * tokenizer = json_tokenizer_openFile(argv[1], 1024, 10, &error);
+    TokenizerHandle * tokenizer = json_tokenizer_openFile(file, 1024, JSON_MAIN_HISTORY, &error);
 
     if(error != JSON_SUCCESS) {
-        fprintf(stderr, "There was an error opening the tokenizer from file %s.\n", argv[1]);
+        fprintf(stderr, "There was an error opening the tokenizer from file %s.\n", file);
         json_error_printReason(stderr, error);
         return EXIT_FAILURE;
     }
 
-    for(int i = 0; i < 50; i++) {
+    double start = json_main_getTime();
+
+    size_t tokens = 0;
+
+    while(true) {
         TokenType token = json_tokenizer_readNextToken(tokenizer);
 
         if(token == JSON_TOKEN_ERROR) {
             json_tokenizer_logError(tokenizer);
+            json_tokenizer_destroy(tokenizer);
             return EXIT_FAILURE;
         }
 
@@ -31,6 +70,8 @@ int main(int argc, char *argv[]) {
             break;
         }
 
+        tokens++;
+
         char currentChar = json_buffer_getLastCharacter(json_tokenizer_getBuffer(tokenizer));
 
         printf("'%c' %s ", currentChar, json_token_name(token));
@@ -51,13 +92,146 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    double seconds = json_main_getTime() - start;
+
     error = json_tokenizer_destroy(tokenizer);
 
     if(error != JSON_SUCCESS) {
-        fprintf(stderr, "There was an error destroyng the tokenizer.\n");
+        fprintf(stderr, "There was an error destroying the tokenizer.\n");
         json_error_logReason(error);
         return EXIT_FAILURE;
     }
 
+    if(stats) {
+        struct stat info;
+        size_t read = (stat(file, &info) == 0 ? (size_t) info.st_size : 0);
+
+        fprintf(stderr, "read %zu bytes, %zu tokens in %.3f s (%.1f MB/s)\n",
+                read, tokens, seconds, (seconds > 0 ? read / seconds / 1e6 : 0));
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Streams the file through json_reformat to standard output, or through json_validate if options is negative,
+ * so that only a few buffers of the input are held in memory at a time, the next ones read while the current one is processed.
+ */
+static int json_main_process(char * file, int options, bool stats) {
+    JsonError error;
+    JsonBuffer * buffer = json_bufferedFile_openAhead(file, JSON_MAIN_BUFFER_SIZE, JSON_MAIN_HISTORY, JSON_MAIN_BLOCKS, &error);
+
+    if(error != JSON_SUCCESS) {
+        fprintf(stderr, "There was an error opening file %s.\n", file);
+        json_error_printReason(stderr, error);
+        return EXIT_FAILURE;
+    }
+
+    JsonWriter * writer = NULL;
+
+    if(options >= 0) {
+        writer = json_writer_createFile(STDOUT_FILENO, options, &error);
+
+        if(error != JSON_SUCCESS) {
+            fprintf(stderr, "There was an error creating the writer.\n");
+            json_error_printReason(stderr, error);
+            json_buffer_destroy(buffer);
+            return EXIT_FAILURE;
+        }
+    }
+
+    double start = json_main_getTime();
+
+    size_t offset = 0;
+
+    if(writer != NULL) {
+        error = json_reformat(buffer, writer, &offset);
+    } else {
+        error = json_validate(buffer, &offset);
+    }
+
+    size_t written = 0;
+
+    if(writer != NULL) {
+        // Pretty output ends with a new line, as it is meant for reading in a terminal.
+        if(error == JSON_SUCCESS && (options & JSON_WRITER_PRETTY) != 0) {
+            char newLine = '\n';
+            error = json_writer_flush(writer);
+
+            if(error == JSON_SUCCESS && write(STDOUT_FILENO, &newLine, 1) != 1) {
+                error = JSON_ERROR_WRITE_FILE;
+            }
+        }
+
+        written = json_writer_getLength(writer);
+
+        JsonError destroyError = json_writer_destroy(writer);
+
+        if(error == JSON_SUCCESS) {
+            error = destroyError;
+        }
+    }
+
+    double seconds = json_main_getTime() - start;
+
+    json_buffer_destroy(buffer);
+
+    if(error != JSON_SUCCESS) {
+        fprintf(stderr, "%s: error at offset %zu: ", file, offset);
+        json_error_printReason(stderr, error);
+        return EXIT_FAILURE;
+    }
+
+    if(stats) {
+        struct stat info;
+        size_t read = (stat(file, &info) == 0 ? (size_t) info.st_size : 0);
+
+        fprintf(stderr, "read %zu bytes, wrote %zu bytes in %.3f s (%.1f MB/s)\n",
+                read, written, seconds, (seconds > 0 ? read / seconds / 1e6 : 0));
+    }
+
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+
+int main(int argc, char *argv[]) {
+    char * command = NULL;
+    char * file = NULL;
+    bool stats = false;
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if(strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            json_main_printUsage(stdout);
+            return EXIT_SUCCESS;
+        } else if(command == NULL) {
+            command = argv[i];
+        } else if(file == NULL) {
+            file = argv[i];
+        } else {
+            json_main_printUsage(stderr);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(command == NULL || file == NULL) {
+        json_main_printUsage(stderr);
+        return EXIT_FAILURE;
+    }
+
+    if(strcmp(command, "minify") == 0)
+        return json_main_process(file, JSON_WRITER_COMPACT, stats);
+
+    if(strcmp(command, "pretty") == 0)
+        return json_main_process(file, JSON_WRITER_PRETTY, stats);
+
+    if(strcmp(command, "validate") == 0)
+        return json_main_process(file, -1, stats);
+
+    if(strcmp(command, "tokens") == 0)
+        return json_main_printTokens(file, stats);
+
+    fprintf(stderr, "Unknown command %s.\n", command);
+    json_main_printUsage(stderr);
+    return EXIT_FAILURE;
+}
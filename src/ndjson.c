@@ -0,0 +1,515 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "buffer_internal.h"
+#include "simd_internal.h"
+
+/*
+ * The size that the input is split into chunks of, before extending each chunk to the end of its last line.
+ */
+#define JSON_NDJSON_CHUNK_SIZE (1 << 20)
+
+/*
+ * The number of characters of history kept by the buffers of the workers.
+ */
+#define JSON_NDJSON_HISTORY 10
+
+typedef struct NdjsonChunk NdjsonChunk;
+
+/*
+ * A run of whole lines of the input, from start up to end.
+ */
+struct NdjsonChunk {
+    size_t start;
+    size_t end;
+};
+
+typedef struct NdjsonRecord NdjsonRecord;
+
+/*
+ * A record that has been parsed but not yet passed to the callback.
+ */
+struct NdjsonRecord {
+    JsonValue * value;
+    size_t offset;
+};
+
+typedef struct NdjsonSlot NdjsonSlot;
+
+/*
+ * Holds the records of a chunk in ordered mode until the calling thread reaches that chunk.
+ */
+struct NdjsonSlot {
+    JsonArena * arena;
+
+    NdjsonRecord * records;
+    size_t count;
+    size_t capacity;
+
+    // The chunk held by the slot, and whether all of its records have been parsed.
+    size_t chunk;
+    bool done;
+
+    // Set if the chunk stopped early, after the records before the error.
+    JsonError error;
+    size_t errorOffset;
+};
+
+typedef struct NdjsonJob NdjsonJob;
+
+/*
+ * The state shared by the workers and the calling thread.
+ */
+struct NdjsonJob {
+    const char * data;
+
+    NdjsonChunk * chunks;
+    size_t chunkCount;
+
+    bool ordered;
+
+    JsonRecordCallback callback;
+    void * context;
+
+    NdjsonSlot * slots;
+    size_t slotCount;
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+
+    // The next chunk to be claimed by a worker, and the number of chunks passed to the callback in ordered mode.
+    size_t nextChunk;
+    size_t delivered;
+
+    // Set once an error has occurred, after which no more records are read.
+    bool stopped;
+
+    JsonError error;
+    size_t errorOffset;
+};
+
+/*
+ * Splits the characters from start to end into chunks of whole lines.
+ */
+static JsonError json_ndjson_split(NdjsonJob * job, size_t start, size_t end) {
+    size_t capacity = (end - start) / JSON_NDJSON_CHUNK_SIZE + 1;
+
+    job->chunks = (NdjsonChunk *) malloc(capacity * sizeof(NdjsonChunk));
+    job->chunkCount = 0;
+
+    if(job->chunks == NULL) {
+        return JSON_ERROR_MALLOC;
+    }
+
+    while(start < end) {
+        size_t chunkEnd = end;
+
+        if(end - start > JSON_NDJSON_CHUNK_SIZE) {
+            const char * newLine = memchr(&job->data[start + JSON_NDJSON_CHUNK_SIZE], '\n', end - start - JSON_NDJSON_CHUNK_SIZE);
+
+            chunkEnd = (newLine == NULL ? end : (size_t) (newLine - job->data) + 1);
+        }
+
+        if(job->chunkCount == capacity) {
+            capacity *= 2;
+
+            NdjsonChunk * chunks = realloc(job->chunks, capacity * sizeof(NdjsonChunk));
+
+            if(chunks == NULL) {
+                return JSON_ERROR_REALLOC;
+            }
+
+            job->chunks = chunks;
+        }
+
+        job->chunks[job->chunkCount].start = start;
+        job->chunks[job->chunkCount].end = chunkEnd;
+        job->chunkCount++;
+
+        start = chunkEnd;
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Records the first error to stop the job, by position in the input, and wakes up every waiting thread.
+ */
+static void json_ndjson_stop(NdjsonJob * job, JsonError error, size_t offset) {
+    pthread_mutex_lock(&job->lock);
+
+    if(!job->stopped || offset < job->errorOffset) {
+        job->error = error;
+        job->errorOffset = offset;
+    }
+
+    // Workers check whether to stop between records without taking the lock.
+    __atomic_store_n(&job->stopped, true, __ATOMIC_RELAXED);
+
+    pthread_cond_broadcast(&job->changed);
+    pthread_mutex_unlock(&job->lock);
+}
+
+/*
+ * Adds a parsed record to a slot, to be passed to the callback later.
+ */
+static JsonError json_ndjson_keep(NdjsonSlot * slot, JsonValue * value, size_t offset) {
+    if(slot->count == slot->capacity) {
+        size_t capacity = (slot->capacity == 0 ? 256 : slot->capacity * 2);
+
+        NdjsonRecord * records = realloc(slot->records, capacity * sizeof(NdjsonRecord));
+
+        if(records == NULL) {
+            return JSON_ERROR_REALLOC;
+        }
+
+        slot->records = records;
+        slot->capacity = capacity;
+    }
+
+    slot->records[slot->count].value = value;
+    slot->records[slot->count].offset = offset;
+    slot->count++;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Parses each line of a chunk as a record.
+ *
+ * In ordered mode the records are kept in the slot and all allocated from its arena. Otherwise each
+ * record is passed straight to the callback, and the arena is reset before the next one.
+ *
+ * Lines that are empty or only whitespace are skipped.
+ */
+static JsonError json_ndjson_parseChunk(NdjsonJob * job, NdjsonChunk * chunk, TokenizerHandle * tokenizer, JsonArena * arena, NdjsonSlot * slot, size_t * errorOffset) {
+    JsonError error;
+
+    JsonBuffer * line = json_tokenizer_getBuffer(tokenizer);
+
+    size_t start = chunk->start;
+
+    while(start < chunk->end && !__atomic_load_n(&job->stopped, __ATOMIC_RELAXED)) {
+        const char * newLine = memchr(&job->data[start], '\n', chunk->end - start);
+
+        size_t end = (newLine == NULL ? chunk->end : (size_t) (newLine - job->data));
+        size_t length = end - start;
+
+        *errorOffset = start;
+
+        if(json_simd_countWhitespace(&job->data[start], length) < length) {
+            // Point the buffer of the tokenizer at the line.
+            line->buffer = (char *) &job->data[start];
+            line->bufferSize = length;
+            line->index = 0;
+            line->read = length;
+            line->offset = (int64_t) start;
+
+            if(slot == NULL) {
+                json_arena_reset(arena);
+            }
+
+            JsonDocument * document = json_document_parse(tokenizer, arena, &error);
+
+            if(document == NULL) {
+                *errorOffset = (size_t) json_buffer_getOffset(line);
+                return error;
+            }
+
+            TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+            if(token != JSON_TOKEN_EOF) {
+                *errorOffset = (size_t) json_buffer_getOffset(line);
+                return (token == JSON_TOKEN_ERROR ? json_tokenizer_getError(tokenizer) : JSON_ERROR_UNEXPECTED_TOKEN);
+            }
+
+            if(slot != NULL) {
+                error = json_ndjson_keep(slot, json_document_getRoot(document), start);
+            } else {
+                error = job->callback(json_document_getRoot(document), start, job->context);
+            }
+
+            if(error != JSON_SUCCESS)
+                return error;
+        }
+
+        start = end + 1;
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Claims chunks and parses them until there are none left or the job is stopped.
+ */
+static void * json_ndjson_work(void * argument) {
+    NdjsonJob * job = (NdjsonJob *) argument;
+
+    JsonError error;
+
+    JsonBuffer * line = json_bufferFixed_create((char *) job->data, 0, JSON_NDJSON_HISTORY, &error);
+    TokenizerHandle * tokenizer = (line == NULL ? NULL : json_tokenizer_create(line, &error));
+
+    // Ordered workers parse into the arenas of the slots instead.
+    JsonArena * arena = NULL;
+
+    if(tokenizer != NULL && !job->ordered) {
+        arena = json_arena_create(64 * 1024, &error);
+    }
+
+    if(tokenizer == NULL || (!job->ordered && arena == NULL)) {
+        if(tokenizer != NULL) {
+            json_tokenizer_destroy(tokenizer);
+        } else if(line != NULL) {
+            json_buffer_destroy(line);
+        }
+
+        json_ndjson_stop(job, error, 0);
+        return NULL;
+    }
+
+    while(true) {
+        pthread_mutex_lock(&job->lock);
+
+        if(job->stopped || job->nextChunk == job->chunkCount) {
+            pthread_mutex_unlock(&job->lock);
+            break;
+        }
+
+        size_t index = job->nextChunk++;
+
+        NdjsonSlot * slot = NULL;
+
+        if(job->ordered) {
+            // Wait for the calling thread to pass on the chunk that last used the slot.
+            while(!job->stopped && index >= job->delivered + job->slotCount) {
+                pthread_cond_wait(&job->changed, &job->lock);
+            }
+
+            slot = &job->slots[index % job->slotCount];
+        }
+
+        pthread_mutex_unlock(&job->lock);
+
+        if(slot != NULL) {
+            json_arena_reset(slot->arena);
+
+            slot->count = 0;
+            slot->chunk = index;
+            slot->error = JSON_SUCCESS;
+        }
+
+        size_t errorOffset = 0;
+
+        error = json_ndjson_parseChunk(job, &job->chunks[index], tokenizer, (slot != NULL ? slot->arena : arena), slot, &errorOffset);
+
+        if(slot != NULL) {
+            pthread_mutex_lock(&job->lock);
+
+            // The calling thread reports the error once it reaches the chunk, after the records before it.
+            slot->error = error;
+            slot->errorOffset = errorOffset;
+            slot->done = true;
+
+            pthread_cond_broadcast(&job->changed);
+            pthread_mutex_unlock(&job->lock);
+        } else if(error != JSON_SUCCESS) {
+            json_ndjson_stop(job, error, errorOffset);
+        }
+    }
+
+    if(arena != NULL) {
+        json_arena_destroy(arena);
+    }
+
+    json_tokenizer_destroy(tokenizer);
+
+    return NULL;
+}
+
+/*
+ * Passes the records of each chunk to the callback in the order they appear in the input.
+ */
+static void json_ndjson_deliver(NdjsonJob * job) {
+    for(size_t index = 0; index < job->chunkCount; index++) {
+        NdjsonSlot * slot = &job->slots[index % job->slotCount];
+
+        pthread_mutex_lock(&job->lock);
+
+        while(!job->stopped && !(slot->done && slot->chunk == index)) {
+            pthread_cond_wait(&job->changed, &job->lock);
+        }
+
+        bool stopped = job->stopped;
+
+        pthread_mutex_unlock(&job->lock);
+
+        if(stopped)
+            return;
+
+        for(size_t record = 0; record < slot->count; record++) {
+            JsonError error = job->callback(slot->records[record].value, slot->records[record].offset, job->context);
+
+            if(error != JSON_SUCCESS) {
+                json_ndjson_stop(job, error, slot->records[record].offset);
+                return;
+            }
+        }
+
+        if(slot->error != JSON_SUCCESS) {
+            json_ndjson_stop(job, slot->error, slot->errorOffset);
+            return;
+        }
+
+        pthread_mutex_lock(&job->lock);
+
+        slot->done = false;
+        job->delivered++;
+
+        pthread_cond_broadcast(&job->changed);
+        pthread_mutex_unlock(&job->lock);
+    }
+}
+
+/*
+ * Creates the slots used to hold the records of chunks in ordered mode.
+ */
+static JsonError json_ndjson_createSlots(NdjsonJob * job, size_t count) {
+    JsonError error;
+
+    job->slots = (NdjsonSlot *) calloc(count, sizeof(NdjsonSlot));
+    job->slotCount = 0;
+
+    if(job->slots == NULL) {
+        return JSON_ERROR_MALLOC;
+    }
+
+    for(; job->slotCount < count; job->slotCount++) {
+        job->slots[job->slotCount].arena = json_arena_create(JSON_NDJSON_CHUNK_SIZE, &error);
+
+        if(job->slots[job->slotCount].arena == NULL)
+            return error;
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Frees the chunks and slots of a job.
+ */
+static void json_ndjson_destroy(NdjsonJob * job) {
+    for(size_t index = 0; index < job->slotCount; index++) {
+        json_arena_destroy(job->slots[index].arena);
+        free(job->slots[index].records);
+    }
+
+    free(job->slots);
+    free(job->chunks);
+
+    pthread_mutex_destroy(&job->lock);
+    pthread_cond_destroy(&job->changed);
+}
+
+/*
+ * Parses each line of a fixed or mapped buffer as a separate document, using threads worker threads,
+ * and passes each one to the callback along with the offset in the buffer of the start of its line.
+ *
+ * The input is split into chunks of whole lines, and each worker tokenizes the chunks it claims with
+ * its own tokenizer. If threads is 0 or less, a worker is started for each online processor.
+ *
+ * If ordered is true the callback is called on the calling thread for each record in the order they
+ * appear in the input. The records of a chunk stay valid until the callback returns for the last of them.
+ *
+ * If ordered is false the callback is called on the worker threads as soon as each record has been parsed,
+ * so must be thread safe. Each record is only valid until the callback returns.
+ *
+ * Stops at the first error, or the first time the callback returns something other than JSON_SUCCESS,
+ * and returns that error. If errorOffset is not NULL it is set to the offset in the buffer of the error.
+ * In ordered mode every record before the error has been passed to the callback. Empty lines are skipped.
+ */
+JsonError json_ndjson_process(JsonBuffer * buffer, int threads, bool ordered, JsonRecordCallback callback, void * context, size_t * errorOffset) {
+    if(!json_buffer_isContiguous(buffer)) {
+        return JSON_ERROR_UNSUPPORTED_BUFFER;
+    }
+
+    if(threads <= 0) {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+        threads = (processors > 0 ? (int) processors : 1);
+    }
+
+    NdjsonJob job;
+
+    job.data = buffer->buffer;
+    job.chunks = NULL;
+    job.chunkCount = 0;
+    job.ordered = ordered;
+    job.callback = callback;
+    job.context = context;
+    job.slots = NULL;
+    job.slotCount = 0;
+    job.nextChunk = 0;
+    job.delivered = 0;
+    job.stopped = false;
+    job.error = JSON_SUCCESS;
+    job.errorOffset = 0;
+
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.changed, NULL);
+
+    JsonError error = json_ndjson_split(&job, buffer->index, buffer->read);
+
+    // Two slots for each worker lets workers carry on while the calling thread catches up.
+    if(error == JSON_SUCCESS && ordered) {
+        error = json_ndjson_createSlots(&job, (size_t) threads * 2);
+    }
+
+    pthread_t * workers = NULL;
+    int started = 0;
+
+    if(error == JSON_SUCCESS) {
+        workers = (pthread_t *) malloc((size_t) threads * sizeof(pthread_t));
+
+        if(workers == NULL) {
+            error = JSON_ERROR_MALLOC;
+        }
+    }
+
+    if(error != JSON_SUCCESS) {
+        json_ndjson_destroy(&job);
+        return error;
+    }
+
+    for(; started < threads; started++) {
+        if(pthread_create(&workers[started], NULL, json_ndjson_work, &job) != 0) {
+            json_ndjson_stop(&job, JSON_ERROR_CREATE_THREAD, 0);
+            break;
+        }
+    }
+
+    if(ordered) {
+        json_ndjson_deliver(&job);
+    }
+
+    for(int worker = 0; worker < started; worker++) {
+        pthread_join(workers[worker], NULL);
+    }
+
+    free(workers);
+
+    error = job.error;
+
+    if(errorOffset != NULL) {
+        *errorOffset = job.errorOffset;
+    }
+
+    if(error == JSON_SUCCESS) {
+        buffer->index = buffer->read;
+    }
+
+    json_ndjson_destroy(&job);
+
+    return error;
+}
@@ -0,0 +1,53 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * The most characters written by json_number_formatDouble.
+ */
+#define JSON_NUMBER_FORMATTED_SIZE 32
+
+/*
+ * The most significant digits that can be accumulated into a 64 bit mantissa without overflowing.
+ */
+#define JSON_NUMBER_MAX_DIGITS 19
+
+typedef struct NumberDigits NumberDigits;
+
+/*
+ * The digits read from part of a number.
+ */
+struct NumberDigits {
+    // The first JSON_NUMBER_MAX_DIGITS significant digits.
+    uint64_t value;
+
+    // The number of digits read, including leading zeroes and digits that did not fit in value.
+    int count;
+
+    // The number of digits in value, not counting leading zeroes.
+    int significant;
+
+    // The number of digits that did not fit in value, and whether any of them were not zero.
+    int dropped;
+    bool droppedNonZero;
+};
+
+/*
+ * Adds the next digit to the digits read so far.
+ */
+#define json_number_addDigit(digits, digit) \
+    do { \
+        (digits)->count++; \
+        if((digits)->significant < JSON_NUMBER_MAX_DIGITS) { \
+            if((digits)->significant > 0 || (digit) != 0) { \
+                (digits)->value = (digits)->value * 10 + (uint64_t) (digit); \
+                (digits)->significant++; \
+            } \
+        } else { \
+            (digits)->dropped++; \
+            (digits)->droppedNonZero |= ((digit) != 0); \
+        } \
+    } while(0)
+
+bool json_number_toDouble(uint64_t mantissa, int64_t exponent, bool negative, bool truncated, double * result);
+
+int json_number_formatDouble(double value, char * buffer);
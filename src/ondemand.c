@@ -0,0 +1,471 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "buffer_internal.h"
+#include "tokenizer_internal.h"
+
+/*
+ * The depth limit used when none is given.
+ */
+#define JSON_ONDEMAND_DEFAULT_MAX_DEPTH 1024
+
+/*
+ * The position of the single cursor that every on-demand value reads forward from.
+ */
+struct OndemandParser {
+    TokenizerHandle * tokenizer;
+
+    // The number of objects and arrays the cursor is inside of.
+    int depth;
+    int maxDepth;
+
+    // The object or array the cursor last entered at each depth, numbered in the order they were entered.
+    unsigned int * containers;
+    unsigned int entered;
+
+    // Whether a value has been handed out at the cursor without being read, and where it starts.
+    bool pending;
+    int64_t pendingStart;
+
+    // The start of the last value read, whose token is still held by the tokenizer, or -1 if it has been replaced.
+    int64_t lastRead;
+};
+
+/*
+ * Create a parser that reads values from the tokenizer only as they are asked for.
+ *
+ * Objects and arrays may be nested up to maxDepth deep, or 1024 deep if maxDepth is 0 or less.
+ * The tokenizer must read from a contiguous buffer with the streaming engine.
+ */
+OndemandParser * json_ondemand_create(TokenizerHandle * tokenizer, int maxDepth, JsonError * error) {
+    OndemandParser * parser = (OndemandParser *) malloc(sizeof(OndemandParser));
+
+    if(parser == NULL) {
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    if(maxDepth <= 0) {
+        maxDepth = JSON_ONDEMAND_DEFAULT_MAX_DEPTH;
+    }
+
+    parser->containers = (unsigned int *) malloc(((size_t) maxDepth + 1) * sizeof(unsigned int));
+
+    if(parser->containers == NULL) {
+        free(parser);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    parser->tokenizer = tokenizer;
+    parser->maxDepth = maxDepth;
+
+    *error = JSON_SUCCESS;
+
+    return parser;
+}
+
+/*
+ * Frees the parser, but not its tokenizer.
+ */
+void json_ondemand_destroy(OndemandParser * parser) {
+    free(parser->containers);
+    free(parser);
+}
+
+/*
+ * Hands out the value starting at the cursor without reading any of it.
+ */
+static void json_ondemand_handOut(OndemandParser * parser, OndemandValue * value) {
+    value->parser = parser;
+    value->start = json_buffer_getOffset(json_tokenizer_getBuffer(parser->tokenizer));
+    value->depth = parser->depth;
+    value->container = 0;
+    value->token = JSON_TOKEN_ERROR;
+    value->read = false;
+    value->first = false;
+
+    parser->pending = true;
+    parser->pendingStart = value->start;
+}
+
+/*
+ * Starts reading the value at the start of the tokenizer's buffer, setting root to it.
+ *
+ * Calling this again after resetting the tokenizer onto new input reuses the parser for it.
+ */
+JsonError json_ondemand_start(OndemandParser * parser, OndemandValue * root) {
+    JsonBuffer * buffer = json_tokenizer_getBuffer(parser->tokenizer);
+
+    if(!json_buffer_isContiguous(buffer) || json_tokenizer_getEngine(parser->tokenizer) != JSON_ENGINE_STREAMING) {
+        return JSON_ERROR_UNSUPPORTED_BUFFER;
+    }
+
+    parser->depth = 0;
+    parser->containers[0] = 0;
+    parser->entered = 0;
+    parser->lastRead = -1;
+
+    json_ondemand_handOut(parser, root);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Reads the first token of the value if it has not been read yet, entering it if it is an object or array.
+ *
+ * Returns JSON_ERROR_OUT_OF_ORDER if the cursor has already moved past the value.
+ */
+static JsonError json_ondemand_read(OndemandValue * value) {
+    OndemandParser * parser = value->parser;
+
+    if(value->read) {
+        bool container = (value->token == JSON_TOKEN_OBJECT_START || value->token == JSON_TOKEN_ARRAY_START);
+
+        return (container || parser->lastRead == value->start ? JSON_SUCCESS : JSON_ERROR_OUT_OF_ORDER);
+    }
+
+    if(!parser->pending || parser->pendingStart != value->start || parser->depth != value->depth) {
+        return JSON_ERROR_OUT_OF_ORDER;
+    }
+
+    TokenType token = json_tokenizer_readNextToken(parser->tokenizer);
+
+    switch(token) {
+        case JSON_TOKEN_ERROR:
+            return json_tokenizer_getError(parser->tokenizer);
+        case JSON_TOKEN_OBJECT_START:
+        case JSON_TOKEN_ARRAY_START:
+            if(parser->depth == parser->maxDepth) {
+                return JSON_ERROR_MAX_DEPTH;
+            }
+
+            parser->containers[++parser->depth] = ++parser->entered;
+
+            value->container = parser->entered;
+            value->first = true;
+            break;
+        case JSON_TOKEN_OBJECT_END:
+        case JSON_TOKEN_ARRAY_END:
+        case JSON_TOKEN_COMMA:
+        case JSON_TOKEN_COLON:
+        case JSON_TOKEN_EOF:
+            return JSON_ERROR_UNEXPECTED_TOKEN;
+        default:
+            break;
+    }
+
+    value->token = token;
+    value->read = true;
+
+    parser->pending = false;
+    parser->lastRead = value->start;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Reads the next token, which must be of the type expected.
+ */
+static JsonError json_ondemand_expect(OndemandParser * parser, TokenType expected) {
+    TokenType token = json_tokenizer_readNextToken(parser->tokenizer);
+
+    if(token == expected) {
+        return JSON_SUCCESS;
+    }
+
+    return (token == JSON_TOKEN_ERROR ? json_tokenizer_getError(parser->tokenizer) : JSON_ERROR_UNEXPECTED_TOKEN);
+}
+
+/*
+ * Moves the cursor to the next member or element of an object or array, skipping whatever is left
+ * of the one before it, and consuming the comma between them.
+ *
+ * Returns JSON_ERROR_EOF once the end of the object or array has been consumed.
+ */
+static JsonError json_ondemand_advance(OndemandValue * container, TokenType start, TokenType end) {
+    OndemandParser * parser = container->parser;
+    TokenizerHandle * tokenizer = parser->tokenizer;
+
+    JsonError error = json_ondemand_read(container);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    if(container->token != start) {
+        return JSON_ERROR_UNEXPECTED_TOKEN;
+    }
+
+    int inside = container->depth + 1;
+
+    // Another object or array entered at the same depth, or none at all, means this one was passed over.
+    if(parser->containers[inside] != container->container) {
+        return JSON_ERROR_OUT_OF_ORDER;
+    }
+
+    if(parser->depth < inside) {
+        return JSON_ERROR_EOF;
+    }
+
+    parser->lastRead = -1;
+
+    // Whatever of the last member or element was not read is skipped without being tokenized.
+    if(parser->depth > inside) {
+        error = json_tokenizer_skipContainers(tokenizer, parser->depth - inside);
+
+        // The objects and arrays skipped over can no longer be read from.
+        while(parser->depth > inside) {
+            parser->containers[parser->depth--] = 0;
+        }
+
+        parser->pending = false;
+    } else if(parser->pending) {
+        error = json_tokenizer_skipValue(tokenizer);
+
+        parser->pending = false;
+    }
+
+    if(error != JSON_SUCCESS)
+        return (error == JSON_ERROR_EOF ? JSON_ERROR_UNEXPECTED_TOKEN : error);
+
+    error = json_tokenizer_skipWhitespace(tokenizer);
+
+    if(error != JSON_SUCCESS)
+        return (error == JSON_ERROR_EOF ? JSON_ERROR_UNEXPECTED_TOKEN : error);
+
+    JsonBuffer * buffer = json_tokenizer_getBuffer(tokenizer);
+
+    char endCharacter = (end == JSON_TOKEN_OBJECT_END ? '}' : ']');
+
+    if(json_buffer_get(buffer) == endCharacter) {
+        json_buffer_consume(buffer);
+
+        parser->depth--;
+
+        return JSON_ERROR_EOF;
+    }
+
+    if(container->first) {
+        container->first = false;
+    } else {
+        error = json_ondemand_expect(parser, JSON_TOKEN_COMMA);
+
+        if(error != JSON_SUCCESS)
+            return error;
+
+        error = json_tokenizer_skipWhitespace(tokenizer);
+
+        if(error != JSON_SUCCESS)
+            return (error == JSON_ERROR_EOF ? JSON_ERROR_UNEXPECTED_TOKEN : error);
+
+        // A comma must be followed by another member or element, not by the end.
+        if(json_buffer_get(buffer) == endCharacter)
+            return JSON_ERROR_UNEXPECTED_TOKEN;
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Moves to the next member of an object, setting key to its key and value to its value without reading it.
+ *
+ * The key is only valid until the value is read or the parser moves on. Returns JSON_ERROR_EOF after the last member.
+ */
+JsonError json_ondemand_nextMember(OndemandValue * object, const char ** key, size_t * keyLength, OndemandValue * value) {
+    OndemandParser * parser = object->parser;
+
+    JsonError error = json_ondemand_advance(object, JSON_TOKEN_OBJECT_START, JSON_TOKEN_OBJECT_END);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    error = json_ondemand_expect(parser, JSON_TOKEN_TEXT);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    json_tokenizer_getStringSlice(parser->tokenizer, key, keyLength);
+
+    error = json_ondemand_expect(parser, JSON_TOKEN_COLON);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    json_ondemand_handOut(parser, value);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Finds the value of the member with the key in an object, looking forward from the last member moved to.
+ *
+ * Members before the one found are skipped without their values being read, so keys have to be looked up
+ * in the order they appear. Returns JSON_ERROR_NOT_FOUND if the rest of the object does not have the key,
+ * after which the object has been read to its end.
+ */
+JsonError json_ondemand_find(OndemandValue * object, const char * key, OndemandValue * value) {
+    size_t length = strlen(key);
+
+    while(true) {
+        const char * memberKey;
+        size_t memberLength;
+
+        JsonError error = json_ondemand_nextMember(object, &memberKey, &memberLength, value);
+
+        if(error != JSON_SUCCESS)
+            return (error == JSON_ERROR_EOF ? JSON_ERROR_NOT_FOUND : error);
+
+        if(memberLength == length && memcmp(memberKey, key, length) == 0)
+            return JSON_SUCCESS;
+    }
+}
+
+/*
+ * Moves to the next element of an array, setting element to it without reading it.
+ *
+ * Returns JSON_ERROR_EOF after the last element, and JSON_ERROR_UNEXPECTED_TOKEN if it is followed by a comma.
+ */
+JsonError json_ondemand_nextElement(OndemandValue * array, OndemandValue * element) {
+    JsonError error = json_ondemand_advance(array, JSON_TOKEN_ARRAY_START, JSON_TOKEN_ARRAY_END);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    json_ondemand_handOut(array->parser, element);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Gets the type of the value, reading its first token.
+ */
+JsonError json_ondemand_getType(OndemandValue * value, JsonValueType * type) {
+    JsonError error = json_ondemand_read(value);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    switch(value->token) {
+        case JSON_TOKEN_OBJECT_START:
+            *type = JSON_VALUE_OBJECT;
+            break;
+        case JSON_TOKEN_ARRAY_START:
+            *type = JSON_VALUE_ARRAY;
+            break;
+        case JSON_TOKEN_TEXT:
+            *type = JSON_VALUE_STRING;
+            break;
+        case JSON_TOKEN_NUMBER_INTEGER:
+            *type = JSON_VALUE_INTEGER;
+            break;
+        case JSON_TOKEN_NUMBER_DECIMAL:
+            *type = JSON_VALUE_DECIMAL;
+            break;
+        case JSON_TOKEN_NUMBER_BIG_INTEGER:
+        case JSON_TOKEN_NUMBER_BIG_DECIMAL:
+            *type = JSON_VALUE_BIG_NUMBER;
+            break;
+        case JSON_TOKEN_TRUE:
+        case JSON_TOKEN_FALSE:
+            *type = JSON_VALUE_BOOLEAN;
+            break;
+        default:
+            *type = JSON_VALUE_NULL;
+            break;
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Reads a string value, unescaping it if it has escapes.
+ *
+ * The string is only valid until the parser moves on. Returns JSON_ERROR_UNEXPECTED_TOKEN for other types of value.
+ */
+JsonError json_ondemand_getString(OndemandValue * value, const char ** string, size_t * length) {
+    JsonError error = json_ondemand_read(value);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    if(value->token != JSON_TOKEN_TEXT)
+        return JSON_ERROR_UNEXPECTED_TOKEN;
+
+    json_tokenizer_getStringSlice(value->parser->tokenizer, string, length);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Reads an integer value that fits in a long int.
+ *
+ * Returns JSON_ERROR_UNEXPECTED_TOKEN for other types of value, including larger integers.
+ */
+JsonError json_ondemand_getInteger(OndemandValue * value, long int * integer) {
+    JsonError error = json_ondemand_read(value);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    if(value->token != JSON_TOKEN_NUMBER_INTEGER)
+        return JSON_ERROR_UNEXPECTED_TOKEN;
+
+    *integer = json_tokenizer_getIntegerValue(value->parser->tokenizer);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Reads any number as a double, rounding it if it cannot be represented exactly.
+ *
+ * Returns JSON_ERROR_UNEXPECTED_TOKEN for values that are not numbers.
+ */
+JsonError json_ondemand_getDecimal(OndemandValue * value, double * decimal) {
+    JsonError error = json_ondemand_read(value);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    TokenizerHandle * tokenizer = value->parser->tokenizer;
+
+    switch(value->token) {
+        case JSON_TOKEN_NUMBER_DECIMAL:
+            *decimal = json_tokenizer_getDecimalValue(tokenizer);
+            return JSON_SUCCESS;
+        case JSON_TOKEN_NUMBER_INTEGER:
+            *decimal = (double) json_tokenizer_getIntegerValue(tokenizer);
+            return JSON_SUCCESS;
+        case JSON_TOKEN_NUMBER_BIG_INTEGER:
+        case JSON_TOKEN_NUMBER_BIG_DECIMAL: {
+            char * number = json_tokenizer_getNumberValue(tokenizer);
+
+            if(number == NULL)
+                return JSON_ERROR_MALLOC;
+
+            *decimal = strtod(number, NULL);
+            return JSON_SUCCESS;
+        }
+        default:
+            return JSON_ERROR_UNEXPECTED_TOKEN;
+    }
+}
+
+/*
+ * Reads a true or false value.
+ *
+ * Returns JSON_ERROR_UNEXPECTED_TOKEN for other types of value.
+ */
+JsonError json_ondemand_getBoolean(OndemandValue * value, bool * boolean) {
+    JsonError error = json_ondemand_read(value);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    if(value->token != JSON_TOKEN_TRUE && value->token != JSON_TOKEN_FALSE)
+        return JSON_ERROR_UNEXPECTED_TOKEN;
+
+    *boolean = (value->token == JSON_TOKEN_TRUE);
+
+    return JSON_SUCCESS;
+}
@@ -0,0 +1,628 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "sax_internal.h"
+#include "tokenizer_internal.h"
+#include "characters.h"
+
+/*
+ * The longest array index that is matched, as a number of decimal digits.
+ */
+#define JSON_PATHS_INDEX_DIGITS 24
+
+typedef struct PathNode PathNode;
+
+typedef struct PathEdge PathEdge;
+
+typedef struct PathFrame PathFrame;
+
+/*
+ * A point in the trie of compiled paths, reached by following every segment of a path up to it.
+ */
+struct PathNode {
+    // The edges to the nodes one segment further on, next to each other in the edges.
+    int edges;
+    int edgeCount;
+
+    // The hash table of the edges, as the start of its slots and one less than their number, a power of 2.
+    int slots;
+    unsigned int mask;
+
+    // The node reached by a * segment, or -1.
+    int wildcard;
+
+    // The first path ending at this node, or -1, with any others chained through nextMatch.
+    int match;
+};
+
+/*
+ * The segment leading from one node to the next, unescaped.
+ */
+struct PathEdge {
+    const char * key;
+    size_t length;
+    int parent;
+    int node;
+};
+
+/*
+ * The paths compiled into a trie, which is never changed once built so it can be shared between extractors.
+ */
+struct JsonPaths {
+    PathNode * nodes;
+    int nodeCount;
+
+    PathEdge * edges;
+    int edgeCount;
+
+    // The unescaped segments of every path, pointed into by the edges.
+    char * keys;
+
+    // The hash tables of every node, each slot holding one more than the index of an edge, or 0 when empty.
+    int * slots;
+
+    int * nextMatch;
+    int count;
+
+    // The most segments in any path.
+    int height;
+};
+
+/*
+ * An object or array that the extractor has gone into, because some of the paths continue inside of it.
+ */
+struct PathFrame {
+    // The state to return to after each of its values.
+    unsigned char after;
+
+    // The trie nodes matched by the object or array itself, held in the extractor's nodes.
+    int start;
+    int count;
+
+    // The index of the current element, for arrays.
+    long int index;
+};
+
+/*
+ * Contains the state of an extraction, so that it can be carried on when pushed input runs out.
+ */
+struct PathExtractor {
+    const JsonPaths * paths;
+
+    JsonPathCallback callback;
+    void * context;
+
+    PathFrame * frames;
+    int depth;
+
+    // The nodes matched by each frame, followed by the nodes matched by the value about to be read.
+    int * nodes;
+    int candidates;
+
+    SaxState state;
+
+    // Whether the extractor is part way through skipping a value that no path goes into.
+    bool skipping;
+};
+
+/*
+ * Orders edges by their parent, so that the edges of each node are next to each other.
+ */
+static int json_paths_compareEdges(const void * first, const void * second) {
+    const PathEdge * a = (const PathEdge *) first;
+    const PathEdge * b = (const PathEdge *) second;
+
+    return (a->parent > b->parent) - (a->parent < b->parent);
+}
+
+/*
+ * Finds the child of a node reached by the key, or -1 if there is none.
+ */
+static int json_paths_findChild(const JsonPaths * paths, const PathNode * node, const char * key, size_t length) {
+    const int * slots = &paths->slots[node->slots];
+
+    for(unsigned int slot = json_char_hash(key, length) & node->mask; slots[slot] != 0; slot = (slot + 1) & node->mask) {
+        const PathEdge * edge = &paths->edges[slots[slot] - 1];
+
+        if(edge->length == length && memcmp(edge->key, key, length) == 0)
+            return edge->node;
+    }
+
+    return -1;
+}
+
+/*
+ * Builds the hash table of every node's edges, each with at least twice as many slots as edges so probes stay short.
+ */
+static JsonError json_paths_buildSlots(JsonPaths * paths) {
+    size_t total = 0;
+
+    for(int index = 0; index < paths->nodeCount; index++) {
+        PathNode * node = &paths->nodes[index];
+
+        unsigned int size = 1;
+
+        while(node->edgeCount > 0 && size < 2 * (unsigned int) node->edgeCount) {
+            size *= 2;
+        }
+
+        node->slots = (int) total;
+        node->mask = size - 1;
+
+        total += size;
+    }
+
+    paths->slots = (int *) calloc(total, sizeof(int));
+
+    if(paths->slots == NULL)
+        return JSON_ERROR_MALLOC;
+
+    for(int index = 0; index < paths->edgeCount; index++) {
+        const PathEdge * edge = &paths->edges[index];
+        const PathNode * node = &paths->nodes[edge->parent];
+
+        int * slots = &paths->slots[node->slots];
+        unsigned int slot = json_char_hash(edge->key, edge->length) & node->mask;
+
+        while(slots[slot] != 0) {
+            slot = (slot + 1) & node->mask;
+        }
+
+        slots[slot] = index + 1;
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Adds the next segment of a path to the trie, below the node, reusing the child if another path already has it.
+ *
+ * The hash tables are only built once every path has been added, so until then the edges are searched one by one.
+ */
+static int json_paths_addSegment(JsonPaths * paths, int parent, const char * key, size_t length, bool wildcard) {
+    if(wildcard && paths->nodes[parent].wildcard >= 0)
+        return paths->nodes[parent].wildcard;
+
+    if(!wildcard) {
+        for(int index = 0; index < paths->edgeCount; index++) {
+            PathEdge * edge = &paths->edges[index];
+
+            if(edge->parent == parent && edge->length == length && memcmp(edge->key, key, length) == 0)
+                return edge->node;
+        }
+    }
+
+    int node = paths->nodeCount++;
+
+    paths->nodes[node].edges = 0;
+    paths->nodes[node].edgeCount = 0;
+    paths->nodes[node].wildcard = -1;
+    paths->nodes[node].match = -1;
+
+    if(wildcard) {
+        paths->nodes[parent].wildcard = node;
+    } else {
+        PathEdge * edge = &paths->edges[paths->edgeCount++];
+
+        edge->key = key;
+        edge->length = length;
+        edge->parent = parent;
+        edge->node = node;
+    }
+
+    return node;
+}
+
+/*
+ * Adds a JSON Pointer to the trie, unescaping its segments into keys.
+ *
+ * Returns JSON_ERROR_INVALID_POINTER if it does not start with a / or has a ~ that is not followed by 0 or 1.
+ */
+static JsonError json_paths_add(JsonPaths * paths, int path, const char * pointer, char ** keys) {
+    if(pointer[0] != '\0' && pointer[0] != '/')
+        return JSON_ERROR_INVALID_POINTER;
+
+    int node = 0;
+    int segments = 0;
+
+    while(*pointer == '/') {
+        pointer++;
+
+        char * key = *keys;
+        size_t length = 0;
+
+        while(*pointer != '\0' && *pointer != '/') {
+            if(*pointer == '~') {
+                if(pointer[1] != '0' && pointer[1] != '1')
+                    return JSON_ERROR_INVALID_POINTER;
+
+                key[length++] = (pointer[1] == '0' ? '~' : '/');
+                pointer += 2;
+            } else {
+                key[length++] = *pointer++;
+            }
+        }
+
+        *keys += length;
+
+        node = json_paths_addSegment(paths, node, key, length, length == 1 && key[0] == '*');
+        segments++;
+    }
+
+    if(segments > paths->height) {
+        paths->height = segments;
+    }
+
+    paths->nextMatch[path] = paths->nodes[node].match;
+    paths->nodes[node].match = path;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Compiles JSON Pointers into a trie that can be used to extract them from any number of values.
+ *
+ * Each pointer is a series of / separated keys, with ~0 for ~ and ~1 for /, where an all digit key
+ * also matches that element of an array. A key of * matches every member of an object or element of
+ * an array. The empty pointer matches the whole value. Returns NULL with JSON_ERROR_INVALID_POINTER
+ * if any pointer is not valid.
+ */
+JsonPaths * json_paths_compile(const char * const * pointers, int count, JsonError * error) {
+    int segments = 0;
+    size_t characters = 0;
+
+    for(int path = 0; path < count; path++) {
+        for(const char * pointer = pointers[path]; *pointer != '\0'; pointer++) {
+            segments += (*pointer == '/');
+        }
+
+        characters += strlen(pointers[path]);
+    }
+
+    JsonPaths * paths = (JsonPaths *) calloc(1, sizeof(JsonPaths));
+
+    if(paths == NULL) {
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    // Every segment adds at most one node below the root, and unescaping never makes a key longer.
+    paths->nodes = (PathNode *) malloc(((size_t) segments + 1) * sizeof(PathNode));
+    paths->edges = (PathEdge *) malloc(((size_t) segments + 1) * sizeof(PathEdge));
+    paths->keys = (char *) malloc(characters + 1);
+    paths->nextMatch = (int *) malloc(((size_t) count + 1) * sizeof(int));
+
+    if(paths->nodes == NULL || paths->edges == NULL || paths->keys == NULL || paths->nextMatch == NULL) {
+        json_paths_destroy(paths);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    paths->nodes[0].edges = 0;
+    paths->nodes[0].edgeCount = 0;
+    paths->nodes[0].wildcard = -1;
+    paths->nodes[0].match = -1;
+
+    paths->nodeCount = 1;
+    paths->count = count;
+
+    char * keys = paths->keys;
+
+    for(int path = 0; path < count; path++) {
+        *error = json_paths_add(paths, path, pointers[path], &keys);
+
+        if(*error != JSON_SUCCESS) {
+            json_paths_destroy(paths);
+            return NULL;
+        }
+    }
+
+    qsort(paths->edges, (size_t) paths->edgeCount, sizeof(PathEdge), json_paths_compareEdges);
+
+    for(int index = paths->edgeCount - 1; index >= 0; index--) {
+        PathNode * parent = &paths->nodes[paths->edges[index].parent];
+
+        parent->edges = index;
+        parent->edgeCount++;
+    }
+
+    *error = json_paths_buildSlots(paths);
+
+    if(*error != JSON_SUCCESS) {
+        json_paths_destroy(paths);
+        return NULL;
+    }
+
+    return paths;
+}
+
+/*
+ * Frees the compiled paths, which must not be in use by any extractor.
+ */
+void json_paths_destroy(JsonPaths * paths) {
+    free(paths->nodes);
+    free(paths->edges);
+    free(paths->keys);
+    free(paths->slots);
+    free(paths->nextMatch);
+    free(paths);
+}
+
+/*
+ * Create an extractor that reads values from a tokenizer, calling the callback for each value matched by the paths.
+ *
+ * The paths are only read, so many extractors, such as one for each thread, can share them.
+ */
+PathExtractor * json_pathExtractor_create(const JsonPaths * paths, JsonPathCallback callback, void * context, JsonError * error) {
+    PathExtractor * extractor = (PathExtractor *) malloc(sizeof(PathExtractor));
+
+    if(extractor == NULL) {
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    // The objects and arrays gone into are never deeper than the longest path, and each holds different nodes.
+    extractor->frames = (PathFrame *) malloc(((size_t) paths->height + 1) * sizeof(PathFrame));
+    extractor->nodes = (int *) malloc((size_t) paths->nodeCount * sizeof(int));
+
+    if(extractor->frames == NULL || extractor->nodes == NULL) {
+        json_pathExtractor_destroy(extractor);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    extractor->paths = paths;
+    extractor->callback = callback;
+    extractor->context = context;
+
+    json_pathExtractor_reset(extractor);
+
+    *error = JSON_SUCCESS;
+
+    return extractor;
+}
+
+/*
+ * Frees the extractor, but not its paths.
+ */
+void json_pathExtractor_destroy(PathExtractor * extractor) {
+    free(extractor->frames);
+    free(extractor->nodes);
+    free(extractor);
+}
+
+/*
+ * Prepares the extractor to extract from another value from the start.
+ */
+void json_pathExtractor_reset(PathExtractor * extractor) {
+    extractor->depth = 0;
+
+    extractor->frames[0].after = JSON_SAX_DONE;
+    extractor->frames[0].start = 0;
+    extractor->frames[0].count = 0;
+    extractor->frames[0].index = 0;
+
+    // The whole value is matched by the root of the trie.
+    extractor->nodes[0] = 0;
+    extractor->candidates = 1;
+
+    extractor->state = JSON_SAX_EXPECT_VALUE;
+    extractor->skipping = false;
+}
+
+/*
+ * Finds the nodes matched by the member or element with the key, from the nodes matched by the current object or array.
+ */
+static void json_pathExtractor_follow(PathExtractor * extractor, const char * key, size_t length) {
+    const JsonPaths * paths = extractor->paths;
+    PathFrame * frame = &extractor->frames[extractor->depth];
+
+    int * candidates = &extractor->nodes[frame->start + frame->count];
+    int count = 0;
+
+    for(int index = frame->start; index < frame->start + frame->count; index++) {
+        const PathNode * node = &paths->nodes[extractor->nodes[index]];
+
+        if(node->edgeCount > 0) {
+            int child = json_paths_findChild(paths, node, key, length);
+
+            if(child >= 0) {
+                candidates[count++] = child;
+            }
+        }
+
+        if(node->wildcard >= 0) {
+            candidates[count++] = node->wildcard;
+        }
+    }
+
+    extractor->candidates = count;
+}
+
+/*
+ * Finds the nodes matched by the current element of an array, by its index written as a key.
+ */
+static void json_pathExtractor_followIndex(PathExtractor * extractor) {
+    char digits[JSON_PATHS_INDEX_DIGITS];
+    int start = JSON_PATHS_INDEX_DIGITS;
+
+    long int index = extractor->frames[extractor->depth].index;
+
+    do {
+        digits[--start] = (char) ('0' + index % 10);
+        index /= 10;
+    } while(index > 0);
+
+    json_pathExtractor_follow(extractor, &digits[start], (size_t) (JSON_PATHS_INDEX_DIGITS - start));
+}
+
+/*
+ * Calls the callback for every path ending at the nodes matched by the value just read.
+ */
+static JsonError json_pathExtractor_deliver(PathExtractor * extractor, TokenizerHandle * tokenizer, TokenType token) {
+    const JsonPaths * paths = extractor->paths;
+    PathFrame * frame = &extractor->frames[extractor->depth];
+
+    const int * candidates = &extractor->nodes[frame->start + frame->count];
+
+    for(int index = 0; index < extractor->candidates; index++) {
+        for(int path = paths->nodes[candidates[index]].match; path >= 0; path = paths->nextMatch[path]) {
+            JsonError error = extractor->callback(path, token, tokenizer, extractor->context);
+
+            if(error != JSON_SUCCESS)
+                return error;
+        }
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Whether any path carries on below the nodes matched by the value just read.
+ */
+static bool json_pathExtractor_continues(PathExtractor * extractor) {
+    const JsonPaths * paths = extractor->paths;
+    PathFrame * frame = &extractor->frames[extractor->depth];
+
+    const int * candidates = &extractor->nodes[frame->start + frame->count];
+
+    for(int index = 0; index < extractor->candidates; index++) {
+        const PathNode * node = &paths->nodes[candidates[index]];
+
+        if(node->edgeCount > 0 || node->wildcard >= 0)
+            return true;
+    }
+
+    return false;
+}
+
+/*
+ * Goes into the object or array just started, as some of the paths continue inside of it.
+ */
+static void json_pathExtractor_enter(PathExtractor * extractor, TokenType token) {
+    PathFrame * parent = &extractor->frames[extractor->depth];
+    PathFrame * frame = &extractor->frames[++extractor->depth];
+
+    frame->start = parent->start + parent->count;
+    frame->count = extractor->candidates;
+    frame->index = 0;
+
+    if(token == JSON_TOKEN_OBJECT_START) {
+        frame->after = JSON_SAX_EXPECT_COMMA_OR_OBJECT_END;
+        extractor->state = JSON_SAX_EXPECT_KEY_OR_OBJECT_END;
+    } else {
+        frame->after = JSON_SAX_EXPECT_COMMA_OR_ARRAY_END;
+        extractor->state = JSON_SAX_EXPECT_VALUE_OR_ARRAY_END;
+
+        json_pathExtractor_followIndex(extractor);
+    }
+}
+
+/*
+ * Reads the next value from the tokenizer, calling the callback with the path and the first token of
+ * each value that a path matches, for which the value can be read from the tokenizer. For objects and
+ * arrays only their start is given, and the paths that continue below them match what is inside.
+ *
+ * Values that no path goes into are skipped without being tokenized. Returns JSON_SUCCESS once the whole
+ * value has been read, and otherwise the same errors as json_sax_parse, including JSON_ERROR_NEED_MORE
+ * when pushed input runs out, after which calling this again carries on from where it stopped. If the
+ * callback returns anything other than JSON_SUCCESS extraction stops and that is returned.
+ */
+JsonError json_pathExtractor_extract(PathExtractor * extractor, TokenizerHandle * tokenizer) {
+    JsonError error = JSON_SUCCESS;
+
+    const char * key;
+    size_t length;
+
+    while(extractor->state != JSON_SAX_DONE) {
+        if(extractor->skipping) {
+            error = json_tokenizer_skipValue(tokenizer);
+
+            if(error != JSON_SUCCESS)
+                return error;
+
+            extractor->skipping = false;
+            extractor->state = (SaxState) extractor->frames[extractor->depth].after;
+            continue;
+        }
+
+        TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+        switch(token) {
+            case JSON_TOKEN_ERROR:
+                return json_tokenizer_getError(tokenizer);
+            case JSON_TOKEN_EOF:
+                return JSON_ERROR_EOF;
+            case JSON_TOKEN_NEED_MORE:
+                return JSON_ERROR_NEED_MORE;
+            default:
+                break;
+        }
+
+        switch((SaxAction) json_sax_grammar[extractor->state][token]) {
+            case JSON_SAX_REJECT:
+                return JSON_ERROR_UNEXPECTED_TOKEN;
+            case JSON_SAX_START_OBJECT:
+            case JSON_SAX_START_ARRAY:
+                error = json_pathExtractor_deliver(extractor, tokenizer, token);
+
+                if(error != JSON_SUCCESS)
+                    return error;
+
+                if(json_pathExtractor_continues(extractor)) {
+                    json_pathExtractor_enter(extractor, token);
+                    break;
+                }
+
+                // Nothing inside is wanted, so the rest of it is skipped as if it had never been started.
+                extractor->skipping = true;
+
+                error = json_tokenizer_skipContainers(tokenizer, 1);
+
+                if(error != JSON_SUCCESS)
+                    return error;
+
+                extractor->skipping = false;
+                extractor->state = (SaxState) extractor->frames[extractor->depth].after;
+                break;
+            case JSON_SAX_END_OBJECT:
+            case JSON_SAX_END_ARRAY:
+                extractor->state = (SaxState) extractor->frames[--extractor->depth].after;
+                break;
+            case JSON_SAX_KEY:
+                extractor->state = JSON_SAX_EXPECT_COLON;
+
+                json_tokenizer_getStringSlice(tokenizer, &key, &length);
+                json_pathExtractor_follow(extractor, key, length);
+                break;
+            case JSON_SAX_COLON:
+                extractor->state = JSON_SAX_EXPECT_VALUE;
+                extractor->skipping = (extractor->candidates == 0);
+                break;
+            case JSON_SAX_NEXT_MEMBER:
+                extractor->state = JSON_SAX_EXPECT_KEY;
+                break;
+            case JSON_SAX_NEXT_ELEMENT:
+                extractor->state = JSON_SAX_EXPECT_VALUE;
+                extractor->frames[extractor->depth].index++;
+
+                json_pathExtractor_followIndex(extractor);
+
+                extractor->skipping = (extractor->candidates == 0);
+                break;
+            default:
+                // Every other action is a scalar value.
+                extractor->state = (SaxState) extractor->frames[extractor->depth].after;
+
+                error = json_pathExtractor_deliver(extractor, tokenizer, token);
+                break;
+        }
+
+        if(error != JSON_SUCCESS)
+            return error;
+    }
+
+    return JSON_SUCCESS;
+}
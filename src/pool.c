@@ -0,0 +1,130 @@
+#include <pthread.h>
+
+#include "allocator_internal.h"
+#include "buffer_internal.h"
+#include "tokenizer_internal.h"
+
+/*
+ * The most tokenizers kept for reuse by each thread.
+ */
+#define JSON_TOKENIZER_POOL_SIZE 8
+
+typedef struct TokenizerPool TokenizerPool;
+
+/*
+ * The tokenizers released by a thread, each with a fixed buffer, waiting to be acquired again by the same thread.
+ */
+struct TokenizerPool {
+    TokenizerHandle * tokenizers[JSON_TOKENIZER_POOL_SIZE];
+    int count;
+};
+
+static _Thread_local TokenizerPool json_tokenizerPool_local;
+
+/*
+ * Frees the tokenizers of a thread's pool when the thread exits.
+ */
+static pthread_key_t json_tokenizerPool_exitKey;
+static pthread_once_t json_tokenizerPool_exitKeyOnce = PTHREAD_ONCE_INIT;
+
+/*
+ * Destroys every tokenizer in the pool.
+ */
+static void json_tokenizerPool_empty(TokenizerPool * pool) {
+    while(pool->count > 0) {
+        json_tokenizer_destroy(pool->tokenizers[--pool->count]);
+    }
+}
+
+/*
+ * Empties the pool of a thread that is exiting.
+ */
+static void json_tokenizerPool_onThreadExit(void * pool) {
+    json_tokenizerPool_empty((TokenizerPool *) pool);
+}
+
+/*
+ * Creates the key used to empty the pool of each thread as it exits.
+ */
+static void json_tokenizerPool_createExitKey(void) {
+    pthread_key_create(&json_tokenizerPool_exitKey, json_tokenizerPool_onThreadExit);
+}
+
+/*
+ * Gets a tokenizer reading from a fixed buffer over contents, reusing one released by this thread if there is one.
+ *
+ * A reused tokenizer keeps the memory of its value buffer, so reading many small inputs one after
+ * another does not allocate once the pool is warm. The tokenizer should be given back with
+ * json_tokenizerPool_release rather than destroyed.
+ */
+TokenizerHandle * json_tokenizerPool_acquire(char * contents, size_t bufferSize, size_t history, JsonError * error) {
+    TokenizerPool * pool = &json_tokenizerPool_local;
+
+    if(pool->count > 0) {
+        TokenizerHandle * tokenizer = pool->tokenizers[--pool->count];
+        JsonBuffer * buffer = json_tokenizer_getBuffer(tokenizer);
+
+        json_bufferFixed_reset(buffer, contents, bufferSize);
+        buffer->history = history;
+
+        // The keys set by whoever had the tokenizer before may since have been destroyed.
+        json_tokenizer_setKeys(tokenizer, NULL);
+
+        *error = json_tokenizer_reset(tokenizer, NULL);
+
+        return tokenizer;
+    }
+
+    JsonBuffer * buffer = json_bufferFixed_create(contents, bufferSize, history, error);
+
+    if(buffer == NULL) {
+        return NULL;
+    }
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(buffer, error);
+
+    if(tokenizer == NULL) {
+        json_buffer_destroy(buffer);
+        return NULL;
+    }
+
+    json_tokenizer_setPooled(tokenizer, true);
+
+    return tokenizer;
+}
+
+/*
+ * Gives a tokenizer back to the pool of this thread, destroying it if the pool is full.
+ *
+ * Only tokenizers handed out by json_tokenizerPool_acquire are kept, and only while they still read from a
+ * fixed buffer made with the default allocator, since the pool holds on to them for as long as the thread runs.
+ * Any other tokenizer, such as one whose buffer uses memory from json_allocator_createFixed, is destroyed.
+ * Anything the tokenizer returned, such as string values, is no longer valid afterwards.
+ */
+JsonError json_tokenizerPool_release(TokenizerHandle * tokenizer) {
+    TokenizerPool * pool = &json_tokenizerPool_local;
+
+    JsonBuffer * buffer = json_tokenizer_getBuffer(tokenizer);
+
+    if(pool->count == JSON_TOKENIZER_POOL_SIZE || !json_tokenizer_isPooled(tokenizer) ||
+       buffer->bufferType != JSON_BUFFER_FIXED || !json_allocator_isDefault(&buffer->allocator)) {
+        return json_tokenizer_destroy(tokenizer);
+    }
+
+    // The pool is emptied when the thread exits, which needs the key to be set for the thread.
+    if(pthread_once(&json_tokenizerPool_exitKeyOnce, json_tokenizerPool_createExitKey) != 0 ||
+       pthread_setspecific(json_tokenizerPool_exitKey, pool) != 0) {
+        return json_tokenizer_destroy(tokenizer);
+    }
+
+    pool->tokenizers[pool->count++] = tokenizer;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Destroys the tokenizers in the pool of this thread, which otherwise happens when the thread exits.
+ */
+void json_tokenizerPool_clear(void) {
+    json_tokenizerPool_empty(&json_tokenizerPool_local);
+}
@@ -0,0 +1,244 @@
+#include <stdlib.h>
+
+#include "sax_internal.h"
+
+/*
+ * The actions for every token that can start a value.
+ */
+#define JSON_SAX_VALUE_ACTIONS \
+    [JSON_TOKEN_OBJECT_START] = JSON_SAX_START_OBJECT, \
+    [JSON_TOKEN_ARRAY_START] = JSON_SAX_START_ARRAY, \
+    [JSON_TOKEN_TEXT] = JSON_SAX_STRING, \
+    [JSON_TOKEN_NUMBER_DECIMAL] = JSON_SAX_DECIMAL, \
+    [JSON_TOKEN_NUMBER_BIG_DECIMAL] = JSON_SAX_BIG_NUMBER, \
+    [JSON_TOKEN_NUMBER_INTEGER] = JSON_SAX_INTEGER, \
+    [JSON_TOKEN_NUMBER_BIG_INTEGER] = JSON_SAX_BIG_NUMBER, \
+    [JSON_TOKEN_TRUE] = JSON_SAX_TRUE, \
+    [JSON_TOKEN_FALSE] = JSON_SAX_FALSE, \
+    [JSON_TOKEN_NULL] = JSON_SAX_NULL
+
+/*
+ * The JSON grammar, as the action for each token in each state. Every token not listed is rejected.
+ */
+const unsigned char json_sax_grammar[JSON_SAX_STATE_COUNT][JSON_SAX_TOKEN_COUNT] = {
+    [JSON_SAX_EXPECT_VALUE] = {
+        JSON_SAX_VALUE_ACTIONS
+    },
+    [JSON_SAX_EXPECT_VALUE_OR_ARRAY_END] = {
+        JSON_SAX_VALUE_ACTIONS,
+        [JSON_TOKEN_ARRAY_END] = JSON_SAX_END_ARRAY
+    },
+    [JSON_SAX_EXPECT_KEY] = {
+        [JSON_TOKEN_TEXT] = JSON_SAX_KEY
+    },
+    [JSON_SAX_EXPECT_KEY_OR_OBJECT_END] = {
+        [JSON_TOKEN_TEXT] = JSON_SAX_KEY,
+        [JSON_TOKEN_OBJECT_END] = JSON_SAX_END_OBJECT
+    },
+    [JSON_SAX_EXPECT_COLON] = {
+        [JSON_TOKEN_COLON] = JSON_SAX_COLON
+    },
+    [JSON_SAX_EXPECT_COMMA_OR_OBJECT_END] = {
+        [JSON_TOKEN_COMMA] = JSON_SAX_NEXT_MEMBER,
+        [JSON_TOKEN_OBJECT_END] = JSON_SAX_END_OBJECT
+    },
+    [JSON_SAX_EXPECT_COMMA_OR_ARRAY_END] = {
+        [JSON_TOKEN_COMMA] = JSON_SAX_NEXT_ELEMENT,
+        [JSON_TOKEN_ARRAY_END] = JSON_SAX_END_ARRAY
+    }
+};
+
+/*
+ * Contains the state of a parse, so that it can be carried on when pushed input runs out.
+ */
+struct SaxParser {
+    const JsonHandlers * handlers;
+    void * context;
+
+    // The state to return to after a value at each depth, where the top level is depth 0.
+    unsigned char * stack;
+    int maxDepth;
+    int depth;
+
+    SaxState state;
+};
+
+/*
+ * Calls a handler if it has been set, returning its result.
+ */
+#define json_sax_call(parser, handler, ...) \
+    ((parser)->handlers->handler == NULL ? JSON_SUCCESS : (parser)->handlers->handler(__VA_ARGS__, (parser)->context))
+
+/*
+ * Calls a handler that takes no arguments other than the context, if it has been set.
+ */
+#define json_sax_callEvent(parser, handler) \
+    ((parser)->handlers->handler == NULL ? JSON_SUCCESS : (parser)->handlers->handler((parser)->context))
+
+/*
+ * Create a parser that validates the tokens it reads against the JSON grammar, calling the matching
+ * handler for each part of the value. Handlers that are NULL are not called.
+ *
+ * Objects and arrays may be nested up to maxDepth deep, or 1024 deep if maxDepth is 0 or less.
+ */
+SaxParser * json_sax_create(const JsonHandlers * handlers, void * context, int maxDepth, JsonError * error) {
+    SaxParser * parser = (SaxParser *) malloc(sizeof(SaxParser));
+
+    if(parser == NULL) {
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    if(maxDepth <= 0) {
+        maxDepth = JSON_SAX_DEFAULT_MAX_DEPTH;
+    }
+
+    parser->stack = (unsigned char *) malloc((size_t) maxDepth + 1);
+
+    if(parser->stack == NULL) {
+        free(parser);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    parser->handlers = handlers;
+    parser->context = context;
+    parser->maxDepth = maxDepth;
+
+    json_sax_reset(parser);
+
+    *error = JSON_SUCCESS;
+
+    return parser;
+}
+
+/*
+ * Frees the parser.
+ */
+void json_sax_destroy(SaxParser * parser) {
+    free(parser->stack);
+    free(parser);
+}
+
+/*
+ * Prepares the parser to parse another value from the start.
+ */
+void json_sax_reset(SaxParser * parser) {
+    parser->stack[0] = JSON_SAX_DONE;
+    parser->depth = 0;
+
+    parser->state = JSON_SAX_EXPECT_VALUE;
+}
+
+/*
+ * Parses the next value from the tokenizer, calling the handlers as each part of it is read.
+ *
+ * Returns JSON_SUCCESS once the whole value has been read, without reading anything after it.
+ * Returns JSON_ERROR_UNEXPECTED_TOKEN if the tokens do not follow the JSON grammar, JSON_ERROR_MAX_DEPTH
+ * if the value is nested too deeply, and the error from the tokenizer if it fails. If a handler returns
+ * anything other than JSON_SUCCESS parsing stops and that is returned, for which JSON_ERROR_ABORTED
+ * can be used.
+ *
+ * If pushed input runs out JSON_ERROR_NEED_MORE is returned, and calling this again once more
+ * input has been fed carries on from where it stopped.
+ */
+JsonError json_sax_parse(SaxParser * parser, TokenizerHandle * tokenizer) {
+    JsonError error = JSON_SUCCESS;
+
+    const char * text;
+    size_t length;
+
+    while(parser->state != JSON_SAX_DONE) {
+        TokenType token = json_tokenizer_readNextToken(tokenizer);
+
+        switch(token) {
+            case JSON_TOKEN_ERROR:
+                return json_tokenizer_getError(tokenizer);
+            case JSON_TOKEN_EOF:
+                return JSON_ERROR_EOF;
+            case JSON_TOKEN_NEED_MORE:
+                return JSON_ERROR_NEED_MORE;
+            default:
+                break;
+        }
+
+        switch((SaxAction) json_sax_grammar[parser->state][token]) {
+            case JSON_SAX_REJECT:
+                return JSON_ERROR_UNEXPECTED_TOKEN;
+            case JSON_SAX_START_OBJECT:
+            case JSON_SAX_START_ARRAY:
+                if(parser->depth == parser->maxDepth)
+                    return JSON_ERROR_MAX_DEPTH;
+
+                // Remember where to carry on once the container is closed.
+                parser->stack[++parser->depth] = (token == JSON_TOKEN_OBJECT_START ? JSON_SAX_EXPECT_COMMA_OR_OBJECT_END : JSON_SAX_EXPECT_COMMA_OR_ARRAY_END);
+
+                if(token == JSON_TOKEN_OBJECT_START) {
+                    parser->state = JSON_SAX_EXPECT_KEY_OR_OBJECT_END;
+                    error = json_sax_callEvent(parser, onStartObject);
+                } else {
+                    parser->state = JSON_SAX_EXPECT_VALUE_OR_ARRAY_END;
+                    error = json_sax_callEvent(parser, onStartArray);
+                }
+                break;
+            case JSON_SAX_END_OBJECT:
+                parser->state = (SaxState) parser->stack[--parser->depth];
+                error = json_sax_callEvent(parser, onEndObject);
+                break;
+            case JSON_SAX_END_ARRAY:
+                parser->state = (SaxState) parser->stack[--parser->depth];
+                error = json_sax_callEvent(parser, onEndArray);
+                break;
+            case JSON_SAX_KEY:
+                parser->state = JSON_SAX_EXPECT_COLON;
+
+                json_tokenizer_getStringSlice(tokenizer, &text, &length);
+                error = json_sax_call(parser, onKey, text, length);
+                break;
+            case JSON_SAX_COLON:
+                parser->state = JSON_SAX_EXPECT_VALUE;
+                break;
+            case JSON_SAX_NEXT_MEMBER:
+                parser->state = JSON_SAX_EXPECT_KEY;
+                break;
+            case JSON_SAX_NEXT_ELEMENT:
+                parser->state = JSON_SAX_EXPECT_VALUE;
+                break;
+            case JSON_SAX_STRING:
+                parser->state = (SaxState) parser->stack[parser->depth];
+
+                json_tokenizer_getStringSlice(tokenizer, &text, &length);
+                error = json_sax_call(parser, onString, text, length);
+                break;
+            case JSON_SAX_INTEGER:
+                parser->state = (SaxState) parser->stack[parser->depth];
+                error = json_sax_call(parser, onInteger, json_tokenizer_getIntegerValue(tokenizer));
+                break;
+            case JSON_SAX_DECIMAL:
+                parser->state = (SaxState) parser->stack[parser->depth];
+                error = json_sax_call(parser, onDecimal, json_tokenizer_getDecimalValue(tokenizer));
+                break;
+            case JSON_SAX_BIG_NUMBER:
+                parser->state = (SaxState) parser->stack[parser->depth];
+
+                json_tokenizer_getNumberSlice(tokenizer, &text, &length);
+                error = json_sax_call(parser, onNumber, text, length);
+                break;
+            case JSON_SAX_TRUE:
+            case JSON_SAX_FALSE:
+                parser->state = (SaxState) parser->stack[parser->depth];
+                error = json_sax_call(parser, onBoolean, token == JSON_TOKEN_TRUE);
+                break;
+            case JSON_SAX_NULL:
+                parser->state = (SaxState) parser->stack[parser->depth];
+                error = json_sax_callEvent(parser, onNull);
+                break;
+        }
+
+        if(error != JSON_SUCCESS)
+            return error;
+    }
+
+    return JSON_SUCCESS;
+}
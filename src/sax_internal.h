@@ -0,0 +1,61 @@
+#ifndef JSON
+#define JSON
+#include "json.h"
+#endif
+
+/*
+ * The depth limit used when none is given.
+ */
+#define JSON_SAX_DEFAULT_MAX_DEPTH 1024
+
+/*
+ * The number of token types, used to size the grammar table.
+ */
+#define JSON_SAX_TOKEN_COUNT (JSON_TOKEN_NEED_MORE + 1)
+
+typedef enum SaxState SaxState;
+
+/*
+ * The tokens the parser accepts next.
+ */
+enum SaxState {
+    JSON_SAX_EXPECT_VALUE,
+    JSON_SAX_EXPECT_VALUE_OR_ARRAY_END,
+    JSON_SAX_EXPECT_KEY,
+    JSON_SAX_EXPECT_KEY_OR_OBJECT_END,
+    JSON_SAX_EXPECT_COLON,
+    JSON_SAX_EXPECT_COMMA_OR_OBJECT_END,
+    JSON_SAX_EXPECT_COMMA_OR_ARRAY_END,
+    JSON_SAX_DONE,
+
+    JSON_SAX_STATE_COUNT
+};
+
+typedef enum SaxAction SaxAction;
+
+/*
+ * What to do with a token in a state.
+ */
+enum SaxAction {
+    JSON_SAX_REJECT,
+    JSON_SAX_START_OBJECT,
+    JSON_SAX_END_OBJECT,
+    JSON_SAX_START_ARRAY,
+    JSON_SAX_END_ARRAY,
+    JSON_SAX_KEY,
+    JSON_SAX_COLON,
+    JSON_SAX_NEXT_MEMBER,
+    JSON_SAX_NEXT_ELEMENT,
+    JSON_SAX_STRING,
+    JSON_SAX_INTEGER,
+    JSON_SAX_DECIMAL,
+    JSON_SAX_BIG_NUMBER,
+    JSON_SAX_TRUE,
+    JSON_SAX_FALSE,
+    JSON_SAX_NULL
+};
+
+/*
+ * The JSON grammar, as the action for each token in each state. Every token not listed is rejected.
+ */
+extern const unsigned char json_sax_grammar[JSON_SAX_STATE_COUNT][JSON_SAX_TOKEN_COUNT];
@@ -0,0 +1,668 @@
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "characters.h"
+#include "simd_internal.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JSON_SIMD_X86
+#include <immintrin.h>
+#endif
+
+/*
+ * The implementations of each of the classification functions for an instruction set.
+ */
+typedef struct SimdFunctions SimdFunctions;
+
+struct SimdFunctions {
+    size_t (*countWhitespace)(const char * data, size_t length);
+    size_t (*findStringSpecial)(const char * data, size_t length);
+    size_t (*findStringSpecialOrMultibyte)(const char * data, size_t length);
+    size_t (*findBracketOrQuote)(const char * data, size_t length);
+    void (*classifyBlock)(const char * data, CharacterMasks * masks);
+
+    SimdLevel level;
+};
+
+static size_t json_simd_countWhitespace_unresolved(const char * data, size_t length);
+
+static size_t json_simd_findStringSpecial_unresolved(const char * data, size_t length);
+
+static size_t json_simd_findStringSpecialOrMultibyte_unresolved(const char * data, size_t length);
+
+static size_t json_simd_findBracketOrQuote_unresolved(const char * data, size_t length);
+
+static void json_simd_classifyBlock_unresolved(const char * data, CharacterMasks * masks);
+
+/*
+ * The functions used before the instruction set has been resolved, which resolve it and forward the call on.
+ */
+static const SimdFunctions json_simd_unresolvedFunctions = {
+    json_simd_countWhitespace_unresolved,
+    json_simd_findStringSpecial_unresolved,
+    json_simd_findStringSpecialOrMultibyte_unresolved,
+    json_simd_findBracketOrQuote_unresolved,
+    json_simd_classifyBlock_unresolved,
+    JSON_SIMD_SCALAR
+};
+
+/*
+ * The functions currently in use, resolved on first use to the best supported instruction set.
+ *
+ * This only ever points to one of the constant tables and is swapped atomically, so threads that tokenize
+ * at the same time, such as the workers of json_ndjson_process, each see one complete table.
+ */
+static _Atomic(const SimdFunctions *) json_simd_functions = &json_simd_unresolvedFunctions;
+
+static pthread_once_t json_simd_resolveOnce = PTHREAD_ONCE_INIT;
+
+/*
+ * Gets the table of functions currently in use.
+ */
+#define json_simd_active() atomic_load_explicit(&json_simd_functions, memory_order_acquire)
+
+//
+// Scalar
+//
+
+static size_t json_simd_countWhitespace_scalar(const char * data, size_t length) {
+    size_t index = 0;
+
+    while(index < length && json_char_isWhitespace(data[index])) {
+        index++;
+    }
+
+    return index;
+}
+
+static size_t json_simd_findStringSpecial_scalar(const char * data, size_t length) {
+    size_t index = 0;
+
+    while(index < length) {
+        char current = data[index];
+
+        if(current == '"' || current == '\\' || json_char_isControlCharacter(current)) {
+            break;
+        }
+
+        index++;
+    }
+
+    return index;
+}
+
+static size_t json_simd_findStringSpecialOrMultibyte_scalar(const char * data, size_t length) {
+    size_t index = 0;
+
+    while(index < length) {
+        unsigned char current = (unsigned char) data[index];
+
+        if(current == '"' || current == '\\' || current < 32 || current >= 0x80) {
+            break;
+        }
+
+        index++;
+    }
+
+    return index;
+}
+
+static size_t json_simd_findBracketOrQuote_scalar(const char * data, size_t length) {
+    size_t index = 0;
+
+    while(index < length) {
+        char current = data[index];
+
+        if(current == '"' || current == '{' || current == '}' || current == '[' || current == ']') {
+            break;
+        }
+
+        index++;
+    }
+
+    return index;
+}
+
+static void json_simd_classifyBlock_scalar(const char * data, CharacterMasks * masks) {
+    masks->whitespace = 0;
+    masks->structural = 0;
+    masks->quote = 0;
+    masks->backslash = 0;
+
+    for(int index = 0; index < JSON_SIMD_BLOCK_SIZE; index++) {
+        uint64_t bit = (uint64_t) 1 << index;
+
+        switch(data[index]) {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                masks->whitespace |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                masks->structural |= bit;
+                break;
+            case '"':
+                masks->quote |= bit;
+                break;
+            case '\\':
+                masks->backslash |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+#ifdef JSON_SIMD_X86
+
+//
+// SSE2
+//
+
+__attribute__((target("sse2")))
+static size_t json_simd_countWhitespace_sse2(const char * data, size_t length) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i newLine = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    const __m128i tab = _mm_set1_epi8('\t');
+
+    size_t index = 0;
+
+    while(index + 16 <= length) {
+        __m128i chars = _mm_loadu_si128((const __m128i *) &data[index]);
+
+        __m128i whitespace = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chars, space), _mm_cmpeq_epi8(chars, newLine)),
+                _mm_or_si128(_mm_cmpeq_epi8(chars, carriageReturn), _mm_cmpeq_epi8(chars, tab)));
+
+        unsigned int other = ~((unsigned int) _mm_movemask_epi8(whitespace)) & 0xFFFFu;
+
+        if(other != 0) {
+            return index + __builtin_ctz(other);
+        }
+
+        index += 16;
+    }
+
+    return index + json_simd_countWhitespace_scalar(&data[index], length - index);
+}
+
+__attribute__((target("sse2")))
+static size_t json_simd_findStringSpecial_sse2(const char * data, size_t length) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i maxControl = _mm_set1_epi8(31);
+
+    size_t index = 0;
+
+    while(index + 16 <= length) {
+        __m128i chars = _mm_loadu_si128((const __m128i *) &data[index]);
+
+        // A character is a control character if it is unchanged by an unsigned min with 31.
+        __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chars, quote), _mm_cmpeq_epi8(chars, backslash)),
+                _mm_cmpeq_epi8(_mm_min_epu8(chars, maxControl), chars));
+
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(special);
+
+        if(mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+
+        index += 16;
+    }
+
+    return index + json_simd_findStringSpecial_scalar(&data[index], length - index);
+}
+
+__attribute__((target("sse2")))
+static size_t json_simd_findStringSpecialOrMultibyte_sse2(const char * data, size_t length) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i maxControl = _mm_set1_epi8(31);
+
+    size_t index = 0;
+
+    while(index + 16 <= length) {
+        __m128i chars = _mm_loadu_si128((const __m128i *) &data[index]);
+
+        __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chars, quote), _mm_cmpeq_epi8(chars, backslash)),
+                _mm_cmpeq_epi8(_mm_min_epu8(chars, maxControl), chars));
+
+        // Characters of multibyte sequences are the only ones with the top bit set.
+        unsigned int mask = (unsigned int) (_mm_movemask_epi8(special) | _mm_movemask_epi8(chars));
+
+        if(mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+
+        index += 16;
+    }
+
+    return index + json_simd_findStringSpecialOrMultibyte_scalar(&data[index], length - index);
+}
+
+__attribute__((target("sse2")))
+static size_t json_simd_findBracketOrQuote_sse2(const char * data, size_t length) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i openBrace = _mm_set1_epi8('{');
+    const __m128i closeBrace = _mm_set1_epi8('}');
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+
+    size_t index = 0;
+
+    while(index + 16 <= length) {
+        __m128i chars = _mm_loadu_si128((const __m128i *) &data[index]);
+
+        // Setting bit 5 maps [ and ] onto { and }.
+        __m128i folded = _mm_or_si128(chars, caseBit);
+
+        __m128i special = _mm_or_si128(
+                _mm_cmpeq_epi8(chars, quote),
+                _mm_or_si128(_mm_cmpeq_epi8(folded, openBrace), _mm_cmpeq_epi8(folded, closeBrace)));
+
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(special);
+
+        if(mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+
+        index += 16;
+    }
+
+    return index + json_simd_findBracketOrQuote_scalar(&data[index], length - index);
+}
+
+__attribute__((target("sse2")))
+static void json_simd_classifyBlock_sse2(const char * data, CharacterMasks * masks) {
+    masks->whitespace = 0;
+    masks->structural = 0;
+    masks->quote = 0;
+    masks->backslash = 0;
+
+    for(int index = 0; index < JSON_SIMD_BLOCK_SIZE; index += 16) {
+        __m128i chars = _mm_loadu_si128((const __m128i *) &data[index]);
+
+        __m128i whitespace = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\n'))),
+                _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\t'))));
+
+        // Setting bit 5 maps [ and ] onto { and }, leaving the other characters that could match unchanged.
+        __m128i folded = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+
+        __m128i structural = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+                _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chars, _mm_set1_epi8(','))));
+
+        masks->whitespace |= (uint64_t) (unsigned int) _mm_movemask_epi8(whitespace) << index;
+        masks->structural |= (uint64_t) (unsigned int) _mm_movemask_epi8(structural) << index;
+        masks->quote |= (uint64_t) (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('"'))) << index;
+        masks->backslash |= (uint64_t) (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\\'))) << index;
+    }
+}
+
+//
+// AVX2
+//
+
+__attribute__((target("avx2")))
+static size_t json_simd_countWhitespace_avx2(const char * data, size_t length) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i newLine = _mm256_set1_epi8('\n');
+    const __m256i carriageReturn = _mm256_set1_epi8('\r');
+    const __m256i tab = _mm256_set1_epi8('\t');
+
+    size_t index = 0;
+
+    while(index + 32 <= length) {
+        __m256i chars = _mm256_loadu_si256((const __m256i *) &data[index]);
+
+        __m256i whitespace = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chars, space), _mm256_cmpeq_epi8(chars, newLine)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chars, carriageReturn), _mm256_cmpeq_epi8(chars, tab)));
+
+        unsigned int other = ~((unsigned int) _mm256_movemask_epi8(whitespace));
+
+        if(other != 0) {
+            return index + __builtin_ctz(other);
+        }
+
+        index += 32;
+    }
+
+    // Finish off with 16 characters at a time, as indentation is often shorter than 32 characters.
+    return index + json_simd_countWhitespace_sse2(&data[index], length - index);
+}
+
+__attribute__((target("avx2")))
+static size_t json_simd_findStringSpecial_avx2(const char * data, size_t length) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i maxControl = _mm256_set1_epi8(31);
+
+    size_t index = 0;
+
+    while(index + 32 <= length) {
+        __m256i chars = _mm256_loadu_si256((const __m256i *) &data[index]);
+
+        // A character is a control character if it is unchanged by an unsigned min with 31.
+        __m256i special = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chars, quote), _mm256_cmpeq_epi8(chars, backslash)),
+                _mm256_cmpeq_epi8(_mm256_min_epu8(chars, maxControl), chars));
+
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(special);
+
+        if(mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+
+        index += 32;
+    }
+
+    // Keys and short values are often shorter than 32 characters.
+    return index + json_simd_findStringSpecial_sse2(&data[index], length - index);
+}
+
+__attribute__((target("avx2")))
+static size_t json_simd_findStringSpecialOrMultibyte_avx2(const char * data, size_t length) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i maxControl = _mm256_set1_epi8(31);
+
+    size_t index = 0;
+
+    while(index + 32 <= length) {
+        __m256i chars = _mm256_loadu_si256((const __m256i *) &data[index]);
+
+        __m256i special = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chars, quote), _mm256_cmpeq_epi8(chars, backslash)),
+                _mm256_cmpeq_epi8(_mm256_min_epu8(chars, maxControl), chars));
+
+        // Characters of multibyte sequences are the only ones with the top bit set.
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(special) | (unsigned int) _mm256_movemask_epi8(chars);
+
+        if(mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+
+        index += 32;
+    }
+
+    return index + json_simd_findStringSpecialOrMultibyte_sse2(&data[index], length - index);
+}
+
+__attribute__((target("avx2")))
+static size_t json_simd_findBracketOrQuote_avx2(const char * data, size_t length) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i openBrace = _mm256_set1_epi8('{');
+    const __m256i closeBrace = _mm256_set1_epi8('}');
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+
+    size_t index = 0;
+
+    while(index + 32 <= length) {
+        __m256i chars = _mm256_loadu_si256((const __m256i *) &data[index]);
+
+        // Setting bit 5 maps [ and ] onto { and }.
+        __m256i folded = _mm256_or_si256(chars, caseBit);
+
+        __m256i special = _mm256_or_si256(
+                _mm256_cmpeq_epi8(chars, quote),
+                _mm256_or_si256(_mm256_cmpeq_epi8(folded, openBrace), _mm256_cmpeq_epi8(folded, closeBrace)));
+
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(special);
+
+        if(mask != 0) {
+            return index + __builtin_ctz(mask);
+        }
+
+        index += 32;
+    }
+
+    return index + json_simd_findBracketOrQuote_sse2(&data[index], length - index);
+}
+
+__attribute__((target("avx2")))
+static void json_simd_classifyBlock_avx2(const char * data, CharacterMasks * masks) {
+    masks->whitespace = 0;
+    masks->structural = 0;
+    masks->quote = 0;
+    masks->backslash = 0;
+
+    for(int index = 0; index < JSON_SIMD_BLOCK_SIZE; index += 32) {
+        __m256i chars = _mm256_loadu_si256((const __m256i *) &data[index]);
+
+        __m256i whitespace = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\n'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\t'))));
+
+        // Setting bit 5 maps [ and ] onto { and }, leaving the other characters that could match unchanged.
+        __m256i folded = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+
+        __m256i structural = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(','))));
+
+        masks->whitespace |= (uint64_t) (unsigned int) _mm256_movemask_epi8(whitespace) << index;
+        masks->structural |= (uint64_t) (unsigned int) _mm256_movemask_epi8(structural) << index;
+        masks->quote |= (uint64_t) (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('"'))) << index;
+        masks->backslash |= (uint64_t) (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\\'))) << index;
+    }
+}
+
+#endif
+
+//
+// Dispatch
+//
+
+/*
+ * Get the best instruction set supported by the running processor.
+ */
+SimdLevel json_simd_getSupportedLevel(void) {
+#ifdef JSON_SIMD_X86
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2")) {
+        return JSON_SIMD_AVX2;
+    }
+
+    if(__builtin_cpu_supports("sse2")) {
+        return JSON_SIMD_SSE2;
+    }
+#endif
+
+    return JSON_SIMD_SCALAR;
+}
+
+static const SimdFunctions json_simd_scalarFunctions = {
+    json_simd_countWhitespace_scalar,
+    json_simd_findStringSpecial_scalar,
+    json_simd_findStringSpecialOrMultibyte_scalar,
+    json_simd_findBracketOrQuote_scalar,
+    json_simd_classifyBlock_scalar,
+    JSON_SIMD_SCALAR
+};
+
+#ifdef JSON_SIMD_X86
+static const SimdFunctions json_simd_sse2Functions = {
+    json_simd_countWhitespace_sse2,
+    json_simd_findStringSpecial_sse2,
+    json_simd_findStringSpecialOrMultibyte_sse2,
+    json_simd_findBracketOrQuote_sse2,
+    json_simd_classifyBlock_sse2,
+    JSON_SIMD_SSE2
+};
+
+static const SimdFunctions json_simd_avx2Functions = {
+    json_simd_countWhitespace_avx2,
+    json_simd_findStringSpecial_avx2,
+    json_simd_findStringSpecialOrMultibyte_avx2,
+    json_simd_findBracketOrQuote_avx2,
+    json_simd_classifyBlock_avx2,
+    JSON_SIMD_AVX2
+};
+#endif
+
+/*
+ * Get the table of functions for an instruction set, limited to those supported by the running processor.
+ */
+static const SimdFunctions * json_simd_getFunctions(SimdLevel level) {
+    SimdLevel supported = json_simd_getSupportedLevel();
+
+    if(level > supported) {
+        level = supported;
+    }
+
+    switch(level) {
+#ifdef JSON_SIMD_X86
+        case JSON_SIMD_AVX2:
+            return &json_simd_avx2Functions;
+        case JSON_SIMD_SSE2:
+            return &json_simd_sse2Functions;
+#endif
+        default:
+            return &json_simd_scalarFunctions;
+    }
+}
+
+/*
+ * Selects the best supported instruction set, which happens once however many threads use the functions first.
+ */
+static void json_simd_resolve(void) {
+    atomic_store_explicit(&json_simd_functions, json_simd_getFunctions(json_simd_getSupportedLevel()), memory_order_release);
+}
+
+/*
+ * Get the instruction set currently in use.
+ */
+SimdLevel json_simd_getLevel(void) {
+    pthread_once(&json_simd_resolveOnce, json_simd_resolve);
+
+    return json_simd_active()->level;
+}
+
+/*
+ * Select the instruction set to use, limited to those supported by the running processor.
+ *
+ * Returns the level that was selected.
+ */
+SimdLevel json_simd_setLevel(SimdLevel level) {
+    // Resolving first means that a first use on another thread cannot replace the level selected here.
+    pthread_once(&json_simd_resolveOnce, json_simd_resolve);
+
+    const SimdFunctions * functions = json_simd_getFunctions(level);
+
+    atomic_store_explicit(&json_simd_functions, functions, memory_order_release);
+
+    return functions->level;
+}
+
+/*
+ * Get a string with the name of the instruction set.
+ */
+char * json_simd_levelName(SimdLevel level) {
+    switch(level) {
+        case JSON_SIMD_SCALAR:
+            return "Scalar";
+        case JSON_SIMD_SSE2:
+            return "SSE2";
+        case JSON_SIMD_AVX2:
+            return "AVX2";
+        default:
+            return "Unknown";
+    }
+}
+
+/*
+ * Resolves the functions to use on the first call, then forwards the call on.
+ */
+static size_t json_simd_countWhitespace_unresolved(const char * data, size_t length) {
+    json_simd_getLevel();
+
+    return json_simd_active()->countWhitespace(data, length);
+}
+
+/*
+ * Resolves the functions to use on the first call, then forwards the call on.
+ */
+static size_t json_simd_findStringSpecial_unresolved(const char * data, size_t length) {
+    json_simd_getLevel();
+
+    return json_simd_active()->findStringSpecial(data, length);
+}
+
+/*
+ * Resolves the functions to use on the first call, then forwards the call on.
+ */
+static size_t json_simd_findStringSpecialOrMultibyte_unresolved(const char * data, size_t length) {
+    json_simd_getLevel();
+
+    return json_simd_active()->findStringSpecialOrMultibyte(data, length);
+}
+
+/*
+ * Resolves the functions to use on the first call, then forwards the call on.
+ */
+static size_t json_simd_findBracketOrQuote_unresolved(const char * data, size_t length) {
+    json_simd_getLevel();
+
+    return json_simd_active()->findBracketOrQuote(data, length);
+}
+
+/*
+ * Resolves the functions to use on the first call, then forwards the call on.
+ */
+static void json_simd_classifyBlock_unresolved(const char * data, CharacterMasks * masks) {
+    json_simd_getLevel();
+
+    json_simd_active()->classifyBlock(data, masks);
+}
+
+/*
+ * Counts the whitespace characters at the start of data, looking at no more than length characters.
+ */
+size_t json_simd_countWhitespace(const char * data, size_t length) {
+    return json_simd_active()->countWhitespace(data, length);
+}
+
+/*
+ * Finds the first quotation mark, backslash or control character in data.
+ *
+ * Returns length if there is no such character within the first length characters.
+ */
+size_t json_simd_findStringSpecial(const char * data, size_t length) {
+    return json_simd_active()->findStringSpecial(data, length);
+}
+
+/*
+ * Finds the first quotation mark, backslash, control character or character of a multibyte sequence in data.
+ *
+ * Returns length if there is no such character within the first length characters.
+ */
+size_t json_simd_findStringSpecialOrMultibyte(const char * data, size_t length) {
+    return json_simd_active()->findStringSpecialOrMultibyte(data, length);
+}
+
+/*
+ * Finds the first quotation mark or bracket in data.
+ *
+ * Returns length if there is no such character within the first length characters.
+ */
+size_t json_simd_findBracketOrQuote(const char * data, size_t length) {
+    return json_simd_active()->findBracketOrQuote(data, length);
+}
+
+/*
+ * Classifies the JSON_SIMD_BLOCK_SIZE characters starting at data into masks.
+ */
+void json_simd_classifyBlock(const char * data, CharacterMasks * masks) {
+    json_simd_active()->classifyBlock(data, masks);
+}
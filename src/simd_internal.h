@@ -0,0 +1,95 @@
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum SimdLevel SimdLevel;
+
+typedef struct CharacterMasks CharacterMasks;
+
+/*
+ * The instruction sets that can be used to classify many characters at once.
+ *
+ * JSON_SIMD_SCALAR: One character at a time, available everywhere.
+ * JSON_SIMD_SSE2: 16 characters at a time.
+ * JSON_SIMD_AVX2: 32 characters at a time.
+ */
+enum SimdLevel {
+    JSON_SIMD_SCALAR,
+    JSON_SIMD_SSE2,
+    JSON_SIMD_AVX2
+};
+
+/*
+ * The size of the blocks classified by json_simd_classifyBlock.
+ */
+#define JSON_SIMD_BLOCK_SIZE 64
+
+/*
+ * Bitmasks describing a block of 64 characters, where bit i is set when character i is of that class.
+ *
+ * whitespace: Spaces, tabs, new lines and carriage returns.
+ * structural: The characters {, }, [, ], : and ,.
+ * quote: Quotation marks (").
+ * backslash: Backslashes (\).
+ */
+struct CharacterMasks {
+    uint64_t whitespace;
+    uint64_t structural;
+    uint64_t quote;
+    uint64_t backslash;
+};
+
+/*
+ * Get the best instruction set supported by the running processor.
+ */
+SimdLevel json_simd_getSupportedLevel(void);
+
+/*
+ * Get the instruction set currently in use.
+ */
+SimdLevel json_simd_getLevel(void);
+
+/*
+ * Select the instruction set to use, limited to those supported by the running processor.
+ *
+ * Returns the level that was selected.
+ */
+SimdLevel json_simd_setLevel(SimdLevel level);
+
+/*
+ * Get a string with the name of the instruction set.
+ */
+char * json_simd_levelName(SimdLevel level);
+
+/*
+ * Counts the whitespace characters at the start of data, looking at no more than length characters.
+ */
+size_t json_simd_countWhitespace(const char * data, size_t length);
+
+/*
+ * Finds the first character in data that cannot be copied directly out of a string,
+ * being a quotation mark ("), a backslash (\) or a control character.
+ *
+ * Returns length if there is no such character within the first length characters.
+ */
+size_t json_simd_findStringSpecial(const char * data, size_t length);
+
+/*
+ * Finds the first character in data that is special in a string or is part of a multibyte UTF-8 sequence,
+ * so that everything before it is known to be valid ASCII.
+ *
+ * Returns length if there is no such character within the first length characters.
+ */
+size_t json_simd_findStringSpecialOrMultibyte(const char * data, size_t length);
+
+/*
+ * Finds the first quotation mark (") or bracket ({, }, [ or ]) in data, which are the only characters
+ * that matter when skipping over the inside of an object or array.
+ *
+ * Returns length if there is no such character within the first length characters.
+ */
+size_t json_simd_findBracketOrQuote(const char * data, size_t length);
+
+/*
+ * Classifies the JSON_SIMD_BLOCK_SIZE characters starting at data into masks.
+ */
+void json_simd_classifyBlock(const char * data, CharacterMasks * masks);
@@ -0,0 +1,22 @@
+/*
+ * Statistics about the work done while tokenizing are only counted when built with JSON_STATS defined,
+ * so that they cost nothing otherwise.
+ */
+
+/*
+ * Adds amount to a counter when statistics are enabled, otherwise evaluates neither argument.
+ */
+#ifdef JSON_STATS
+#define json_stats_add(counter, amount) ((counter) += (size_t) (amount))
+#else
+#define json_stats_add(counter, amount) ((void) 0)
+#endif
+
+/*
+ * Raises a counter to value when statistics are enabled and value is larger.
+ */
+#ifdef JSON_STATS
+#define json_stats_max(counter, value) ((counter) = ((size_t) (value) > (counter) ? (size_t) (value) : (counter)))
+#else
+#define json_stats_max(counter, value) ((void) 0)
+#endif
@@ -0,0 +1,204 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "structural_internal.h"
+#include "simd_internal.h"
+#include "allocator_internal.h"
+
+/*
+ * The state carried from one block to the next while building the index.
+ */
+typedef struct BlockCarry BlockCarry;
+
+struct BlockCarry {
+    // Whether the first character of the next block is escaped by a backslash.
+    uint64_t escaped;
+
+    // All ones if the next block starts inside a string, otherwise zero.
+    uint64_t inString;
+
+    // Whether the last character was part of a run of characters other than a string.
+    uint64_t followsScalar;
+};
+
+/*
+ * Finds the characters that are escaped by an odd length run of backslashes.
+ */
+static uint64_t json_structural_findEscaped(uint64_t backslash, BlockCarry * carry) {
+    const uint64_t evenBits = 0x5555555555555555ULL;
+
+    // A backslash that is itself escaped does not escape the next character.
+    backslash &= ~carry->escaped;
+
+    uint64_t followsEscape = (backslash << 1) | carry->escaped;
+
+    // Adding the start of each run that begins on an odd bit carries through the run, which flips
+    // which of the characters following runs are escaped.
+    uint64_t oddStarts = backslash & ~evenBits & ~followsEscape;
+    uint64_t evenStarts;
+
+    carry->escaped = (uint64_t) __builtin_add_overflow(oddStarts, backslash, &evenStarts);
+
+    uint64_t invert = evenStarts << 1;
+
+    return (evenBits ^ invert) & followsEscape;
+}
+
+/*
+ * Sets each bit to the exclusive or of itself and every bit below it, so that each bit after
+ * an odd number of quotes is set.
+ */
+static uint64_t json_structural_prefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+}
+
+/*
+ * Finds the start of each token in a block of characters.
+ */
+static uint64_t json_structural_findTokens(const char * data, BlockCarry * carry) {
+    CharacterMasks masks;
+
+    json_simd_classifyBlock(data, &masks);
+
+    uint64_t escaped = json_structural_findEscaped(masks.backslash, carry);
+
+    // The opening quote of a string is inside it, the closing quote is not.
+    uint64_t quotes = masks.quote & ~escaped;
+    uint64_t inString = json_structural_prefixXor(quotes) ^ carry->inString;
+
+    carry->inString = (uint64_t) ((int64_t) inString >> 63);
+
+    // Everything within a string up to and including the closing quote.
+    uint64_t stringTail = inString ^ quotes;
+
+    // Runs of characters other than whitespace and structural characters start a token at their first character.
+    uint64_t scalar = ~(masks.structural | masks.whitespace);
+    uint64_t nonQuoteScalar = scalar & ~quotes;
+
+    uint64_t followsScalar = (nonQuoteScalar << 1) | carry->followsScalar;
+
+    carry->followsScalar = nonQuoteScalar >> 63;
+
+    return (masks.structural | (scalar & ~followsScalar)) & ~stringTail;
+}
+
+/*
+ * Appends the position of each set bit to the index, which must have room for them.
+ */
+static void json_structural_appendPositions(StructuralIndex * index, uint64_t tokens, uint32_t base) {
+    uint32_t * positions = &index->positions[index->count];
+
+    index->count += (size_t) __builtin_popcountll(tokens);
+
+    while(tokens != 0) {
+        *positions++ = base + (uint32_t) __builtin_ctzll(tokens);
+        tokens &= tokens - 1;
+    }
+}
+
+/*
+ * Ensures there is room for at least count more positions in the index.
+ */
+static JsonError json_structural_reserve(StructuralIndex * index, size_t count) {
+    if(index->count + count <= index->capacity)
+        return JSON_SUCCESS;
+
+    size_t capacity = index->capacity * 2;
+
+    if(capacity < index->count + count) {
+        capacity = index->count + count;
+    }
+
+    uint32_t * positions = json_allocator_realloc(index->allocator, index->positions, capacity * sizeof(uint32_t));
+
+    if(positions == NULL)
+        return JSON_ERROR_REALLOC;
+
+    index->positions = positions;
+    index->capacity = capacity;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Finds the start of every token in data from start up to end.
+ *
+ * The characters of a string that is not closed before end are all treated as part of the string.
+ * The index is allocated with the allocator passed, which must outlive it. Returns JSON_ERROR_FILE_TOO_LARGE
+ * if end is past the 4GB that the 32 bit positions can address.
+ */
+StructuralIndex * json_structural_build(const char * data, size_t start, size_t end, const JsonAllocator * allocator, JsonError * error) {
+    // Positions are kept in 32 bits to halve the size of the index, so larger buffers cannot be indexed.
+    if(end > UINT32_MAX) {
+        *error = JSON_ERROR_FILE_TOO_LARGE;
+        return NULL;
+    }
+
+    StructuralIndex * index = (StructuralIndex *) json_allocator_alloc(allocator, sizeof(StructuralIndex));
+
+    if(index == NULL) {
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    // Most documents have fewer than one token for every four characters.
+    index->capacity = (end - start) / 4 + JSON_SIMD_BLOCK_SIZE;
+    index->positions = json_allocator_alloc(allocator, index->capacity * sizeof(uint32_t));
+    index->count = 0;
+    index->next = 0;
+
+    index->allocator = allocator;
+
+    if(index->positions == NULL) {
+        json_allocator_free(allocator, index);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    BlockCarry carry = {0, 0, 0};
+
+    size_t length = end - start;
+
+    for(size_t offset = 0; offset < length; offset += JSON_SIMD_BLOCK_SIZE) {
+        const char * block = &data[start + offset];
+
+        // The last block is padded with whitespace, which never starts a token.
+        char padded[JSON_SIMD_BLOCK_SIZE];
+
+        if(length - offset < JSON_SIMD_BLOCK_SIZE) {
+            memset(padded, ' ', JSON_SIMD_BLOCK_SIZE);
+            memcpy(padded, block, length - offset);
+
+            block = padded;
+        }
+
+        *error = json_structural_reserve(index, JSON_SIMD_BLOCK_SIZE);
+
+        if(*error != JSON_SUCCESS) {
+            json_structural_destroy(index);
+            return NULL;
+        }
+
+        json_structural_appendPositions(index, json_structural_findTokens(block, &carry), (uint32_t) (start + offset));
+    }
+
+    *error = JSON_SUCCESS;
+
+    return index;
+}
+
+/*
+ * Frees the positions of the index and the index itself.
+ */
+void json_structural_destroy(StructuralIndex * index) {
+    json_allocator_free(index->allocator, index->positions);
+    json_allocator_free(index->allocator, index);
+}
@@ -0,0 +1,29 @@
+#ifndef JSON
+#define JSON
+#include "json.h"
+#endif
+
+#include <stdint.h>
+
+typedef struct StructuralIndex StructuralIndex;
+
+/*
+ * The positions of every token in a contiguous buffer, found ahead of tokenizing.
+ *
+ * Each position is the first character of a token: a structural character outside of a string,
+ * the opening quotation mark of a string, or the first character of any other run of characters.
+ */
+struct StructuralIndex {
+    uint32_t * positions;
+    size_t count;
+    size_t capacity;
+
+    // The next position to be tokenized.
+    size_t next;
+
+    const JsonAllocator * allocator;
+};
+
+StructuralIndex * json_structural_build(const char * data, size_t start, size_t end, const JsonAllocator * allocator, JsonError * error);
+
+void json_structural_destroy(StructuralIndex * index);
@@ -1,7 +1,28 @@
 #include <stdlib.h>
+#include <memory.h>
+#include <limits.h>
+#include <math.h>
 
 #include "buffer_internal.h"
 #include "tokenizer_internal.h"
+#include "simd_internal.h"
+#include "structural_internal.h"
+#include "allocator_internal.h"
+
+typedef struct SkipState SkipState;
+
+/*
+ * How far json_tokenizer_skipValue has got through a value, kept if the pushed input runs out part way through it.
+ */
+struct SkipState {
+    bool pending;
+
+    // The number of objects and arrays that have been opened but not closed.
+    int depth;
+
+    bool inString;
+    bool escaped;
+};
 
 /*
  * Contains data used by the tokenizer.
@@ -13,11 +34,39 @@ struct TokenizerHandle {
     long int integerValue;
 
     char * valueBuffer;
-    int valueBufferSize;
+    size_t valueBufferSize;
 
-    int valueBufferIndex;
+    size_t valueBufferIndex;
+
+    // The characters of the last string or number token, either in the value
+    // buffer or, when valueInBuffer is true, a slice of a contiguous buffer.
+    char * value;
+    size_t valueLength;
+    bool valueInBuffer;
+
+    // The keys that string tokens are looked up in by json_tokenizer_getKeyId, or NULL when none are set.
+    const JsonKeys * keys;
+
+    // The token positions used by the indexed engine, or NULL when streaming.
+    StructuralIndex * structurals;
+
+    // Whether a string was interrupted by the end of the pushed input, and is partly in the value buffer.
+    bool stringPending;
+
+    SkipState skip;
+
+    // Whether the tokenizer was handed out by json_tokenizerPool_acquire, so the pool may take it back.
+    bool pooled;
 
     JsonError error;
+
+    // A copy of the allocator of the buffer, kept so the tokenizer can be freed after the buffer.
+    JsonAllocator allocator;
+
+#ifdef JSON_STATS
+    // The counts kept by the tokenizer, with those kept by the buffer added in json_tokenizer_getStats.
+    TokenizerStats stats;
+#endif
 };
 
 /*
@@ -55,16 +104,37 @@ char * json_token_name(TokenType token) {
             return "Null";
         case JSON_TOKEN_EOF:
             return "End of file";
+        case JSON_TOKEN_NEED_MORE:
+            return "Need more input";
         default:
             return "Unknown token";
     }
 }
 
+/*
+ * Get a string with the name of a tokenizer engine.
+ */
+char * json_engine_name(TokenizerEngine engine) {
+    switch(engine) {
+        case JSON_ENGINE_STREAMING:
+            return "Streaming";
+        case JSON_ENGINE_INDEXED:
+            return "Indexed";
+        default:
+            return "Unknown engine";
+    }
+}
+
 /*
  * Create a tokenizer object that reads from the buffer.
+ *
+ * The tokenizer and its value buffer are allocated with the allocator of the buffer, so a buffer created with
+ * json_allocator_createFixed gives a tokenizer that never calls malloc.
  */
 TokenizerHandle * json_tokenizer_create(JsonBuffer * buffer, JsonError * error) {
-    TokenizerHandle * tokenizer = (TokenizerHandle *) malloc(sizeof(TokenizerHandle));
+    const JsonAllocator * allocator = &buffer->allocator;
+
+    TokenizerHandle * tokenizer = (TokenizerHandle *) json_allocator_alloc(allocator, sizeof(TokenizerHandle));
 
     if(tokenizer == NULL) {
         *error = JSON_ERROR_MALLOC;
@@ -72,28 +142,94 @@ TokenizerHandle * json_tokenizer_create(JsonBuffer * buffer, JsonError * error)
     }
 
     tokenizer->buffer = buffer;
+    tokenizer->allocator = *allocator;
 
-    tokenizer->valueBuffer = malloc(32);
+    tokenizer->valueBuffer = json_allocator_alloc(allocator, 32);
     tokenizer->valueBufferSize = 32;
 
     if(tokenizer->valueBuffer == NULL) {
-        free(tokenizer);
+        json_allocator_free(allocator, tokenizer);
 
         *error = JSON_ERROR_MALLOC;
         return NULL;
     }
 
-    tokenizer->error = JSON_SUCCESS;
+    tokenizer->structurals = NULL;
+    tokenizer->keys = NULL;
+    tokenizer->pooled = false;
+
+    json_tokenizer_startInput(tokenizer);
+
+#ifdef JSON_STATS
+    memset(&tokenizer->stats, 0, sizeof(TokenizerStats));
+    tokenizer->stats.valueBufferPeak = tokenizer->valueBufferSize;
+#endif
 
     *error = JSON_SUCCESS;
 
     return tokenizer;
 }
 
+/*
+ * Clears everything the tokenizer knows about the input it was reading, so that it reads from the start of its buffer.
+ */
+void json_tokenizer_startInput(TokenizerHandle * tokenizer) {
+    if(tokenizer->structurals != NULL) {
+        json_structural_destroy(tokenizer->structurals);
+        tokenizer->structurals = NULL;
+    }
+
+    tokenizer->value = tokenizer->valueBuffer;
+    tokenizer->valueLength = 0;
+    tokenizer->valueInBuffer = false;
+
+    tokenizer->stringPending = false;
+
+    tokenizer->skip.pending = false;
+
+    tokenizer->error = JSON_SUCCESS;
+}
+
+/*
+ * Rebinds the tokenizer to read from the start of buffer, keeping the memory of the tokenizer and the size its
+ * value buffer has grown to, so that reading many small inputs does not allocate for each of them.
+ *
+ * The buffer the tokenizer was reading from is destroyed unless it is the one passed, so a buffer refilled with
+ * json_bufferFixed_reset, json_bufferedFile_reset or json_bufferPush_reset can be passed again, as can NULL to
+ * keep the current buffer. The tokenizer goes back to the streaming engine, and its statistics carry on counting.
+ */
+JsonError json_tokenizer_reset(TokenizerHandle * tokenizer, JsonBuffer * buffer) {
+    JsonError error = JSON_SUCCESS;
+
+    if(buffer != NULL && buffer != tokenizer->buffer) {
+        error = json_buffer_destroy(tokenizer->buffer);
+
+        tokenizer->buffer = buffer;
+    }
+
+    json_tokenizer_startInput(tokenizer);
+
+    return error;
+}
+
+/*
+ * Sets whether the tokenizer belongs to the tokenizer pool, which only takes back tokenizers it handed out.
+ */
+void json_tokenizer_setPooled(TokenizerHandle * tokenizer, bool pooled) {
+    tokenizer->pooled = pooled;
+}
+
+/*
+ * Gets whether the tokenizer was handed out by the tokenizer pool.
+ */
+bool json_tokenizer_isPooled(TokenizerHandle * tokenizer) {
+    return tokenizer->pooled;
+}
+
 /*
  * Open a buffered file to read from for the tokenizer.
  */
-TokenizerHandle * json_tokenizer_openFile(char * file, int bufferSize, int history, JsonError * error) {
+TokenizerHandle * json_tokenizer_openFile(char * file, size_t bufferSize, size_t history, JsonError * error) {
     JsonBuffer * buffer = json_bufferedFile_open(file, bufferSize, history, error);
 
     if(buffer == NULL) {
@@ -103,22 +239,191 @@ TokenizerHandle * json_tokenizer_openFile(char * file, int bufferSize, int histo
     return json_tokenizer_create(buffer, error);
 }
 
+/*
+ * Map a whole file into memory to read from for the tokenizer.
+ */
+TokenizerHandle * json_tokenizer_openMappedFile(char * file, size_t history, bool hugePages, JsonError * error) {
+    JsonBuffer * buffer = json_bufferMapped_open(file, history, hugePages, error);
+
+    if(buffer == NULL) {
+        return NULL;
+    }
+
+    return json_tokenizer_create(buffer, error);
+}
+
+/*
+ * Create a tokenizer that reads input pushed to it with json_tokenizer_feed.
+ *
+ * When the tokenizer runs out of input part way through the input it returns JSON_TOKEN_NEED_MORE
+ * rather than blocking, and carries on from the same place once more input has been fed.
+ */
+TokenizerHandle * json_tokenizer_createPush(size_t bufferSize, size_t history, JsonError * error) {
+    JsonBuffer * buffer = json_bufferPush_create(bufferSize, history, error);
+
+    if(buffer == NULL) {
+        return NULL;
+    }
+
+    TokenizerHandle * tokenizer = json_tokenizer_create(buffer, error);
+
+    if(tokenizer == NULL) {
+        json_buffer_destroy(buffer);
+    }
+
+    return tokenizer;
+}
+
+/*
+ * Pushes the next chunk of input to a tokenizer created with json_tokenizer_createPush.
+ *
+ * The chunk is copied, so it can be reused as soon as this returns.
+ */
+JsonError json_tokenizer_feed(TokenizerHandle * tokenizer, const char * chunk, size_t length) {
+    return json_bufferPush_append(tokenizer->buffer, chunk, length);
+}
+
+/*
+ * Marks the end of the input pushed to a tokenizer, after which the remaining tokens can be read
+ * and JSON_TOKEN_EOF is returned instead of JSON_TOKEN_NEED_MORE.
+ */
+JsonError json_tokenizer_finish(TokenizerHandle * tokenizer) {
+    return json_bufferPush_finish(tokenizer->buffer);
+}
+
 /*
  * Destroy the buffer of the tokenizer and the tokenizer itself.
  */
 JsonError json_tokenizer_destroy(TokenizerHandle * tokenizer) {
+    if(tokenizer->structurals != NULL) {
+        json_structural_destroy(tokenizer->structurals);
+    }
+
+    JsonAllocator allocator = tokenizer->allocator;
+
+    json_allocator_free(&allocator, tokenizer->valueBuffer);
+
     JsonError error = json_buffer_destroy(tokenizer->buffer);
 
-    free(tokenizer);
+    json_allocator_free(&allocator, tokenizer);
 
     return error;
 }
 
+/*
+ * Selects how the tokenizer finds the tokens in its buffer, which does not change the tokens that are read.
+ *
+ * JSON_ENGINE_STREAMING: Reads one character at a time, and works with every type of buffer.
+ * JSON_ENGINE_INDEXED: Finds the start of every remaining token up front, then jumps between them. Only
+ *                      works with fixed and mapped buffers, otherwise JSON_ERROR_UNSUPPORTED_BUFFER is returned.
+ *
+ * The indexed engine falls back to streaming for the rest of the input after an error.
+ *
+ * Neither engine is faster for every input. Building the index only pays off where it lets the tokenizer
+ * jump over whitespace, so in bench_indexed the indexed engine is about 1.1-1.2x as fast on indented input
+ * but only about 0.85-0.95x as fast on minified input. Streaming stays the default, and indexing is worth
+ * choosing only for input that is known to be pretty printed.
+ */
+JsonError json_tokenizer_setEngine(TokenizerHandle * tokenizer, TokenizerEngine engine) {
+    JsonBuffer * buffer = tokenizer->buffer;
+
+    if(tokenizer->structurals != NULL) {
+        json_structural_destroy(tokenizer->structurals);
+        tokenizer->structurals = NULL;
+    }
+
+    if(engine == JSON_ENGINE_STREAMING)
+        return JSON_SUCCESS;
+
+    if(!json_buffer_isContiguous(buffer))
+        return JSON_ERROR_UNSUPPORTED_BUFFER;
+
+    JsonError error;
+
+    tokenizer->structurals = json_structural_build(buffer->buffer, buffer->index, buffer->read, &tokenizer->allocator, &error);
+
+    return error;
+}
+
+/*
+ * Get the engine the tokenizer is currently using to find tokens.
+ */
+TokenizerEngine json_tokenizer_getEngine(TokenizerHandle * tokenizer) {
+    return (tokenizer->structurals != NULL ? JSON_ENGINE_INDEXED : JSON_ENGINE_STREAMING);
+}
+
+/*
+ * Copies the value of the last token into the value buffer if it is a slice of the buffer, so it can be null terminated.
+ *
+ * Returns NULL and sets the error of the tokenizer if the value buffer could not be expanded.
+ */
+char * json_tokenizer_terminateValue(TokenizerHandle * tokenizer) {
+    if(!tokenizer->valueInBuffer) {
+        return tokenizer->value;
+    }
+
+    tokenizer->valueBufferIndex = 0;
+
+    JsonError error = json_tokenizer_reserveValueBuffer(tokenizer, tokenizer->valueLength + 1);
+
+    if(error != JSON_SUCCESS) {
+        tokenizer->error = error;
+        return NULL;
+    }
+
+    memcpy(tokenizer->valueBuffer, tokenizer->value, tokenizer->valueLength);
+    tokenizer->valueBuffer[tokenizer->valueLength] = '\0';
+
+    tokenizer->value = tokenizer->valueBuffer;
+    tokenizer->valueInBuffer = false;
+
+    return tokenizer->value;
+}
+
 /*
  * Get the string value associated with a JSON_TOKEN_STRING token.
+ *
+ * Strings sliced from a contiguous buffer are copied so that they can be null terminated.
+ * Returns NULL if that copy fails.
  */
 char * json_tokenizer_getStringValue(TokenizerHandle * tokenizer) {
-    return tokenizer->valueBuffer;
+    return json_tokenizer_terminateValue(tokenizer);
+}
+
+/*
+ * Get the string value associated with a JSON_TOKEN_STRING token without copying it where possible.
+ *
+ * For fixed and mapped buffers, strings without escape sequences point directly into the buffer and
+ * remain valid for as long as the buffer does. Otherwise they point to the unescaped string in the value
+ * buffer and remain valid until the next token is read. The string is not necessarily null terminated.
+ */
+void json_tokenizer_getStringSlice(TokenizerHandle * tokenizer, const char ** start, size_t * length) {
+    *start = tokenizer->value;
+    *length = tokenizer->valueLength;
+}
+
+/*
+ * Set the keys that json_tokenizer_getKeyId looks string tokens up in, or NULL to stop looking them up.
+ *
+ * The keys are not copied, and can be shared between any number of tokenizers. They stay set when the
+ * tokenizer is reset, so one tokenizer can dispatch on the same keys across many inputs.
+ */
+void json_tokenizer_setKeys(TokenizerHandle * tokenizer, const JsonKeys * keys) {
+    tokenizer->keys = keys;
+}
+
+/*
+ * Get the id of the key associated with a JSON_TOKEN_TEXT token in the keys set on the tokenizer.
+ *
+ * The key is looked up where its characters already are, so unlike json_tokenizer_getStringValue nothing is
+ * copied, and dispatching on the id replaces comparing the string against each key in turn.
+ * Returns -1 if the string is not one of the keys, or no keys are set.
+ */
+int json_tokenizer_getKeyId(TokenizerHandle * tokenizer) {
+    if(tokenizer->keys == NULL)
+        return -1;
+
+    return json_keys_find(tokenizer->keys, tokenizer->value, tokenizer->valueLength);
 }
 
 /*
@@ -127,9 +432,23 @@ char * json_tokenizer_getStringValue(TokenizerHandle * tokenizer) {
  *  - JSON_TOKEN_NUMBER_BIG_DECIMAL
  *  - JSON_TOKEN_NUMBER_INTEGER
  *  - JSON_TOKEN_NUMBER_BIG_INTEGER
+ *
+ * Numbers sliced from a contiguous buffer are copied so that they can be null terminated.
+ * Returns NULL if that copy fails.
  */
 char * json_tokenizer_getNumberValue(TokenizerHandle * tokenizer) {
-    return tokenizer->valueBuffer;
+    return json_tokenizer_terminateValue(tokenizer);
+}
+
+/*
+ * Get the characters of the number associated with a number token without copying them where possible.
+ *
+ * For fixed and mapped buffers the characters point directly into the buffer, otherwise they point
+ * into the value buffer. The characters are not necessarily null terminated.
+ */
+void json_tokenizer_getNumberSlice(TokenizerHandle * tokenizer, const char ** start, size_t * length) {
+    *start = tokenizer->value;
+    *length = tokenizer->valueLength;
 }
 
 /*
@@ -157,10 +476,32 @@ JsonBuffer * json_tokenizer_getBuffer(TokenizerHandle * tokenizer) {
  * Increases the size of the value buffer.
  */
 JsonError json_tokenizer_expandValueBuffer(TokenizerHandle * tokenizer) {
+    char * resized = json_allocator_realloc(&tokenizer->allocator, tokenizer->valueBuffer, tokenizer->valueBufferSize * 2);
+
+    if(resized == NULL)
+        return JSON_ERROR_REALLOC;
+
+    tokenizer->valueBuffer = resized;
     tokenizer->valueBufferSize *= 2;
-    tokenizer->valueBuffer = realloc(tokenizer->valueBuffer, (size_t) tokenizer->valueBufferSize);
 
-    return (tokenizer->valueBuffer == NULL ? JSON_ERROR_REALLOC : JSON_SUCCESS);
+    json_stats_add(tokenizer->stats.valueBufferReallocs, 1);
+    json_stats_max(tokenizer->stats.valueBufferPeak, tokenizer->valueBufferSize);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Ensures there is room for at least count more characters in the value buffer after valueBufferIndex.
+ */
+JsonError json_tokenizer_reserveValueBuffer(TokenizerHandle * tokenizer, size_t count) {
+    while(tokenizer->valueBufferIndex + count > tokenizer->valueBufferSize) {
+        JsonError error = json_tokenizer_expandValueBuffer(tokenizer);
+
+        if(error != JSON_SUCCESS)
+            return error;
+    }
+
+    return JSON_SUCCESS;
 }
 
 /*
@@ -183,6 +524,55 @@ JsonError json_tokenizer_appendToValueBuffer(TokenizerHandle * tokenizer, char c
     return JSON_SUCCESS;
 }
 
+/*
+ * Sets the value of the token to the characters written to the value buffer, then null terminates it.
+ */
+JsonError json_tokenizer_finishValueBuffer(TokenizerHandle * tokenizer) {
+    JsonError error = json_tokenizer_appendToValueBuffer(tokenizer, '\0');
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    tokenizer->value = tokenizer->valueBuffer;
+    tokenizer->valueLength = tokenizer->valueBufferIndex - 1;
+    tokenizer->valueInBuffer = false;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Sets the value of the token to a slice of the buffer from start up to the buffer index.
+ */
+void json_tokenizer_sliceValue(TokenizerHandle * tokenizer, size_t start, size_t end) {
+    tokenizer->value = &tokenizer->buffer->buffer[start];
+    tokenizer->valueLength = end - start;
+    tokenizer->valueInBuffer = true;
+}
+
+/*
+ * Appends a character of a number to the value buffer.
+ *
+ * Numbers in contiguous buffers are sliced from the buffer instead, so nothing is appended for them.
+ */
+JsonError json_tokenizer_appendNumberCharacter(TokenizerHandle * tokenizer, char character) {
+    if(json_buffer_isContiguous(tokenizer->buffer))
+        return JSON_SUCCESS;
+
+    return json_tokenizer_appendToValueBuffer(tokenizer, character);
+}
+
+/*
+ * Sets the value of the token to the number that has just been read, which started at start in the buffer.
+ */
+JsonError json_tokenizer_finishNumber(TokenizerHandle * tokenizer, size_t start) {
+    if(json_buffer_isContiguous(tokenizer->buffer)) {
+        json_tokenizer_sliceValue(tokenizer, start, tokenizer->buffer->index);
+        return JSON_SUCCESS;
+    }
+
+    return json_tokenizer_finishValueBuffer(tokenizer);
+}
+
 /*
  * If an error has occurred in the tokenizer this will return the error, otherwise will return JSON_SUCCESS.
  */
@@ -201,6 +591,29 @@ void json_tokenizer_logError(TokenizerHandle * tokenizer) {
     json_error_log(tokenizer->error, tokenizer->buffer);
 }
 
+/*
+ * Copies the statistics counted by the tokenizer and its buffer into stats.
+ *
+ * Returns JSON_ERROR_STATS_DISABLED and zeroes stats unless built with JSON_STATS defined.
+ */
+JsonError json_tokenizer_getStats(TokenizerHandle * tokenizer, TokenizerStats * stats) {
+#ifdef JSON_STATS
+    *stats = tokenizer->stats;
+
+    stats->fills = tokenizer->buffer->fills;
+    stats->bytesRead = tokenizer->buffer->bytesRead;
+    stats->historyMoved = tokenizer->buffer->historyMoved;
+
+    return JSON_SUCCESS;
+#else
+    (void) tokenizer;
+
+    memset(stats, 0, sizeof(TokenizerStats));
+
+    return JSON_ERROR_STATS_DISABLED;
+#endif
+}
+
 /*
  * Increments forward from the character at the buffer index until a non-whitespace character is found.
  */
@@ -208,12 +621,21 @@ JsonError json_tokenizer_skipWhitespace(TokenizerHandle * tokenizer) {
     JsonBuffer * buffer = tokenizer->buffer;
 
     while(true) {
-        while(buffer->index < buffer->read) {
+        if(buffer->index < buffer->read) {
+            // Most tokens in minified input are not preceded by whitespace, so avoid the call for them.
             if(!json_char_isWhitespace(json_buffer_get(buffer))) {
                 return JSON_SUCCESS;
             }
 
-            json_buffer_consume(buffer);
+            size_t count = json_simd_countWhitespace(&buffer->buffer[buffer->index], buffer->read - buffer->index);
+
+            buffer->index += count;
+
+            json_stats_add(tokenizer->stats.whitespace, count);
+
+            if(buffer->index < buffer->read) {
+                return JSON_SUCCESS;
+            }
         }
 
         JsonError error = json_buffer_fill(buffer);
@@ -229,116 +651,495 @@ JsonError json_tokenizer_skipWhitespace(TokenizerHandle * tokenizer) {
  * If an error occurs, JSON_TOKEN_ERROR will be returned and the error can be retrieved using json_tokenizer_getError.
  */
 TokenType json_tokenizer_readNextToken(TokenizerHandle * tokenizer) {
+    TokenType token = json_tokenizer_readEngineToken(tokenizer);
+
+    json_stats_add(tokenizer->stats.tokens[token], 1);
+
+    return token;
+}
+
+/*
+ * Reads the next token with the engine in use.
+ */
+TokenType json_tokenizer_readEngineToken(TokenizerHandle * tokenizer) {
+    if(tokenizer->structurals != NULL) {
+        return json_tokenizer_readIndexedToken(tokenizer);
+    }
+
+    if(tokenizer->stringPending) {
+        return json_tokenizer_readStringToken(tokenizer, true);
+    }
+
+    JsonError error = json_tokenizer_skipWhitespace(tokenizer);
+
+    if(error != JSON_SUCCESS) {
+        if(error == JSON_ERROR_EOF) {
+            return JSON_TOKEN_EOF;
+        }
+
+        if(error == JSON_ERROR_NEED_MORE) {
+            return JSON_TOKEN_NEED_MORE;
+        }
+
+        tokenizer->error = error;
+        return JSON_TOKEN_ERROR;
+    }
+
+    return json_tokenizer_readToken(tokenizer);
+}
+
+/*
+ * Reads the next token using the positions found by the structural index, skipping any whitespace before it.
+ *
+ * The index only disagrees with the characters read when a number or literal runs into other characters, as
+ * in "truex", in which case the rest of the input is read by the streaming engine to find the same error.
+ */
+TokenType json_tokenizer_readIndexedToken(TokenizerHandle * tokenizer) {
+    JsonBuffer * buffer = tokenizer->buffer;
+    StructuralIndex * structurals = tokenizer->structurals;
+
+    if(structurals->next == structurals->count) {
+        json_stats_add(tokenizer->stats.whitespace, buffer->read - buffer->index);
+
+        buffer->index = buffer->read;
+        return JSON_TOKEN_EOF;
+    }
+
+    size_t position = structurals->positions[structurals->next++];
+
+    // Everything between the end of the last token and the start of this one is whitespace.
+    json_stats_add(tokenizer->stats.whitespace, position - buffer->index);
+
+    buffer->index = position;
+
+    TokenType token = json_tokenizer_readToken(tokenizer);
+
+    bool fallBack;
+
+    switch(token) {
+        case JSON_TOKEN_ERROR:
+            fallBack = true;
+            break;
+        case JSON_TOKEN_NUMBER_DECIMAL:
+        case JSON_TOKEN_NUMBER_BIG_DECIMAL:
+        case JSON_TOKEN_NUMBER_INTEGER:
+        case JSON_TOKEN_NUMBER_BIG_INTEGER:
+        case JSON_TOKEN_TRUE:
+        case JSON_TOKEN_FALSE:
+        case JSON_TOKEN_NULL:
+            if(buffer->index < buffer->read) {
+                char next = json_buffer_get(buffer);
+
+                fallBack = !json_char_isWhitespace(next) && !json_char_isStructural(next);
+            } else {
+                fallBack = false;
+            }
+            break;
+        default:
+            fallBack = false;
+            break;
+    }
+
+    if(fallBack) {
+        json_structural_destroy(structurals);
+        tokenizer->structurals = NULL;
+    }
+
+    return token;
+}
+
+/*
+ * Reads the token starting at the buffer index, which must not be whitespace.
+ */
+TokenType json_tokenizer_readToken(TokenizerHandle * tokenizer) {
     JsonError error;
 
-    JsonBuffer * buffer = tokenizer->buffer;
+    JsonBuffer * buffer = tokenizer->buffer;
+
+    size_t start = buffer->index;
+
+    error = json_buffer_ensureAvailable(buffer);
+
+    if(error != JSON_SUCCESS) {
+        return json_tokenizer_tokenError(tokenizer, error, start);
+    }
+
+    char c = json_buffer_get_consume(buffer);
+
+    switch(c) {
+        case '{':
+            return JSON_TOKEN_OBJECT_START;
+        case '}':
+            return JSON_TOKEN_OBJECT_END;
+        case '[':
+            return JSON_TOKEN_ARRAY_START;
+        case ']':
+            return JSON_TOKEN_ARRAY_END;
+        case ':':
+            return JSON_TOKEN_COLON;
+        case ',':
+            return JSON_TOKEN_COMMA;
+        case '"':
+            return json_tokenizer_readStringToken(tokenizer, false);
+        case 't':
+            error = json_tokenizer_readExpected(tokenizer, "rue");
+
+            if(error != JSON_SUCCESS) {
+                if(error == JSON_ERROR_UNEXPECTED_CHAR) {
+                    error = JSON_ERROR_EXPECTED_TRUE;
+                }
+
+                return json_tokenizer_tokenError(tokenizer, error, start);
+            }
+
+            return JSON_TOKEN_TRUE;
+        case 'f':
+            error = json_tokenizer_readExpected(tokenizer, "alse");
+
+            if(error != JSON_SUCCESS) {
+                if(error == JSON_ERROR_UNEXPECTED_CHAR) {
+                    error = JSON_ERROR_EXPECTED_FALSE;
+                }
+
+                return json_tokenizer_tokenError(tokenizer, error, start);
+            }
+
+            return JSON_TOKEN_FALSE;
+        case 'n':
+            error = json_tokenizer_readExpected(tokenizer, "ull");
+
+            if(error != JSON_SUCCESS) {
+                if(error == JSON_ERROR_UNEXPECTED_CHAR) {
+                    error = JSON_ERROR_EXPECTED_NULL;
+                }
+
+                return json_tokenizer_tokenError(tokenizer, error, start);
+            }
+
+            return JSON_TOKEN_NULL;
+        default:
+            if(c == '-' || json_char_isDigit(c)) {
+                // The first character matters when reading the number
+                json_buffer_unconsume(buffer);
+
+                TokenType token;
+
+                error = json_tokenizer_readNumber(tokenizer, &token);
+
+                if(error) {
+                    return json_tokenizer_tokenError(tokenizer, error, start);
+                }
+
+                return token;
+            }
+
+            tokenizer->error = JSON_ERROR_UNEXPECTED_CHAR;
+            return JSON_TOKEN_ERROR;
+    }
+}
+
+/*
+ * Records an error that occurred while reading the token that started at start in the buffer.
+ *
+ * Running out of pushed input is not an error. Numbers and literals are short, so they are read
+ * again from their start once more input has been pushed.
+ */
+TokenType json_tokenizer_tokenError(TokenizerHandle * tokenizer, JsonError error, size_t start) {
+    if(error == JSON_ERROR_NEED_MORE) {
+        tokenizer->buffer->index = start;
+        return JSON_TOKEN_NEED_MORE;
+    }
+
+    tokenizer->error = error;
+    return JSON_TOKEN_ERROR;
+}
+
+/*
+ * Reads a string token, or carries on reading a string that was interrupted by the end of the pushed input.
+ *
+ * Strings can be arbitrarily long, so the characters read before running out of input are kept
+ * in the value buffer rather than being read again.
+ */
+TokenType json_tokenizer_readStringToken(TokenizerHandle * tokenizer, bool resume) {
+    JsonError error = (resume ? json_tokenizer_continueString(tokenizer) : json_tokenizer_readString(tokenizer));
+
+    tokenizer->stringPending = (error == JSON_ERROR_NEED_MORE);
+
+    if(error != JSON_SUCCESS) {
+        if(error == JSON_ERROR_NEED_MORE) {
+            return JSON_TOKEN_NEED_MORE;
+        }
+
+        tokenizer->error = error;
+        return JSON_TOKEN_ERROR;
+    }
+
+    return JSON_TOKEN_TEXT;
+}
+
+/*
+ * Skips over the next complete value without reading it into tokens.
+ *
+ * Strings are stepped over without being unescaped, and the contents of objects and arrays are only looked
+ * at to find quotation marks and brackets. So a container is not validated beyond finding where it ends, and
+ * mismatched bracket types or malformed numbers and literals inside of it are not noticed. A number or literal
+ * skipped on its own is read as a token, and fails in the same way as json_tokenizer_readNextToken would.
+ *
+ * Returns JSON_ERROR_UNEXPECTED_TOKEN without consuming anything if the next token does not start a value,
+ * so that it can still be read with json_tokenizer_readNextToken. Returns JSON_ERROR_EOF if there is no
+ * value left, and JSON_ERROR_NEED_MORE if pushed input runs out, in which case calling it again once
+ * more input has been fed carries on skipping from where it stopped.
+ */
+JsonError json_tokenizer_skipValue(TokenizerHandle * tokenizer) {
+    JsonError error;
+
+    JsonBuffer * buffer = tokenizer->buffer;
+    SkipState * skip = &tokenizer->skip;
+
+    if(tokenizer->structurals != NULL) {
+        return json_tokenizer_skipIndexedValue(tokenizer);
+    }
+
+    if(!skip->pending) {
+        error = json_tokenizer_skipWhitespace(tokenizer);
+
+        if(error != JSON_SUCCESS) {
+            if(error != JSON_ERROR_EOF && error != JSON_ERROR_NEED_MORE) {
+                tokenizer->error = error;
+            }
+
+            return error;
+        }
+
+        skip->depth = 0;
+        skip->inString = false;
+        skip->escaped = false;
+
+        switch(json_buffer_get(buffer)) {
+            case '{':
+            case '[':
+                skip->depth = 1;
+                break;
+            case '"':
+                skip->inString = true;
+                break;
+            case '}':
+            case ']':
+            case ':':
+            case ',':
+                tokenizer->error = JSON_ERROR_UNEXPECTED_TOKEN;
+                return JSON_ERROR_UNEXPECTED_TOKEN;
+            default:
+                return json_tokenizer_skipScalar(tokenizer);
+        }
+
+        json_buffer_consume(buffer);
+
+        skip->pending = true;
+    }
+
+    while(true) {
+        while(buffer->index < buffer->read) {
+            const char * data = &buffer->buffer[buffer->index];
+            size_t available = buffer->read - buffer->index;
+
+            if(skip->escaped) {
+                skip->escaped = false;
+
+                json_buffer_consume(buffer);
+                continue;
+            }
+
+            if(skip->inString) {
+                size_t run = json_simd_findStringSpecial(data, available);
+
+                buffer->index += run;
+
+                if(run == available)
+                    break;
+
+                char current = json_buffer_get_consume(buffer);
+
+                if(current == '\\') {
+                    skip->escaped = true;
+                } else if(current == '"') {
+                    skip->inString = false;
+
+                    if(skip->depth == 0)
+                        break;
+                } else {
+                    skip->pending = false;
+
+                    tokenizer->error = JSON_ERROR_ILLEGAL_TEXT_CHAR;
+                    return JSON_ERROR_ILLEGAL_TEXT_CHAR;
+                }
+            } else {
+                size_t run = json_simd_findBracketOrQuote(data, available);
+
+                buffer->index += run;
+
+                if(run == available)
+                    break;
+
+                char current = json_buffer_get_consume(buffer);
+
+                if(current == '"') {
+                    skip->inString = true;
+                } else if(current == '{' || current == '[') {
+                    skip->depth++;
+                } else if(--skip->depth == 0) {
+                    break;
+                }
+            }
+        }
+
+        if(buffer->index < buffer->read || (!skip->inString && !skip->escaped && skip->depth == 0)) {
+            skip->pending = false;
+            return JSON_SUCCESS;
+        }
+
+        error = json_buffer_fill(buffer);
+
+        if(error != JSON_SUCCESS) {
+            if(error == JSON_ERROR_NEED_MORE)
+                return error;
 
-    error = json_tokenizer_skipWhitespace(tokenizer);
+            skip->pending = false;
 
-    if(error != JSON_SUCCESS) {
-        if(error == JSON_ERROR_EOF) {
-            return JSON_TOKEN_EOF;
+            tokenizer->error = error;
+            return error;
         }
+    }
+}
 
-        tokenizer->error = error;
-        return JSON_TOKEN_ERROR;
+/*
+ * Skips over a number or literal by reading it as a token, so that it is checked in the same way as when it is read.
+ *
+ * Numbers and literals are short, so unlike strings and containers nothing is saved by only looking for their end.
+ */
+JsonError json_tokenizer_skipScalar(TokenizerHandle * tokenizer) {
+    switch(json_tokenizer_readEngineToken(tokenizer)) {
+        case JSON_TOKEN_ERROR:
+            return tokenizer->error;
+        case JSON_TOKEN_NEED_MORE:
+            return JSON_ERROR_NEED_MORE;
+        case JSON_TOKEN_EOF:
+            return JSON_ERROR_EOF;
+        default:
+            return JSON_SUCCESS;
     }
+}
 
-    error = json_buffer_ensureAvailable(buffer);
+/*
+ * Skips over the next complete value using the positions found by the structural index.
+ *
+ * Each string is a single position in the index, so only the brackets need to be counted.
+ */
+JsonError json_tokenizer_skipIndexedValue(TokenizerHandle * tokenizer) {
+    JsonBuffer * buffer = tokenizer->buffer;
+    StructuralIndex * structurals = tokenizer->structurals;
 
-    if(error != JSON_SUCCESS) {
-        tokenizer->error = error;
-        return JSON_TOKEN_ERROR;
+    if(structurals->next == structurals->count) {
+        buffer->index = buffer->read;
+        return JSON_ERROR_EOF;
     }
 
-    char c = json_buffer_get_consume(buffer);
+    size_t start = structurals->positions[structurals->next];
 
-    switch(c) {
-        case '{':
-            return JSON_TOKEN_OBJECT_START;
+    switch(buffer->buffer[start]) {
         case '}':
-            return JSON_TOKEN_OBJECT_END;
-        case '[':
-            return JSON_TOKEN_ARRAY_START;
         case ']':
-            return JSON_TOKEN_ARRAY_END;
         case ':':
-            return JSON_TOKEN_COLON;
         case ',':
-            return JSON_TOKEN_COMMA;
-        case '"':
-            error = json_tokenizer_readString(tokenizer);
+            buffer->index = start;
 
-            if(error != JSON_SUCCESS) {
-                tokenizer->error = error;
-                return JSON_TOKEN_ERROR;
+            tokenizer->error = JSON_ERROR_UNEXPECTED_TOKEN;
+            return JSON_ERROR_UNEXPECTED_TOKEN;
+        case '{':
+        case '[':
+            break;
+        case '"':
+            // The last string may run on to the end of the input without being closed, so it is read to find out.
+            if(structurals->next + 1 == structurals->count) {
+                return json_tokenizer_skipScalar(tokenizer);
             }
 
-            return JSON_TOKEN_TEXT;
-        case 't':
-            error = json_tokenizer_readExpected(tokenizer, "rue");
-
-            if(error != JSON_SUCCESS) {
-                if(error == JSON_ERROR_UNEXPECTED_CHAR) {
-                    error = JSON_ERROR_EXPECTED_TRUE;
-                }
-
-                tokenizer->error = error;
-                return JSON_TOKEN_ERROR;
-            }
+            // Any other string ends before the next token, with only whitespace in between.
+            structurals->next++;
+            buffer->index = (structurals->next == structurals->count ? buffer->read : structurals->positions[structurals->next]);
 
-            return JSON_TOKEN_TRUE;
-        case 'f':
-            error = json_tokenizer_readExpected(tokenizer, "alse");
+            return JSON_SUCCESS;
+        default:
+            return json_tokenizer_skipScalar(tokenizer);
+    }
 
-            if(error != JSON_SUCCESS) {
-                if(error == JSON_ERROR_UNEXPECTED_CHAR) {
-                    error = JSON_ERROR_EXPECTED_FALSE;
-                }
+    int depth = 0;
 
-                tokenizer->error = error;
-                return JSON_TOKEN_ERROR;
-            }
+    while(structurals->next < structurals->count) {
+        size_t position = structurals->positions[structurals->next++];
 
-            return JSON_TOKEN_FALSE;
-        case 'n':
-            error = json_tokenizer_readExpected(tokenizer, "ull");
+        char current = buffer->buffer[position];
 
-            if(error != JSON_SUCCESS) {
-                if(error == JSON_ERROR_UNEXPECTED_CHAR) {
-                    error = JSON_ERROR_EXPECTED_NULL;
-                }
+        if(current == '{' || current == '[') {
+            depth++;
+        } else if((current == '}' || current == ']') && --depth == 0) {
+            buffer->index = position + 1;
+            return JSON_SUCCESS;
+        }
+    }
 
-                tokenizer->error = error;
-                return JSON_TOKEN_ERROR;
-            }
+    buffer->index = buffer->read;
 
-            return JSON_TOKEN_NULL;
-        default:
-            if(c == '-' || json_char_isDigit(c)) {
-                // The first character matters when reading the number
-                json_buffer_unconsume(buffer);
+    tokenizer->error = JSON_ERROR_EOF;
+    return JSON_ERROR_EOF;
+}
 
-                TokenType token;
+/*
+ * Skips to the end of the innermost depth objects and arrays that the tokenizer is part way through,
+ * looking at the characters in the same way as json_tokenizer_skipValue.
+ */
+JsonError json_tokenizer_skipContainers(TokenizerHandle * tokenizer, int depth) {
+    JsonBuffer * buffer = tokenizer->buffer;
+    StructuralIndex * structurals = tokenizer->structurals;
 
-                error = json_tokenizer_readNumber(tokenizer, &token);
+    if(structurals != NULL) {
+        while(structurals->next < structurals->count) {
+            size_t position = structurals->positions[structurals->next++];
 
-                if(error) {
-                    tokenizer->error = error;
-                    return JSON_TOKEN_ERROR;
-                }
+            char current = buffer->buffer[position];
 
-                return token;
+            if(current == '{' || current == '[') {
+                depth++;
+            } else if((current == '}' || current == ']') && --depth == 0) {
+                buffer->index = position + 1;
+                return JSON_SUCCESS;
             }
+        }
 
-            tokenizer->error = JSON_ERROR_UNEXPECTED_CHAR;
-            return JSON_TOKEN_ERROR;
+        buffer->index = buffer->read;
+
+        tokenizer->error = JSON_ERROR_EOF;
+        return JSON_ERROR_EOF;
     }
+
+    // Carrying on a skip that is already inside of depth objects and arrays ends once they are all closed.
+    SkipState * skip = &tokenizer->skip;
+
+    skip->depth = depth;
+    skip->inString = false;
+    skip->escaped = false;
+    skip->pending = true;
+
+    return json_tokenizer_skipValue(tokenizer);
 }
 
 /*
  * Reads the next number in the buffer.
  *
+ * Integers that fit in a long int are resolved to JSON_TOKEN_NUMBER_INTEGER, and numbers with a decimal
+ * point or exponent are resolved to a correctly rounded double as JSON_TOKEN_NUMBER_DECIMAL. Numbers
+ * outside of those ranges are returned as JSON_TOKEN_NUMBER_BIG_INTEGER or JSON_TOKEN_NUMBER_BIG_DECIMAL.
+ *
  * Assumes that the first character of the number has not already been read.
  */
 JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * token) {
@@ -346,6 +1147,14 @@ JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * tok
 
     JsonBuffer * buffer = tokenizer->buffer;
 
+    size_t start = buffer->index;
+
+    bool negative = false;
+    NumberDigits digits = {0, 0, 0, 0, false};
+
+    // The power of ten to multiply the digits by.
+    int64_t exponent = 0;
+
     tokenizer->valueBufferIndex = 0;
 
     // Check for a negative sign.
@@ -358,7 +1167,12 @@ JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * tok
         if(json_buffer_get(buffer) == '-') {
             json_buffer_consume(buffer);
 
-            json_tokenizer_appendToValueBuffer(tokenizer, '-');
+            negative = true;
+
+            error = json_tokenizer_appendNumberCharacter(tokenizer, '-');
+
+            if(error != JSON_SUCCESS)
+                return error;
         }
     }
 
@@ -375,10 +1189,11 @@ JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * tok
 
             error = json_buffer_ensureAvailable(buffer);
 
-            if(error != JSON_SUCCESS)
+            if(error != JSON_ERROR_EOF && error != JSON_SUCCESS)
                 return error;
 
-            char next = json_buffer_get(buffer);
+            // A 0 at the end of the input is the whole number.
+            char next = (error == JSON_SUCCESS ? json_buffer_get(buffer) : '\0');
 
             // Move back again so the 0 does not remain consumed.
             json_buffer_unconsume(buffer);
@@ -391,10 +1206,12 @@ JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * tok
 
     // Read the integer part before the decimal point.
     {
-        error = json_tokenizer_readIntegerPart(tokenizer);
+        error = json_tokenizer_readIntegerPart(tokenizer, &digits);
 
         if(error != JSON_SUCCESS)
             return error;
+
+        exponent += digits.dropped;
     }
 
     // Look for a decimal point or exponent.
@@ -405,40 +1222,27 @@ JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * tok
             return error;
 
         if(error == JSON_ERROR_EOF) {
-            // Add the end for the number string.
-            error = json_tokenizer_appendToValueBuffer(tokenizer, '\0');
-
-            if(error != JSON_SUCCESS)
-                return error;
-
-            // TODO: Resolve the value of the integer.
-
-            *token = JSON_TOKEN_NUMBER_BIG_INTEGER;
-            return JSON_SUCCESS;
+            return json_tokenizer_finishInteger(tokenizer, start, &digits, negative, token);
         }
 
         char current = json_buffer_get_consume(buffer);
 
         if(current == 'e' || current == 'E') {
+            error = json_tokenizer_appendNumberCharacter(tokenizer, current);
+
+            if(error != JSON_SUCCESS)
+                return error;
+
             goto readExponent;
         }
 
         if(current != '.') {
             json_buffer_unconsume(buffer);
 
-            // Add the end for the number string.
-            error = json_tokenizer_appendToValueBuffer(tokenizer, '\0');
-
-            if(error != JSON_SUCCESS)
-                return error;
-
-            // TODO: Resolve the value of the integer.
-
-            *token = JSON_TOKEN_NUMBER_BIG_INTEGER;
-            return JSON_SUCCESS;
+            return json_tokenizer_finishInteger(tokenizer, start, &digits, negative, token);
         }
 
-        error = json_tokenizer_appendToValueBuffer(tokenizer, '.');
+        error = json_tokenizer_appendNumberCharacter(tokenizer, '.');
 
         if(error != JSON_SUCCESS)
             return error;
@@ -446,10 +1250,16 @@ JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * tok
 
     // Read the digits after the decimal point.
     {
-        error = json_tokenizer_readIntegerPart(tokenizer);
+        int countBefore = digits.count;
+        int droppedBefore = digits.dropped;
+
+        error = json_tokenizer_readIntegerPart(tokenizer, &digits);
 
         if(error != JSON_SUCCESS)
             return error;
+
+        // Each digit kept after the decimal point divides the digits by ten.
+        exponent -= (digits.count - countBefore) - (digits.dropped - droppedBefore);
     }
 
     // Look for an exponent.
@@ -459,31 +1269,21 @@ JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * tok
         if(error != JSON_ERROR_EOF && error != JSON_SUCCESS)
             return error;
 
-        char nextCharacter = json_buffer_get(buffer);
-
-        if(error == JSON_ERROR_EOF || (nextCharacter != 'e' && nextCharacter != 'E')) {
-            // Add the end for the number string.
-            error = json_tokenizer_appendToValueBuffer(tokenizer, '\0');
-
-            if(error != JSON_SUCCESS)
-                return error;
-
-            // TODO: Resolve the value of the decimal number.
-
-            *token = JSON_TOKEN_NUMBER_BIG_DECIMAL;
-            return JSON_SUCCESS;
+        if(error == JSON_ERROR_EOF || (json_buffer_get(buffer) != 'e' && json_buffer_get(buffer) != 'E')) {
+            return json_tokenizer_finishDecimal(tokenizer, start, &digits, exponent, negative, token);
         }
 
-        json_buffer_consume(buffer);
-
-        error = json_tokenizer_appendToValueBuffer(tokenizer, 'e');
+        error = json_tokenizer_appendNumberCharacter(tokenizer, json_buffer_get_consume(buffer));
 
         if(error != JSON_SUCCESS)
             return error;
     }
 
     // Look for the sign of the exponent.
-    readExponent:
+    readExponent:;
+
+    bool exponentNegative = false;
+
     {
         error = json_buffer_ensureAvailable(buffer);
 
@@ -499,7 +1299,9 @@ JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * tok
 
             json_buffer_consume(buffer);
 
-            error = json_tokenizer_appendToValueBuffer(tokenizer, nextCharacter);
+            exponentNegative = (nextCharacter == '-');
+
+            error = json_tokenizer_appendNumberCharacter(tokenizer, nextCharacter);
 
             if(error != JSON_SUCCESS)
                 return error;
@@ -508,21 +1310,77 @@ JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * tok
 
     // Read the digits of the exponent.
     {
-        error = json_tokenizer_readIntegerPart(tokenizer);
+        NumberDigits exponentDigits = {0, 0, 0, 0, false};
+
+        error = json_tokenizer_readIntegerPart(tokenizer, &exponentDigits);
 
         if(error != JSON_SUCCESS)
             return error;
+
+        // Any exponent this large overflows or underflows, so limiting it just keeps the sum in range.
+        int64_t explicitExponent = (exponentDigits.significant > 9 ? 1000000000 : (int64_t) exponentDigits.value);
+
+        exponent += (exponentNegative ? -explicitExponent : explicitExponent);
+    }
+
+    return json_tokenizer_finishDecimal(tokenizer, start, &digits, exponent, negative, token);
+}
+
+/*
+ * Sets the value of an integer that has just been read, which started at start in the buffer.
+ *
+ * Integers that do not fit in a long int are left as JSON_TOKEN_NUMBER_BIG_INTEGER.
+ */
+JsonError json_tokenizer_finishInteger(TokenizerHandle * tokenizer, size_t start, NumberDigits * digits, bool negative, TokenType * token) {
+    JsonError error = json_tokenizer_finishNumber(tokenizer, start);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    uint64_t limit = (negative ? (uint64_t) LONG_MAX + 1 : (uint64_t) LONG_MAX);
+
+    if(digits->dropped > 0 || digits->value > limit) {
+        *token = JSON_TOKEN_NUMBER_BIG_INTEGER;
+        return JSON_SUCCESS;
+    }
+
+    if(negative) {
+        // Negated in two steps so that LONG_MIN does not overflow.
+        tokenizer->integerValue = (digits->value == 0 ? 0 : -(long int) (digits->value - 1) - 1);
+    } else {
+        tokenizer->integerValue = (long int) digits->value;
     }
 
-    // Add the end for the number string.
-    error = json_tokenizer_appendToValueBuffer(tokenizer, '\0');
+    *token = JSON_TOKEN_NUMBER_INTEGER;
+    return JSON_SUCCESS;
+}
+
+/*
+ * Sets the value of a decimal number that has just been read, which started at start in the buffer.
+ *
+ * Falls back to strtod in the rare cases where the digits and exponent are not enough to find the closest double.
+ * Numbers too large to be represented as a double are left as JSON_TOKEN_NUMBER_BIG_DECIMAL.
+ */
+JsonError json_tokenizer_finishDecimal(TokenizerHandle * tokenizer, size_t start, NumberDigits * digits, int64_t exponent, bool negative, TokenType * token) {
+    JsonError error = json_tokenizer_finishNumber(tokenizer, start);
 
     if(error != JSON_SUCCESS)
         return error;
 
-    // TODO: Resolve the value of the decimal number.
+    double value;
+
+    if(!json_number_toDouble(digits->value, exponent, negative, digits->droppedNonZero, &value)) {
+        char * text = json_tokenizer_terminateValue(tokenizer);
+
+        if(text == NULL)
+            return tokenizer->error;
+
+        value = strtod(text, NULL);
+    }
+
+    tokenizer->decimalValue = value;
 
-    *token = JSON_TOKEN_NUMBER_BIG_DECIMAL;
+    *token = (isinf(value) ? JSON_TOKEN_NUMBER_BIG_DECIMAL : JSON_TOKEN_NUMBER_DECIMAL);
     return JSON_SUCCESS;
 }
 
@@ -531,14 +1389,15 @@ JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * tok
  *
  * If no digits are found JSON_ERROR_EXPECTED_DIGIT will be returned.
  *
- * Places the number in the value buffer of the tokenizer at the index in valueBufferIndex.
+ * Adds the digits to digits, and places them in the value buffer of the tokenizer at the index
+ * in valueBufferIndex unless the number is being sliced from a contiguous buffer.
  */
-JsonError json_tokenizer_readIntegerPart(TokenizerHandle * tokenizer) {
+JsonError json_tokenizer_readIntegerPart(TokenizerHandle * tokenizer, NumberDigits * digits) {
     JsonError error;
 
     JsonBuffer * buffer = tokenizer->buffer;
 
-    int originalValueBufferIndex = tokenizer->valueBufferIndex;
+    int originalCount = digits->count;
 
     while(true) {
         while(buffer->index < buffer->read) {
@@ -548,14 +1407,16 @@ JsonError json_tokenizer_readIntegerPart(TokenizerHandle * tokenizer) {
                 json_buffer_unconsume(buffer);
 
                 // If no digits were found.
-                if(originalValueBufferIndex == tokenizer->valueBufferIndex) {
+                if(originalCount == digits->count) {
                     return JSON_ERROR_EXPECTED_DIGIT;
                 }
 
                 return JSON_SUCCESS;
             }
 
-            error = json_tokenizer_appendToValueBuffer(tokenizer, current);
+            json_number_addDigit(digits, current - '0');
+
+            error = json_tokenizer_appendNumberCharacter(tokenizer, current);
 
             if(error != JSON_SUCCESS)
                 return error;
@@ -563,8 +1424,13 @@ JsonError json_tokenizer_readIntegerPart(TokenizerHandle * tokenizer) {
 
         error = json_buffer_fill(buffer);
 
-        if(error != JSON_SUCCESS)
+        if(error != JSON_SUCCESS) {
+            // The end of the input also ends the digits.
+            if(error == JSON_ERROR_EOF && originalCount != digits->count)
+                return JSON_SUCCESS;
+
             return error;
+        }
     }
 }
 
@@ -576,34 +1442,81 @@ JsonError json_tokenizer_readIntegerPart(TokenizerHandle * tokenizer) {
  * Will consume the closing quotation mark (").
  */
 JsonError json_tokenizer_readString(TokenizerHandle * tokenizer) {
-    JsonError error;
-
     JsonBuffer * buffer = tokenizer->buffer;
 
     tokenizer->valueBufferIndex = 0;
 
+    // Strings without escapes in contiguous buffers are sliced from the buffer instead of being copied.
+    if(json_buffer_isContiguous(buffer)) {
+        size_t start = buffer->index;
+        size_t end = start + json_simd_findStringSpecial(&buffer->buffer[start], buffer->read - start);
+
+        if(end < buffer->read && buffer->buffer[end] == '"') {
+            buffer->index = end + 1;
+
+            json_tokenizer_sliceValue(tokenizer, start, end);
+            return JSON_SUCCESS;
+        }
+    }
+
+    return json_tokenizer_continueString(tokenizer);
+}
+
+/*
+ * Reads the rest of a string into the value buffer, after the characters already in the value buffer.
+ *
+ * If the input runs out JSON_ERROR_NEED_MORE is returned with the buffer index after the last complete
+ * character or escape sequence, so that reading can continue from there once more input is pushed.
+ */
+JsonError json_tokenizer_continueString(TokenizerHandle * tokenizer) {
+    JsonError error;
+
+    JsonBuffer * buffer = tokenizer->buffer;
+
     while(true) {
         while(buffer->index < buffer->read) {
-            char current = json_buffer_get_consume(buffer);
+            size_t available = buffer->read - buffer->index;
+            size_t run = json_simd_findStringSpecial(&buffer->buffer[buffer->index], available);
+
+            // Copy all the characters up to the next special character at once.
+            if(run > 0) {
+                error = json_tokenizer_reserveValueBuffer(tokenizer, run + 1);
+
+                if(error != JSON_SUCCESS)
+                    return error;
+
+                memcpy(&tokenizer->valueBuffer[tokenizer->valueBufferIndex], &buffer->buffer[buffer->index], run);
 
-            if(json_char_isControlCharacter(current)) {
-                return JSON_ERROR_ILLEGAL_TEXT_CHAR;
+                tokenizer->valueBufferIndex += run;
+                buffer->index += run;
+
+                if(run == available)
+                    break;
             }
 
+            size_t escapeStart = buffer->index;
+
+            char current = json_buffer_get_consume(buffer);
+
             switch(current) {
                 case '\\':
                     error = json_tokenizer_readEscaped(tokenizer);
 
-                    if(error != JSON_SUCCESS)
+                    if(error != JSON_SUCCESS) {
+                        // Escape sequences are read again from the backslash once more input is pushed.
+                        if(error == JSON_ERROR_NEED_MORE) {
+                            buffer->index = escapeStart;
+                        }
+
                         return error;
+                    }
 
+                    json_stats_add(tokenizer->stats.escapes, 1);
                     break;
                 case '"':
-                    json_tokenizer_appendToValueBuffer(tokenizer, '\0');
-                    return JSON_SUCCESS;
+                    return json_tokenizer_finishValueBuffer(tokenizer);
                 default:
-                    json_tokenizer_appendToValueBuffer(tokenizer, current);
-                    break;
+                    return JSON_ERROR_ILLEGAL_TEXT_CHAR;
             }
         }
 
@@ -635,23 +1548,17 @@ JsonError json_tokenizer_readEscaped(TokenizerHandle * tokenizer) {
         case '"':
         case '\\':
         case '/':
-            json_tokenizer_appendToValueBuffer(tokenizer, current);
-            return JSON_SUCCESS;
+            return json_tokenizer_appendToValueBuffer(tokenizer, current);
         case 'b':
-            json_tokenizer_appendToValueBuffer(tokenizer, '\b');
-            return JSON_SUCCESS;
+            return json_tokenizer_appendToValueBuffer(tokenizer, '\b');
         case 'f':
-            json_tokenizer_appendToValueBuffer(tokenizer, '\f');
-            return JSON_SUCCESS;
+            return json_tokenizer_appendToValueBuffer(tokenizer, '\f');
         case 'n':
-            json_tokenizer_appendToValueBuffer(tokenizer, '\n');
-            return JSON_SUCCESS;
+            return json_tokenizer_appendToValueBuffer(tokenizer, '\n');
         case 'r':
-            json_tokenizer_appendToValueBuffer(tokenizer, '\r');
-            return JSON_SUCCESS;
+            return json_tokenizer_appendToValueBuffer(tokenizer, '\r');
         case 't':
-            json_tokenizer_appendToValueBuffer(tokenizer, '\t');
-            return JSON_SUCCESS;
+            return json_tokenizer_appendToValueBuffer(tokenizer, '\t');
         case 'u':
             return json_tokenizer_readCodePoint(tokenizer);
         default:
@@ -660,16 +1567,14 @@ JsonError json_tokenizer_readEscaped(TokenizerHandle * tokenizer) {
 }
 
 /*
- * Reads a UCS codepoint as UTF-8.
- *
- * Assumes the escape symbol (\u) has already been read.
+ * Reads the four hexadecimal digits of an escaped codepoint.
  */
-JsonError json_tokenizer_readCodePoint(TokenizerHandle * tokenizer) {
+JsonError json_tokenizer_readHexDigits(TokenizerHandle * tokenizer, int * codepoint) {
     JsonError error;
 
     JsonBuffer * buffer = tokenizer->buffer;
 
-    int codepoint = 0;
+    *codepoint = 0;
 
     for(int i=0; i < 4; i++) {
         error = json_buffer_ensureAvailable(buffer);
@@ -677,21 +1582,30 @@ JsonError json_tokenizer_readCodePoint(TokenizerHandle * tokenizer) {
         if(error != JSON_SUCCESS)
             return error;
 
-        codepoint = codepoint << 4;
+        *codepoint = *codepoint << 4;
 
         char current = json_buffer_get_consume(buffer);
 
         if(current >= '0' && current <= '9') {
-            codepoint += current - '0';
+            *codepoint += current - '0';
         } else if(current >= 'a' && current <= 'f') {
-            codepoint += current - 'a' + 10;
+            *codepoint += current - 'a' + 10;
         } else if(current >= 'A' && current <= 'F') {
-            codepoint += current - 'A' + 10;
+            *codepoint += current - 'A' + 10;
         } else {
             return JSON_ERROR_INVALID_UNICODE_ESCAPED_CHAR;
         }
     }
 
+    return JSON_SUCCESS;
+}
+
+/*
+ * Appends a UCS codepoint to the value buffer as UTF-8.
+ */
+JsonError json_tokenizer_appendCodePoint(TokenizerHandle * tokenizer, int codepoint) {
+    JsonError error;
+
     // Ensure there are at least 6 bytes available in the value buffer.
     while(tokenizer->valueBufferIndex >= tokenizer->valueBufferSize - 6) {
         error = json_tokenizer_expandValueBuffer(tokenizer);
@@ -711,6 +1625,72 @@ JsonError json_tokenizer_readCodePoint(TokenizerHandle * tokenizer) {
     return JSON_SUCCESS;
 }
 
+/*
+ * Reads a UCS codepoint as UTF-8.
+ *
+ * Assumes the escape symbol (\u) has already been read. Codepoints above U+FFFF are escaped as a high
+ * surrogate followed by a low surrogate, which are combined into the codepoint they encode. Surrogates
+ * that are not part of a pair are kept as they are.
+ */
+JsonError json_tokenizer_readCodePoint(TokenizerHandle * tokenizer) {
+    JsonError error;
+
+    JsonBuffer * buffer = tokenizer->buffer;
+
+    int codepoint;
+
+    // The escape is read again from the start if the pushed input runs out, so nothing it appended may be kept.
+    size_t valueStart = tokenizer->valueBufferIndex;
+
+    error = json_tokenizer_readHexDigits(tokenizer, &codepoint);
+
+    while(error == JSON_SUCCESS && codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+        error = json_buffer_ensureAvailable(buffer);
+
+        if(error != JSON_SUCCESS || json_buffer_get(buffer) != '\\')
+            break;
+
+        json_buffer_consume(buffer);
+
+        error = json_buffer_ensureAvailable(buffer);
+
+        if(error != JSON_SUCCESS)
+            break;
+
+        if(json_buffer_get(buffer) != 'u') {
+            json_buffer_unconsume(buffer);
+            break;
+        }
+
+        json_buffer_consume(buffer);
+
+        int low;
+        error = json_tokenizer_readHexDigits(tokenizer, &low);
+
+        if(error != JSON_SUCCESS)
+            break;
+
+        if(low >= 0xDC00 && low <= 0xDFFF) {
+            codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+            break;
+        }
+
+        error = json_tokenizer_appendCodePoint(tokenizer, codepoint);
+
+        codepoint = low;
+    }
+
+    if(error == JSON_SUCCESS) {
+        return json_tokenizer_appendCodePoint(tokenizer, codepoint);
+    }
+
+    if(error == JSON_ERROR_NEED_MORE) {
+        tokenizer->valueBufferIndex = valueStart;
+    }
+
+    return error;
+}
+
 /*
  * Ensures the next characters in the buffer match the characters in expected.
  */
@@ -3,20 +3,66 @@
 #include "json.h"
 #endif
 
+#include "numbers_internal.h"
+
 JsonError json_tokenizer_expandValueBuffer(TokenizerHandle * tokenizer);
 
+JsonError json_tokenizer_reserveValueBuffer(TokenizerHandle * tokenizer, size_t count);
+
 JsonError json_tokenizer_appendToValueBuffer(TokenizerHandle * tokenizer, char character);
 
+char * json_tokenizer_terminateValue(TokenizerHandle * tokenizer);
+
+JsonError json_tokenizer_finishValueBuffer(TokenizerHandle * tokenizer);
+
+void json_tokenizer_sliceValue(TokenizerHandle * tokenizer, size_t start, size_t end);
+
+JsonError json_tokenizer_appendNumberCharacter(TokenizerHandle * tokenizer, char character);
+
+JsonError json_tokenizer_finishNumber(TokenizerHandle * tokenizer, size_t start);
+
 JsonError json_tokenizer_skipWhitespace(TokenizerHandle * tokenizer);
 
+void json_tokenizer_startInput(TokenizerHandle * tokenizer);
+
+void json_tokenizer_setPooled(TokenizerHandle * tokenizer, bool pooled);
+
+bool json_tokenizer_isPooled(TokenizerHandle * tokenizer);
+
+TokenType json_tokenizer_readEngineToken(TokenizerHandle * tokenizer);
+
+TokenType json_tokenizer_readToken(TokenizerHandle * tokenizer);
+
+TokenType json_tokenizer_readIndexedToken(TokenizerHandle * tokenizer);
+
+JsonError json_tokenizer_skipScalar(TokenizerHandle * tokenizer);
+
+JsonError json_tokenizer_skipIndexedValue(TokenizerHandle * tokenizer);
+
+JsonError json_tokenizer_skipContainers(TokenizerHandle * tokenizer, int depth);
+
+TokenType json_tokenizer_tokenError(TokenizerHandle * tokenizer, JsonError error, size_t start);
+
+TokenType json_tokenizer_readStringToken(TokenizerHandle * tokenizer, bool resume);
+
 JsonError json_tokenizer_readNumber(TokenizerHandle * tokenizer, TokenType * token);
 
-JsonError json_tokenizer_readIntegerPart(TokenizerHandle * tokenizer);
+JsonError json_tokenizer_finishInteger(TokenizerHandle * tokenizer, size_t start, NumberDigits * digits, bool negative, TokenType * token);
+
+JsonError json_tokenizer_finishDecimal(TokenizerHandle * tokenizer, size_t start, NumberDigits * digits, int64_t exponent, bool negative, TokenType * token);
+
+JsonError json_tokenizer_readIntegerPart(TokenizerHandle * tokenizer, NumberDigits * digits);
 
 JsonError json_tokenizer_readString(TokenizerHandle * tokenizer);
 
+JsonError json_tokenizer_continueString(TokenizerHandle * tokenizer);
+
 JsonError json_tokenizer_readEscaped(TokenizerHandle * tokenizer);
 
+JsonError json_tokenizer_readHexDigits(TokenizerHandle * tokenizer, int * codepoint);
+
+JsonError json_tokenizer_appendCodePoint(TokenizerHandle * tokenizer, int codepoint);
+
 JsonError json_tokenizer_readCodePoint(TokenizerHandle * tokenizer);
 
 JsonError json_tokenizer_readExpected(TokenizerHandle * tokenizer, char * expected);
\ No newline at end of file
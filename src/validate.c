@@ -0,0 +1,620 @@
+#include "buffer_internal.h"
+#include "writer_internal.h"
+#include "simd_internal.h"
+
+/*
+ * The deepest objects and arrays can be nested, as the stack of them is kept on the C stack.
+ */
+#define JSON_VALIDATE_MAX_DEPTH JSON_SAX_DEFAULT_MAX_DEPTH
+
+typedef struct Validator Validator;
+
+/*
+ * Tracks the position in the input while the buffer is refilled, and the characters of the token
+ * being read that have not been copied to the output yet.
+ */
+struct Validator {
+    JsonBuffer * buffer;
+
+    // The offset in the whole input of the first character validated, which positions are counted from.
+    int64_t start;
+
+    size_t errorOffset;
+
+    // Where the tokens read are copied to, or NULL if they are only checked.
+    JsonWriter * output;
+
+    // Whether the characters being read are part of a token being copied, starting from copyFrom in the buffer.
+    bool copying;
+    size_t copyFrom;
+};
+
+/*
+ * The offset in the input of the character at the buffer index.
+ */
+#define json_validator_position(validator) ((size_t) (json_buffer_getOffset((validator)->buffer) - (validator)->start))
+
+/*
+ * Ensure there is at least one character in the buffer, reading if necessary.
+ *
+ * Resolves to a JsonError.
+ */
+#define json_validator_ensureAvailable(validator) \
+    ((validator)->buffer->index < (validator)->buffer->read ? JSON_SUCCESS : json_validator_fill(validator))
+
+/*
+ * Records that the input is invalid at offset, returning the error.
+ */
+static JsonError json_validator_fail(Validator * validator, JsonError error, size_t offset) {
+    validator->errorOffset = offset;
+
+    return error;
+}
+
+/*
+ * Copies the characters of the token being read up to the buffer index to the output.
+ */
+static JsonError json_validator_copy(Validator * validator) {
+    JsonBuffer * buffer = validator->buffer;
+
+    JsonError error = json_writer_append(validator->output, &buffer->buffer[validator->copyFrom], buffer->index - validator->copyFrom);
+
+    validator->copyFrom = buffer->index;
+
+    return error;
+}
+
+/*
+ * Fills the buffer.
+ *
+ * The characters of the token being copied are copied first, as filling the buffer replaces them.
+ */
+static JsonError json_validator_fill(Validator * validator) {
+    JsonBuffer * buffer = validator->buffer;
+
+    if(validator->copying) {
+        JsonError error = json_validator_copy(validator);
+
+        if(error != JSON_SUCCESS)
+            return error;
+    }
+
+    JsonError error = json_buffer_fill(buffer);
+
+    validator->copyFrom = buffer->index;
+
+    return error;
+}
+
+/*
+ * Skips over whitespace, returning JSON_ERROR_EOF if the input ends first.
+ */
+static JsonError json_validator_skipWhitespace(Validator * validator) {
+    JsonBuffer * buffer = validator->buffer;
+
+    while(true) {
+        if(buffer->index < buffer->read) {
+            if(!json_char_isWhitespace(json_buffer_get(buffer))) {
+                return JSON_SUCCESS;
+            }
+
+            buffer->index += json_simd_countWhitespace(&buffer->buffer[buffer->index], buffer->read - buffer->index);
+
+            if(buffer->index < buffer->read) {
+                return JSON_SUCCESS;
+            }
+        }
+
+        JsonError error = json_validator_fill(validator);
+
+        if(error != JSON_SUCCESS)
+            return error;
+    }
+}
+
+/*
+ * Checks that the next characters match expected, failing with error if they do not.
+ */
+static JsonError json_validator_readExpected(Validator * validator, const char * expected, JsonError error) {
+    JsonBuffer * buffer = validator->buffer;
+
+    for(int index = 0; expected[index] != '\0'; index++) {
+        JsonError fillError = json_validator_ensureAvailable(validator);
+
+        if(fillError != JSON_SUCCESS)
+            return json_validator_fail(validator, fillError, json_validator_position(validator));
+
+        if(json_buffer_get(buffer) != expected[index])
+            return json_validator_fail(validator, error, json_validator_position(validator));
+
+        json_buffer_consume(buffer);
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Skips over one or more digits, failing with error if there are none.
+ */
+static JsonError json_validator_readDigits(Validator * validator, JsonError error) {
+    JsonBuffer * buffer = validator->buffer;
+
+    bool found = false;
+
+    while(true) {
+        while(buffer->index < buffer->read) {
+            if(!json_char_isDigit(json_buffer_get(buffer))) {
+                return (found ? JSON_SUCCESS : json_validator_fail(validator, error, json_validator_position(validator)));
+            }
+
+            json_buffer_consume(buffer);
+            found = true;
+        }
+
+        JsonError fillError = json_validator_fill(validator);
+
+        if(fillError != JSON_SUCCESS) {
+            // The end of the input also ends the digits.
+            if(fillError == JSON_ERROR_EOF && found)
+                return JSON_SUCCESS;
+
+            return json_validator_fail(validator, fillError, json_validator_position(validator));
+        }
+    }
+}
+
+/*
+ * Gets the next character without consuming it, or '\0' if the input has ended.
+ */
+static JsonError json_validator_peek(Validator * validator, char * next) {
+    JsonError error = json_validator_ensureAvailable(validator);
+
+    if(error == JSON_ERROR_EOF) {
+        *next = '\0';
+        return JSON_SUCCESS;
+    }
+
+    if(error != JSON_SUCCESS)
+        return json_validator_fail(validator, error, json_validator_position(validator));
+
+    *next = json_buffer_get(validator->buffer);
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Checks the syntax of a number, without working out its value.
+ *
+ * Assumes that the first character of the number has not already been read.
+ */
+static JsonError json_validator_readNumber(Validator * validator) {
+    JsonError error;
+
+    JsonBuffer * buffer = validator->buffer;
+
+    char next;
+
+    if(json_buffer_get(buffer) == '-') {
+        json_buffer_consume(buffer);
+    }
+
+    error = json_validator_peek(validator, &next);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    if(next == '0') {
+        json_buffer_consume(buffer);
+
+        error = json_validator_peek(validator, &next);
+
+        if(error != JSON_SUCCESS)
+            return error;
+
+        if(json_char_isDigit(next))
+            return json_validator_fail(validator, JSON_ERROR_UNNECESSARY_ZERO, json_validator_position(validator));
+    } else {
+        error = json_validator_readDigits(validator, JSON_ERROR_EXPECTED_DIGIT);
+
+        if(error != JSON_SUCCESS)
+            return error;
+    }
+
+    error = json_validator_peek(validator, &next);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    if(next == '.') {
+        json_buffer_consume(buffer);
+
+        error = json_validator_readDigits(validator, JSON_ERROR_EXPECTED_DIGIT);
+
+        if(error != JSON_SUCCESS)
+            return error;
+
+        error = json_validator_peek(validator, &next);
+
+        if(error != JSON_SUCCESS)
+            return error;
+    }
+
+    if(next != 'e' && next != 'E')
+        return JSON_SUCCESS;
+
+    json_buffer_consume(buffer);
+
+    error = json_validator_peek(validator, &next);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    if(next == '+' || next == '-') {
+        json_buffer_consume(buffer);
+
+        return json_validator_readDigits(validator, JSON_ERROR_EXPECTED_DIGIT);
+    }
+
+    return json_validator_readDigits(validator, JSON_ERROR_EXPECTED_DIGIT_OR_SIGN);
+}
+
+/*
+ * Checks that the multibyte UTF-8 sequence starting at the buffer index is a valid encoding of a
+ * single codepoint, rejecting overlong encodings, surrogates and codepoints above U+10FFFF.
+ */
+static JsonError json_validator_readMultibyte(Validator * validator) {
+    JsonBuffer * buffer = validator->buffer;
+
+    size_t start = json_validator_position(validator);
+
+    unsigned char lead = (unsigned char) json_buffer_get_consume(buffer);
+
+    int continuations;
+
+    // The range of the first continuation byte, which is narrower for some leading bytes.
+    unsigned char lower = 0x80;
+    unsigned char upper = 0xBF;
+
+    if(lead >= 0xC2 && lead <= 0xDF) {
+        continuations = 1;
+    } else if(lead >= 0xE0 && lead <= 0xEF) {
+        continuations = 2;
+
+        if(lead == 0xE0) {
+            lower = 0xA0;
+        } else if(lead == 0xED) {
+            upper = 0x9F;
+        }
+    } else if(lead >= 0xF0 && lead <= 0xF4) {
+        continuations = 3;
+
+        if(lead == 0xF0) {
+            lower = 0x90;
+        } else if(lead == 0xF4) {
+            upper = 0x8F;
+        }
+    } else {
+        return json_validator_fail(validator, JSON_ERROR_INVALID_UTF8, start);
+    }
+
+    while(continuations-- > 0) {
+        JsonError error = json_validator_ensureAvailable(validator);
+
+        if(error != JSON_SUCCESS)
+            return json_validator_fail(validator, error, json_validator_position(validator));
+
+        unsigned char current = (unsigned char) json_buffer_get_consume(buffer);
+
+        if(current < lower || current > upper)
+            return json_validator_fail(validator, JSON_ERROR_INVALID_UTF8, start);
+
+        lower = 0x80;
+        upper = 0xBF;
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Checks an escape sequence, assuming the backslash (\) has already been read.
+ */
+static JsonError json_validator_readEscaped(Validator * validator) {
+    JsonBuffer * buffer = validator->buffer;
+
+    JsonError error = json_validator_ensureAvailable(validator);
+
+    if(error != JSON_SUCCESS)
+        return json_validator_fail(validator, error, json_validator_position(validator));
+
+    switch(json_buffer_get(buffer)) {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+            json_buffer_consume(buffer);
+            return JSON_SUCCESS;
+        case 'u':
+            json_buffer_consume(buffer);
+            break;
+        default:
+            return json_validator_fail(validator, JSON_ERROR_INVALID_ESCAPE, json_validator_position(validator));
+    }
+
+    for(int index = 0; index < 4; index++) {
+        error = json_validator_ensureAvailable(validator);
+
+        if(error != JSON_SUCCESS)
+            return json_validator_fail(validator, error, json_validator_position(validator));
+
+        char current = json_buffer_get(buffer);
+
+        if(!json_char_isDigit(current) && !(current >= 'a' && current <= 'f') && !(current >= 'A' && current <= 'F'))
+            return json_validator_fail(validator, JSON_ERROR_INVALID_UNICODE_ESCAPED_CHAR, json_validator_position(validator));
+
+        json_buffer_consume(buffer);
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Checks a string, assuming the opening quotation mark (") has already been read.
+ *
+ * Runs of plain ASCII characters are skipped at once, so only escapes and multibyte sequences are looked at one at a time.
+ */
+static JsonError json_validator_readString(Validator * validator) {
+    JsonError error;
+
+    JsonBuffer * buffer = validator->buffer;
+
+    while(true) {
+        while(buffer->index < buffer->read) {
+            buffer->index += json_simd_findStringSpecialOrMultibyte(&buffer->buffer[buffer->index], buffer->read - buffer->index);
+
+            if(buffer->index == buffer->read)
+                break;
+
+            char current = json_buffer_get(buffer);
+
+            if(current == '"') {
+                json_buffer_consume(buffer);
+                return JSON_SUCCESS;
+            }
+
+            if(current == '\\') {
+                json_buffer_consume(buffer);
+                error = json_validator_readEscaped(validator);
+            } else if(json_char_isControlCharacter(current)) {
+                error = json_validator_fail(validator, JSON_ERROR_ILLEGAL_TEXT_CHAR, json_validator_position(validator));
+            } else {
+                error = json_validator_readMultibyte(validator);
+            }
+
+            if(error != JSON_SUCCESS)
+                return error;
+        }
+
+        error = json_validator_fill(validator);
+
+        if(error != JSON_SUCCESS)
+            return json_validator_fail(validator, error, json_validator_position(validator));
+    }
+}
+
+/*
+ * Gets the type of token that starts with the character, where all numbers are JSON_TOKEN_NUMBER_INTEGER as the grammar
+ * does not tell them apart, and JSON_TOKEN_ERROR is returned for characters that cannot start a token.
+ */
+static TokenType json_validator_getTokenType(char c) {
+    switch(c) {
+        case '{':
+            return JSON_TOKEN_OBJECT_START;
+        case '}':
+            return JSON_TOKEN_OBJECT_END;
+        case '[':
+            return JSON_TOKEN_ARRAY_START;
+        case ']':
+            return JSON_TOKEN_ARRAY_END;
+        case ':':
+            return JSON_TOKEN_COLON;
+        case ',':
+            return JSON_TOKEN_COMMA;
+        case '"':
+            return JSON_TOKEN_TEXT;
+        case 't':
+            return JSON_TOKEN_TRUE;
+        case 'f':
+            return JSON_TOKEN_FALSE;
+        case 'n':
+            return JSON_TOKEN_NULL;
+        default:
+            return (c == '-' || json_char_isDigit(c) ? JSON_TOKEN_NUMBER_INTEGER : JSON_TOKEN_ERROR);
+    }
+}
+
+/*
+ * Checks the token of the type passed starting at the buffer index.
+ */
+static JsonError json_validator_readToken(Validator * validator, TokenType token) {
+    JsonBuffer * buffer = validator->buffer;
+
+    switch(token) {
+        case JSON_TOKEN_OBJECT_START:
+        case JSON_TOKEN_OBJECT_END:
+        case JSON_TOKEN_ARRAY_START:
+        case JSON_TOKEN_ARRAY_END:
+        case JSON_TOKEN_COLON:
+        case JSON_TOKEN_COMMA:
+            json_buffer_consume(buffer);
+            return JSON_SUCCESS;
+        case JSON_TOKEN_TEXT:
+            json_buffer_consume(buffer);
+            return json_validator_readString(validator);
+        case JSON_TOKEN_TRUE:
+            json_buffer_consume(buffer);
+            return json_validator_readExpected(validator, "rue", JSON_ERROR_EXPECTED_TRUE);
+        case JSON_TOKEN_FALSE:
+            json_buffer_consume(buffer);
+            return json_validator_readExpected(validator, "alse", JSON_ERROR_EXPECTED_FALSE);
+        case JSON_TOKEN_NULL:
+            json_buffer_consume(buffer);
+            return json_validator_readExpected(validator, "ull", JSON_ERROR_EXPECTED_NULL);
+        case JSON_TOKEN_NUMBER_INTEGER:
+            return json_validator_readNumber(validator);
+        default:
+            return json_validator_fail(validator, JSON_ERROR_UNEXPECTED_CHAR, json_validator_position(validator));
+    }
+}
+
+/*
+ * Checks that the rest of the input in the buffer is a single JSON value, copying each token to the output
+ * unless it is NULL.
+ */
+static JsonError json_validator_run(JsonBuffer * buffer, JsonWriter * output, size_t * errorOffset) {
+    // Offsets are counted from the buffer index rather than the start of the whole input.
+    Validator validator = {buffer, json_buffer_getOffset(buffer), 0, output, false, 0};
+
+    // The state to return to after a value at each depth, where the top level is depth 0.
+    unsigned char stack[JSON_VALIDATE_MAX_DEPTH + 1];
+    int depth = 0;
+
+    stack[0] = JSON_SAX_DONE;
+
+    SaxState state = JSON_SAX_EXPECT_VALUE;
+
+    JsonError error;
+
+    while(true) {
+        error = json_validator_skipWhitespace(&validator);
+
+        if(error != JSON_SUCCESS) {
+            if(error == JSON_ERROR_EOF && state == JSON_SAX_DONE) {
+                error = JSON_SUCCESS;
+            }
+
+            validator.errorOffset = json_validator_position(&validator);
+            break;
+        }
+
+        size_t start = json_validator_position(&validator);
+
+        TokenType token = json_validator_getTokenType(buffer->buffer[buffer->index]);
+
+        SaxAction action = (token == JSON_TOKEN_ERROR ? JSON_SAX_REJECT : (SaxAction) json_sax_grammar[state][token]);
+
+        // Commas and colons are left for the writer to put back, along with its own whitespace.
+        bool copying = (output != NULL && action != JSON_SAX_REJECT && token != JSON_TOKEN_COMMA && token != JSON_TOKEN_COLON);
+
+        if(copying) {
+            error = json_writer_startToken(output, token, (action == JSON_SAX_KEY));
+
+            if(error != JSON_SUCCESS) {
+                validator.errorOffset = start;
+                break;
+            }
+
+            validator.copying = true;
+            validator.copyFrom = buffer->index;
+        }
+
+        // A token out of place is still read first, so that any error within it is the one reported, as when tokenizing.
+        error = json_validator_readToken(&validator, token);
+
+        if(copying) {
+            if(error == JSON_SUCCESS) {
+                error = json_validator_copy(&validator);
+
+                if(error != JSON_SUCCESS) {
+                    validator.errorOffset = start;
+                }
+            }
+
+            validator.copying = false;
+        }
+
+        if(error != JSON_SUCCESS)
+            break;
+
+        switch(action) {
+            case JSON_SAX_REJECT:
+                error = json_validator_fail(&validator, JSON_ERROR_UNEXPECTED_TOKEN, start);
+                break;
+            case JSON_SAX_START_OBJECT:
+            case JSON_SAX_START_ARRAY:
+                if(depth == JSON_VALIDATE_MAX_DEPTH) {
+                    error = json_validator_fail(&validator, JSON_ERROR_MAX_DEPTH, start);
+                    break;
+                }
+
+                if(token == JSON_TOKEN_OBJECT_START) {
+                    stack[++depth] = JSON_SAX_EXPECT_COMMA_OR_OBJECT_END;
+                    state = JSON_SAX_EXPECT_KEY_OR_OBJECT_END;
+                } else {
+                    stack[++depth] = JSON_SAX_EXPECT_COMMA_OR_ARRAY_END;
+                    state = JSON_SAX_EXPECT_VALUE_OR_ARRAY_END;
+                }
+                break;
+            case JSON_SAX_END_OBJECT:
+            case JSON_SAX_END_ARRAY:
+                state = (SaxState) stack[--depth];
+                break;
+            case JSON_SAX_KEY:
+                state = JSON_SAX_EXPECT_COLON;
+                break;
+            case JSON_SAX_COLON:
+            case JSON_SAX_NEXT_ELEMENT:
+                state = JSON_SAX_EXPECT_VALUE;
+                break;
+            case JSON_SAX_NEXT_MEMBER:
+                state = JSON_SAX_EXPECT_KEY;
+                break;
+            default:
+                // Every other action is a value that is not an object or array.
+                state = (SaxState) stack[depth];
+                break;
+        }
+
+        if(error != JSON_SUCCESS)
+            break;
+    }
+
+    if(error != JSON_SUCCESS && errorOffset != NULL) {
+        *errorOffset = validator.errorOffset;
+    }
+
+    return error;
+}
+
+/*
+ * Checks that the rest of the input in the buffer is a single JSON value surrounded by optional whitespace,
+ * without copying or converting any of it and without allocating memory.
+ *
+ * Strings must be valid UTF-8, failing with JSON_ERROR_INVALID_UTF8 for overlong encodings, surrogates and
+ * truncated sequences. Objects and arrays may be nested up to 1024 deep, failing with JSON_ERROR_MAX_DEPTH
+ * beyond that. Otherwise the errors are the same as when the input is tokenized, with JSON_ERROR_UNEXPECTED_TOKEN
+ * for tokens out of place. Surrogates escaped with \u are accepted whether or not they form a pair, as the
+ * tokenizer keeps them as they are.
+ *
+ * If the input is invalid and errorOffset is not NULL, it is set to the offset of the error from the buffer index when called.
+ * Push buffers must have been finished, otherwise JSON_ERROR_NEED_MORE is returned once the input runs out.
+ */
+JsonError json_validate(JsonBuffer * buffer, size_t * errorOffset) {
+    return json_validator_run(buffer, NULL, errorOffset);
+}
+
+/*
+ * Checks the rest of the input in the buffer in the same way as json_validate, writing each token to the writer
+ * as it goes so that the writer's options decide the whitespace between them.
+ *
+ * Strings and numbers are copied exactly as they appear in the input, so they keep their escapes and the
+ * JSON_WRITER_ASCII option has no effect on them. Nothing is built up in memory along the way, so any amount
+ * of input can be reformatted from a file buffer to a file writer. If the input is invalid, what was written
+ * up to the error is left in the writer.
+ */
+JsonError json_reformat(JsonBuffer * buffer, JsonWriter * writer, size_t * errorOffset) {
+    return json_validator_run(buffer, writer, errorOffset);
+}
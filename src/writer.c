@@ -0,0 +1,635 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "writer_internal.h"
+#include "simd_internal.h"
+#include "numbers_internal.h"
+
+/*
+ * The size of the blocks that file writers write their output in.
+ */
+#define JSON_WRITER_BLOCK_SIZE (1 << 16)
+
+/*
+ * The starting size of the buffer of writers that keep their output in memory.
+ */
+#define JSON_WRITER_INITIAL_SIZE 256
+
+/*
+ * The number of spaces each level of nesting is indented by in pretty output.
+ */
+#define JSON_WRITER_INDENT 4
+
+/*
+ * The starting number of levels of nesting the stack has room for.
+ */
+#define JSON_WRITER_INITIAL_DEPTH 16
+
+/*
+ * Holds the output until it is flushed or taken, and the position in the grammar so that only valid JSON is written.
+ */
+struct JsonWriter {
+    char * buffer;
+    size_t size;
+    size_t length;
+
+    // The number of characters flushed from the buffer so far.
+    size_t flushed;
+
+    // The file descriptor the output is flushed to, or -1 if the output is kept in memory.
+    int file;
+
+    int options;
+
+    // The state to return to after a value at each depth, where the top level is depth 0.
+    unsigned char * stack;
+    int depth;
+    int capacity;
+
+    SaxState state;
+};
+
+/*
+ * Create a writer with the options passed, ready for a single value.
+ */
+static JsonWriter * json_writer_createWithSize(int file, size_t size, int options, JsonError * error) {
+    JsonWriter * writer = (JsonWriter *) malloc(sizeof(JsonWriter));
+
+    if(writer == NULL) {
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    writer->buffer = (char *) malloc(size);
+    writer->stack = (unsigned char *) malloc(JSON_WRITER_INITIAL_DEPTH);
+
+    if(writer->buffer == NULL || writer->stack == NULL) {
+        free(writer->buffer);
+        free(writer->stack);
+        free(writer);
+
+        *error = JSON_ERROR_MALLOC;
+        return NULL;
+    }
+
+    writer->size = size;
+    writer->length = 0;
+    writer->flushed = 0;
+
+    writer->file = file;
+    writer->options = options;
+
+    writer->stack[0] = JSON_SAX_DONE;
+    writer->depth = 0;
+    writer->capacity = JSON_WRITER_INITIAL_DEPTH;
+
+    writer->state = JSON_SAX_EXPECT_VALUE;
+
+    *error = JSON_SUCCESS;
+
+    return writer;
+}
+
+/*
+ * Create a writer that keeps its output in a buffer that grows as needed.
+ *
+ * The options are a combination of JsonWriterOptions.
+ */
+JsonWriter * json_writer_create(int options, JsonError * error) {
+    return json_writer_createWithSize(-1, JSON_WRITER_INITIAL_SIZE, options, error);
+}
+
+/*
+ * Create a writer that writes its output to the open file descriptor in large blocks.
+ *
+ * The file descriptor is not closed when the writer is destroyed.
+ */
+JsonWriter * json_writer_createFile(int file, int options, JsonError * error) {
+    return json_writer_createWithSize(file, JSON_WRITER_BLOCK_SIZE, options, error);
+}
+
+/*
+ * Writes out everything buffered by a file writer. Does nothing for writers that keep their output in memory.
+ */
+JsonError json_writer_flush(JsonWriter * writer) {
+    if(writer->file == -1) {
+        return JSON_SUCCESS;
+    }
+
+    size_t written = 0;
+
+    while(written < writer->length) {
+        ssize_t count = write(writer->file, &writer->buffer[written], writer->length - written);
+
+        if(count == -1) {
+            if(errno == EINTR)
+                continue;
+
+            // Keep what has not been written, so that flushing can be tried again.
+            memmove(writer->buffer, &writer->buffer[written], writer->length - written);
+            writer->length -= written;
+
+            return JSON_ERROR_WRITE_FILE;
+        }
+
+        written += (size_t) count;
+        writer->flushed += (size_t) count;
+    }
+
+    writer->length = 0;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Flushes a file writer, then frees the writer.
+ */
+JsonError json_writer_destroy(JsonWriter * writer) {
+    JsonError error = json_writer_flush(writer);
+
+    free(writer->buffer);
+    free(writer->stack);
+    free(writer);
+
+    return error;
+}
+
+/*
+ * Gets the output of a writer that keeps its output in memory, which is not null terminated.
+ *
+ * The output remains valid until something more is written or the writer is destroyed.
+ */
+const char * json_writer_getOutput(JsonWriter * writer, size_t * length) {
+    *length = writer->length;
+
+    return writer->buffer;
+}
+
+/*
+ * Ensures there is room for count more characters in the buffer, flushing or growing it as needed.
+ */
+static JsonError json_writer_reserve(JsonWriter * writer, size_t count) {
+    if(writer->length + count <= writer->size) {
+        return JSON_SUCCESS;
+    }
+
+    if(writer->file != -1) {
+        JsonError error = json_writer_flush(writer);
+
+        if(error != JSON_SUCCESS || count <= writer->size)
+            return error;
+    }
+
+    size_t size = writer->size;
+
+    while(size < writer->length + count) {
+        size *= 2;
+    }
+
+    char * resized = realloc(writer->buffer, size);
+
+    if(resized == NULL) {
+        return JSON_ERROR_REALLOC;
+    }
+
+    writer->buffer = resized;
+    writer->size = size;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Appends characters that do not fit in the space left in the buffer.
+ *
+ * Long runs for file writers are written straight out rather than being copied through the buffer.
+ */
+static JsonError json_writer_appendOverflow(JsonWriter * writer, const char * data, size_t length) {
+    if(writer->file != -1 && length >= writer->size) {
+        JsonError error = json_writer_flush(writer);
+
+        while(error == JSON_SUCCESS && length > 0) {
+            ssize_t count = write(writer->file, data, length);
+
+            if(count == -1) {
+                if(errno != EINTR)
+                    error = JSON_ERROR_WRITE_FILE;
+
+                continue;
+            }
+
+            data += count;
+            length -= (size_t) count;
+
+            writer->flushed += (size_t) count;
+        }
+
+        return error;
+    }
+
+    JsonError error = json_writer_reserve(writer, length);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    memcpy(&writer->buffer[writer->length], data, length);
+    writer->length += length;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Appends characters to the output.
+ */
+JsonError json_writer_append(JsonWriter * writer, const char * data, size_t length) {
+    if(writer->length + length > writer->size) {
+        return json_writer_appendOverflow(writer, data, length);
+    }
+
+    memcpy(&writer->buffer[writer->length], data, length);
+    writer->length += length;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Appends a new line followed by the indentation for the depth.
+ */
+static JsonError json_writer_newLine(JsonWriter * writer, int depth) {
+    size_t indent = (size_t) depth * JSON_WRITER_INDENT;
+
+    JsonError error = json_writer_reserve(writer, indent + 1);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    writer->buffer[writer->length++] = '\n';
+
+    memset(&writer->buffer[writer->length], ' ', indent);
+    writer->length += indent;
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Checks that the token can be written next, then writes the separator and any whitespace that goes before
+ * it and moves on to the state after it. Keys are told apart from strings by key.
+ *
+ * Returns JSON_ERROR_UNEXPECTED_TOKEN without writing anything if the token would make the output invalid.
+ */
+JsonError json_writer_startToken(JsonWriter * writer, TokenType token, bool key) {
+    JsonError error = JSON_SUCCESS;
+
+    SaxState state = writer->state;
+
+    bool closing = (token == JSON_TOKEN_OBJECT_END || token == JSON_TOKEN_ARRAY_END);
+
+    // Colons and commas are written along with the token that follows them.
+    SaxState next = state;
+
+    if(state == JSON_SAX_EXPECT_COLON) {
+        next = JSON_SAX_EXPECT_VALUE;
+    } else if(state == JSON_SAX_EXPECT_COMMA_OR_OBJECT_END && !closing) {
+        next = JSON_SAX_EXPECT_KEY;
+    } else if(state == JSON_SAX_EXPECT_COMMA_OR_ARRAY_END && !closing) {
+        next = JSON_SAX_EXPECT_VALUE;
+    }
+
+    SaxAction action = (SaxAction) json_sax_grammar[next][token];
+
+    if(action == JSON_SAX_REJECT || key != (action == JSON_SAX_KEY)) {
+        return JSON_ERROR_UNEXPECTED_TOKEN;
+    }
+
+    if(action == JSON_SAX_START_OBJECT || action == JSON_SAX_START_ARRAY) {
+        if(writer->depth + 1 == writer->capacity) {
+            unsigned char * resized = realloc(writer->stack, (size_t) writer->capacity * 2);
+
+            if(resized == NULL) {
+                return JSON_ERROR_REALLOC;
+            }
+
+            writer->stack = resized;
+            writer->capacity *= 2;
+        }
+    }
+
+    bool pretty = (writer->options & JSON_WRITER_PRETTY) != 0;
+
+    if(state == JSON_SAX_EXPECT_COLON) {
+        error = json_writer_append(writer, ": ", (pretty ? 2 : 1));
+    } else if(next != state) {
+        error = json_writer_append(writer, ",", 1);
+    }
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    // Each member and element goes on its own line, and empty objects and arrays stay on one line.
+    if(pretty && writer->depth > 0 && state != JSON_SAX_EXPECT_COLON) {
+        if(!closing) {
+            error = json_writer_newLine(writer, writer->depth);
+        } else if(state == JSON_SAX_EXPECT_COMMA_OR_OBJECT_END || state == JSON_SAX_EXPECT_COMMA_OR_ARRAY_END) {
+            error = json_writer_newLine(writer, writer->depth - 1);
+        }
+
+        if(error != JSON_SUCCESS)
+            return error;
+    }
+
+    switch(action) {
+        case JSON_SAX_START_OBJECT:
+            writer->stack[++writer->depth] = JSON_SAX_EXPECT_COMMA_OR_OBJECT_END;
+            writer->state = JSON_SAX_EXPECT_KEY_OR_OBJECT_END;
+            break;
+        case JSON_SAX_START_ARRAY:
+            writer->stack[++writer->depth] = JSON_SAX_EXPECT_COMMA_OR_ARRAY_END;
+            writer->state = JSON_SAX_EXPECT_VALUE_OR_ARRAY_END;
+            break;
+        case JSON_SAX_END_OBJECT:
+        case JSON_SAX_END_ARRAY:
+            writer->state = (SaxState) writer->stack[--writer->depth];
+            break;
+        case JSON_SAX_KEY:
+            writer->state = JSON_SAX_EXPECT_COLON;
+            break;
+        default:
+            // Every other action is a value that is not an object or array.
+            writer->state = (SaxState) writer->stack[writer->depth];
+            break;
+    }
+
+    return JSON_SUCCESS;
+}
+
+/*
+ * Writes a structural character or literal as a whole token.
+ */
+static JsonError json_writer_writeToken(JsonWriter * writer, TokenType token, const char * text, size_t length) {
+    JsonError error = json_writer_startToken(writer, token, false);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    return json_writer_append(writer, text, length);
+}
+
+/*
+ * Starts an object, which must be ended with json_writer_endObject.
+ */
+JsonError json_writer_startObject(JsonWriter * writer) {
+    return json_writer_writeToken(writer, JSON_TOKEN_OBJECT_START, "{", 1);
+}
+
+/*
+ * Ends the object started last.
+ */
+JsonError json_writer_endObject(JsonWriter * writer) {
+    return json_writer_writeToken(writer, JSON_TOKEN_OBJECT_END, "}", 1);
+}
+
+/*
+ * Starts an array, which must be ended with json_writer_endArray.
+ */
+JsonError json_writer_startArray(JsonWriter * writer) {
+    return json_writer_writeToken(writer, JSON_TOKEN_ARRAY_START, "[", 1);
+}
+
+/*
+ * Ends the array started last.
+ */
+JsonError json_writer_endArray(JsonWriter * writer) {
+    return json_writer_writeToken(writer, JSON_TOKEN_ARRAY_END, "]", 1);
+}
+
+/*
+ * Writes true or false.
+ */
+JsonError json_writer_writeBoolean(JsonWriter * writer, bool value) {
+    return (value ? json_writer_writeToken(writer, JSON_TOKEN_TRUE, "true", 4) : json_writer_writeToken(writer, JSON_TOKEN_FALSE, "false", 5));
+}
+
+/*
+ * Writes null.
+ */
+JsonError json_writer_writeNull(JsonWriter * writer) {
+    return json_writer_writeToken(writer, JSON_TOKEN_NULL, "null", 4);
+}
+
+/*
+ * Appends the escape sequence for a codepoint, splitting codepoints above U+FFFF into a pair of surrogates.
+ */
+static JsonError json_writer_appendCodePoint(JsonWriter * writer, int codepoint) {
+    static const char hexDigits[] = "0123456789abcdef";
+
+    if(codepoint > 0xFFFF) {
+        codepoint -= 0x10000;
+
+        JsonError error = json_writer_appendCodePoint(writer, 0xD800 + (codepoint >> 10));
+
+        if(error != JSON_SUCCESS)
+            return error;
+
+        codepoint = 0xDC00 + (codepoint & 0x3FF);
+    }
+
+    char escape[6] = {
+        '\\', 'u',
+        hexDigits[(codepoint >> 12) & 0xF], hexDigits[(codepoint >> 8) & 0xF],
+        hexDigits[(codepoint >> 4) & 0xF], hexDigits[codepoint & 0xF]
+    };
+
+    return json_writer_append(writer, escape, sizeof(escape));
+}
+
+/*
+ * Appends text in quotation marks, escaping the characters that cannot appear in a string as they are.
+ *
+ * Runs of characters that need no escaping are found with SIMD and copied at once. With JSON_WRITER_ASCII
+ * characters outside of ASCII are escaped too, which fails with JSON_ERROR_INVALID_UTF8 if the text is not valid UTF-8.
+ */
+static JsonError json_writer_appendString(JsonWriter * writer, const char * text, size_t length) {
+    bool ascii = (writer->options & JSON_WRITER_ASCII) != 0;
+
+    // Most strings are short and need no escaping, so are copied along with their quotation marks at once.
+    if(length + 2 <= writer->size - writer->length) {
+        size_t run = (ascii ? json_simd_findStringSpecialOrMultibyte(text, length) : json_simd_findStringSpecial(text, length));
+
+        if(run == length) {
+            char * output = &writer->buffer[writer->length];
+
+            output[0] = '"';
+            memcpy(&output[1], text, length);
+            output[length + 1] = '"';
+
+            writer->length += length + 2;
+
+            return JSON_SUCCESS;
+        }
+    }
+
+    JsonError error = json_writer_append(writer, "\"", 1);
+
+    while(error == JSON_SUCCESS && length > 0) {
+        size_t run = (ascii ? json_simd_findStringSpecialOrMultibyte(text, length) : json_simd_findStringSpecial(text, length));
+
+        error = json_writer_append(writer, text, run);
+
+        text += run;
+        length -= run;
+
+        if(error != JSON_SUCCESS || length == 0)
+            continue;
+
+        unsigned char current = (unsigned char) *text;
+
+        int read = 1;
+
+        switch(current) {
+            case '"':
+                error = json_writer_append(writer, "\\\"", 2);
+                break;
+            case '\\':
+                error = json_writer_append(writer, "\\\\", 2);
+                break;
+            case '\b':
+                error = json_writer_append(writer, "\\b", 2);
+                break;
+            case '\f':
+                error = json_writer_append(writer, "\\f", 2);
+                break;
+            case '\n':
+                error = json_writer_append(writer, "\\n", 2);
+                break;
+            case '\r':
+                error = json_writer_append(writer, "\\r", 2);
+                break;
+            case '\t':
+                error = json_writer_append(writer, "\\t", 2);
+                break;
+            default:
+                if(current < 0x80) {
+                    error = json_writer_appendCodePoint(writer, current);
+                } else {
+                    int codepoint;
+                    read = json_char_UTF8ToUCSCodepoint(text, length, &codepoint);
+
+                    if(read == -1) {
+                        return JSON_ERROR_INVALID_UTF8;
+                    }
+
+                    error = json_writer_appendCodePoint(writer, codepoint);
+                }
+                break;
+        }
+
+        text += read;
+        length -= (size_t) read;
+    }
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    return json_writer_append(writer, "\"", 1);
+}
+
+/*
+ * Writes the key of the next member of an object.
+ */
+JsonError json_writer_writeKey(JsonWriter * writer, const char * key, size_t length) {
+    JsonError error = json_writer_startToken(writer, JSON_TOKEN_TEXT, true);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    return json_writer_appendString(writer, key, length);
+}
+
+/*
+ * Writes a string value, escaping the characters that need it.
+ */
+JsonError json_writer_writeString(JsonWriter * writer, const char * value, size_t length) {
+    JsonError error = json_writer_startToken(writer, JSON_TOKEN_TEXT, false);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    return json_writer_appendString(writer, value, length);
+}
+
+/*
+ * Writes an integer.
+ */
+JsonError json_writer_writeInteger(JsonWriter * writer, long int value) {
+    JsonError error = json_writer_startToken(writer, JSON_TOKEN_NUMBER_INTEGER, false);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    char digits[24];
+    int index = sizeof(digits);
+
+    // Work with the negative value, as the most negative value cannot be made positive.
+    long int remaining = (value < 0 ? value : -value);
+
+    do {
+        digits[--index] = (char) ('0' - remaining % 10);
+        remaining /= 10;
+    } while(remaining != 0);
+
+    if(value < 0) {
+        digits[--index] = '-';
+    }
+
+    return json_writer_append(writer, &digits[index], sizeof(digits) - (size_t) index);
+}
+
+/*
+ * Writes the shortest decimal that reads back as the same double, which always has a decimal point or exponent.
+ *
+ * Returns JSON_ERROR_NON_FINITE_NUMBER without writing anything for infinities and NaN, which JSON cannot represent.
+ */
+JsonError json_writer_writeDecimal(JsonWriter * writer, double value) {
+    if(!isfinite(value)) {
+        return JSON_ERROR_NON_FINITE_NUMBER;
+    }
+
+    JsonError error = json_writer_startToken(writer, JSON_TOKEN_NUMBER_DECIMAL, false);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    char formatted[JSON_NUMBER_FORMATTED_SIZE];
+    int length = json_number_formatDouble(value, formatted);
+
+    return json_writer_append(writer, formatted, (size_t) length);
+}
+
+/*
+ * Writes the text of a number as it is, such as a number too large for writeInteger or writeDecimal
+ * that was read with json_tokenizer_getNumberSlice. The text is assumed to be a valid number.
+ */
+JsonError json_writer_writeNumber(JsonWriter * writer, const char * number, size_t length) {
+    JsonError error = json_writer_startToken(writer, JSON_TOKEN_NUMBER_BIG_DECIMAL, false);
+
+    if(error != JSON_SUCCESS)
+        return error;
+
+    return json_writer_append(writer, number, length);
+}
+
+/*
+ * Whether a whole value has been written, with every object and array closed.
+ */
+bool json_writer_isComplete(JsonWriter * writer) {
+    return writer->state == JSON_SAX_DONE;
+}
+
+/*
+ * Gets the total number of characters written, including those already flushed.
+ */
+size_t json_writer_getLength(JsonWriter * writer) {
+    return writer->flushed + writer->length;
+}
@@ -0,0 +1,10 @@
+#ifndef JSON
+#define JSON
+#include "json.h"
+#endif
+
+#include "sax_internal.h"
+
+JsonError json_writer_startToken(JsonWriter * writer, TokenType token, bool key);
+
+JsonError json_writer_append(JsonWriter * writer, const char * data, size_t length);